@@ -31,9 +31,9 @@ EventTimingCode::EventTimingCode(TimingCodes code,
 
 ///@pkg ID3EventTimingFrame.h
 EventTimingFrame::EventTimingFrame(const ushort version,
-                                   const ByteArray& frameBytes) : Frame::Frame(FRAME_EVENT_TIMING_CODES,
-                                                                               version,
-                                                                               frameBytes) {
+                                   const SmallByteArray& frameBytes) : Frame::Frame(FRAME_EVENT_TIMING_CODES,
+                                                                                    version,
+                                                                                    frameBytes) {
 	//If the frame content isn't null, then get the text content
 	if(!isNull)
 		read();
@@ -49,6 +49,9 @@ EventTimingFrame::~EventTimingFrame() {}
 ///@pkg ID3EventTimingFrame.h
 FrameClass EventTimingFrame::type() const noexcept { return FrameClass::CLASS_EVENT_TIMING; }
 
+///@pkg ID3EventTimingFrame.h
+Frame* EventTimingFrame::clone() const { return new EventTimingFrame(*this); }
+
 ///@pkg ID3EventTimingFrame.h
 bool EventTimingFrame::empty() const { return map.empty(); }
 
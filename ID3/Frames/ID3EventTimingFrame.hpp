@@ -137,6 +137,11 @@ namespace ID3 {
 			 */
 			virtual FrameClass type() const noexcept;
 			
+			/**
+			 * @see ID3::Frame::clone()
+			 */
+			virtual Frame* clone() const;
+			
 			/**
 			 * Check if the Frame's content is empty. A EventTimingFrame is empty
 			 * if its event timing map is empty.
@@ -202,7 +207,7 @@ namespace ID3 {
 			 *                        ByteArray&)
 			 */
 			EventTimingFrame(const ushort version,
-			                 const ByteArray& frameBytes);
+			                 const SmallByteArray& frameBytes);
 			
 			/**
 			 * An empty constructor to create a new ETCO frame.
@@ -11,6 +11,7 @@
  **********************************************************************/
 
 #include <sstream>  //For StringStream
+#include <utility>  //For std::move()
 
 #include "ID3Frame.hpp" //For the class definitions
 #include "../ID3Functions.hpp" //For intToByteArray
@@ -19,6 +20,111 @@
 
 using namespace ID3;
 
+//Private namespace
+namespace {
+	/**
+	 * Where each FrameFlag is in the frame header, in the enum's order: the
+	 * flag byte, and the flag's bit in ID3v2.3 and ID3v2.4. A bit of 0 means
+	 * the version doesn't have the flag.
+	 */
+	static const struct {
+		uint8_t byte;
+		uint8_t bitV3;
+		uint8_t bitV4;
+	} FLAG_BITS[] = {
+		{8, Frame::FLAG1_DISCARD_UPON_TAG_ALTER_IF_UNKNOWN_V3, Frame::FLAG1_DISCARD_UPON_TAG_ALTER_IF_UNKNOWN_V4},
+		{8, Frame::FLAG1_DISCARD_UPON_AUDIO_ALTER_V3,          Frame::FLAG1_DISCARD_UPON_AUDIO_ALTER_V4},
+		{8, Frame::FLAG1_READ_ONLY_V3,                         Frame::FLAG1_READ_ONLY_V4},
+		{9, Frame::FLAG2_COMPRESSED_V3,                        Frame::FLAG2_COMPRESSED_V4},
+		{9, Frame::FLAG2_ENCRYPTED_V3,                         Frame::FLAG2_ENCRYPTED_V4},
+		{9, Frame::FLAG2_GROUPING_IDENTITY_V3,                 Frame::FLAG2_GROUPING_IDENTITY_V4},
+		{9, 0,                                                 Frame::FLAG2_UNSYNCHRONISED_V4},
+		{9, 0,                                                 Frame::FLAG2_DATA_LENGTH_INDICATOR_V4}
+	};
+	
+	/**
+	 * Read a 4-byte big-endian integer from the bytes a flag added to the
+	 * frame header.
+	 * 
+	 * @param bytes     The first byte.
+	 * @param synchsafe If the integer is synchsafe.
+	 * @return The integer.
+	 */
+	inline ulong headerInt(const uint8_t* bytes, const bool synchsafe) {
+		ulong value = 0;
+		for(ushort i = 0; i < 4; i++)
+			value = synchsafe ? (value << 7) | (bytes[i] & 0x7F) : (value << 8) | bytes[i];
+		return value;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+///////////////////////  D E C O D E D F R A M E H E A D E R ///////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+///@pkg ID3Frame.h
+DecodedFrameHeader::DecodedFrameHeader() : flags(0),
+                                           headerSize(HEADER_BYTE_SIZE),
+                                           groupID(0),
+                                           bodySize(0),
+                                           dataLength(0) {}
+
+///@pkg ID3Frame.h
+DecodedFrameHeader DecodedFrameHeader::decode(const ushort version, const SmallByteArray& frameBytes) {
+	DecodedFrameHeader header;
+	if(frameBytes.size() < HEADER_BYTE_SIZE)
+		return header;
+	
+	const bool V3 = version == 3;
+	header.bodySize = headerInt(&frameBytes[4], !V3);
+	for(uint8_t i = 0; i < sizeof(FLAG_BITS) / sizeof(FLAG_BITS[0]); i++) {
+		const uint8_t BIT = V3 ? FLAG_BITS[i].bitV3 : FLAG_BITS[i].bitV4;
+		if(BIT != 0 && (frameBytes[FLAG_BITS[i].byte] & BIT) == BIT)
+			header.flags |= 1 << i;
+	}
+	
+	//Go through the bytes the flags add in the order they're in the header.
+	//Bytes past the end of the frame are counted in the size but not read.
+	const ulong FRAME_SIZE = frameBytes.size();
+	const uint8_t* const BYTES = &frameBytes.front();
+	ulong pos = HEADER_BYTE_SIZE;
+	if(V3) {
+		if(header.flag(FrameFlag::COMPRESSED)) {
+			if(pos + 4 <= FRAME_SIZE) header.dataLength = headerInt(BYTES + pos, false);
+			pos += 4;
+		}
+		if(header.flag(FrameFlag::ENCRYPTED)) pos++;
+		if(header.flag(FrameFlag::GROUPING_IDENTITY)) {
+			if(pos < FRAME_SIZE) header.groupID = BYTES[pos];
+			pos++;
+		}
+	} else {
+		if(header.flag(FrameFlag::GROUPING_IDENTITY)) {
+			if(pos < FRAME_SIZE) header.groupID = BYTES[pos];
+			pos++;
+		}
+		if(header.flag(FrameFlag::ENCRYPTED)) pos++;
+		if(header.flag(FrameFlag::DATA_LENGTH_INDICATOR)) {
+			if(pos + 4 <= FRAME_SIZE) header.dataLength = headerInt(BYTES + pos, true);
+			pos += 4;
+		}
+	}
+	header.headerSize = pos;
+	
+	return header;
+}
+
+///@pkg ID3Frame.h
+void DecodedFrameHeader::encodeFlags(const ushort version, SmallByteArray& frameBytes) const {
+	const bool V3 = version == 3;
+	frameBytes[8] = frameBytes[9] = 0;
+	for(uint8_t i = 0; i < sizeof(FLAG_BITS) / sizeof(FLAG_BITS[0]); i++)
+		if(flag(static_cast<FrameFlag>(i)))
+			frameBytes[FLAG_BITS[i].byte] |= V3 ? FLAG_BITS[i].bitV3 : FLAG_BITS[i].bitV4;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////  F R A M E //////////////////////////////////
@@ -33,15 +139,16 @@ Frame::Frame(const FrameID& frameName) noexcept : id(frameName),
                                                   isFromFile(false) {}
 
 ///@pkg ID3Frame.h
-Frame::Frame(const FrameID&   frameName,
-             const ushort     version,
-             const ByteArray& frameBytes) : id(frameName),
-                                            ID3Ver(version),
-                                            frameContent(frameBytes),
-                                            isNull(frameBytes.size() <= HEADER_BYTE_SIZE),
-                                            isEdited(false),
-                                            isFromFile(true) {
-	if(!isNull && (flag(FrameFlag::COMPRESSED) || flag(FrameFlag::ENCRYPTED)))
+Frame::Frame(const FrameID&        frameName,
+             const ushort          version,
+             const SmallByteArray& frameBytes) : id(frameName),
+                                                 ID3Ver(version),
+                                                 frameContent(frameBytes),
+                                                 frameHeader(DecodedFrameHeader::decode(version, frameBytes)),
+                                                 isNull(frameBytes.size() <= HEADER_BYTE_SIZE),
+                                                 isEdited(false),
+                                                 isFromFile(true) {
+	if(!isNull && (frameHeader.flag(FrameFlag::COMPRESSED) || frameHeader.flag(FrameFlag::ENCRYPTED)))
 		isNull = true;
 	else
 		unsynchronise();
@@ -60,7 +167,7 @@ Frame::operator FrameClass() const noexcept { return type(); }
 bool Frame::operator==(bool boolean) const noexcept { return boolean == isNull; }
 
 ///@pkg ID3Frame.h
-Frame::operator ByteArray() const noexcept { return frameContent; }
+Frame::operator ByteArray() const noexcept { return ByteArray(frameContent); }
 
 ///@pkg ID3Frame.h
 bool Frame::null() const { return isNull; }
@@ -81,7 +188,7 @@ FrameID Frame::frame() const { return id; }
 
 ///@pkg ID3Frame.h
 ByteArray Frame::bytes(bool header) const noexcept {
-	if(!header) return frameContent;
+	if(!header) return ByteArray(frameContent);
 	const ushort HEADER_SIZE = headerSize();
 	if(frameContent.size() < HEADER_SIZE) return ByteArray();
 	return ByteArray(frameContent.begin() + HEADER_SIZE, frameContent.end());
@@ -97,65 +204,16 @@ bool Frame::edited() const { return isEdited; }
 bool Frame::createdFromFile() const { return isFromFile; }
 
 ///@pkg ID3Frame.h
-bool Frame::flag(const FrameFlag flag) const {
-	//Verify that the frame is valid
-	if(frameContent.size() < HEADER_BYTE_SIZE || ID3Ver <= 3)
-		return false;
-	
-	const bool V4 = ID3Ver >= 4;
-	
-	switch(flag) {
-		case FrameFlag::DISCARD_UPON_TAG_ALTER_IF_UNKNOWN:
-			return V4 ?
-			       ((frameContent[8] & FLAG1_DISCARD_UPON_TAG_ALTER_IF_UNKNOWN_V4) == FLAG1_DISCARD_UPON_TAG_ALTER_IF_UNKNOWN_V4) :
-	             ((frameContent[8] & FLAG1_DISCARD_UPON_TAG_ALTER_IF_UNKNOWN_V3) == FLAG1_DISCARD_UPON_TAG_ALTER_IF_UNKNOWN_V3);
-		case FrameFlag::DISCARD_UPON_AUDIO_ALTER:
-			return V4 ?
-			       ((frameContent[8] & FLAG1_DISCARD_UPON_AUDIO_ALTER_V4) == FLAG1_DISCARD_UPON_AUDIO_ALTER_V4) :
-	             ((frameContent[8] & FLAG1_DISCARD_UPON_AUDIO_ALTER_V3) == FLAG1_DISCARD_UPON_AUDIO_ALTER_V3);
-	   case FrameFlag::READ_ONLY:
-			return V4 ?
-			       ((frameContent[8] & FLAG1_READ_ONLY_V4) == FLAG1_READ_ONLY_V4) :
-	             ((frameContent[8] & FLAG1_READ_ONLY_V3) == FLAG1_READ_ONLY_V3);
-	   case FrameFlag::COMPRESSED:
-			return V4 ?
-			       ((frameContent[8] & FLAG2_COMPRESSED_V4) == FLAG2_COMPRESSED_V4) :
-	             ((frameContent[8] & FLAG2_COMPRESSED_V3) == FLAG2_COMPRESSED_V3);
-	   case FrameFlag::ENCRYPTED:
-			return V4 ?
-			       ((frameContent[8] & FLAG2_ENCRYPTED_V4) == FLAG2_ENCRYPTED_V4) :
-	             ((frameContent[8] & FLAG2_ENCRYPTED_V3) == FLAG2_ENCRYPTED_V3);
-	   case FrameFlag::GROUPING_IDENTITY:
-			return V4 ?
-			       ((frameContent[8] & FLAG2_GROUPING_IDENTITY_V4) == FLAG2_GROUPING_IDENTITY_V4) :
-	             ((frameContent[8] & FLAG2_GROUPING_IDENTITY_V3) == FLAG2_GROUPING_IDENTITY_V3);
-	   case FrameFlag::UNSYNCHRONISED:
-			return V4 ? ((frameContent[8] & FLAG2_UNSYNCHRONISED_V4) == FLAG2_UNSYNCHRONISED_V4) : false;
-	   case FrameFlag::DATA_LENGTH_INDICATOR:
-			return V4 ? ((frameContent[8] & FLAG2_DATA_LENGTH_INDICATOR_V4) == FLAG2_DATA_LENGTH_INDICATOR_V4) : false;
-		default:
-			return false;
-	}
-}
+bool Frame::flag(const FrameFlag flag) const { return frameHeader.flag(flag); }
 
 ///@pkg ID3Frame.h
-uint8_t Frame::groupIdentity() const {
-	if(frameContent.size() < headerSize() || !flag(FrameFlag::GROUPING_IDENTITY))
-		return 0;
-	//In ID3v2.3, the group identity is the last flag that adds bytes to the
-	//header, so it's at the very end. In ID3v2.4 it's the first, so get the byte
-	//right after the regular frame header.
-	return ID3Ver <= 3 ? frameContent[headerSize() - 1] : frameContent[HEADER_BYTE_SIZE + 1];
-}
+uint8_t Frame::groupIdentity() const { return frameHeader.groupID; }
 
 ///@pkg ID3Frame.h
-ushort Frame::headerSize() const {
-	return HEADER_BYTE_SIZE +
-	       (flag(FrameFlag::COMPRESSED) ? 4 : 0) +
-	       (flag(FrameFlag::ENCRYPTED) ? 1 : 0) +
-	       (flag(FrameFlag::GROUPING_IDENTITY) ? 1 : 0) +
-	       (flag(FrameFlag::DATA_LENGTH_INDICATOR) ? 4 : 0);
-}
+ushort Frame::headerSize() const { return frameHeader.headerSize; }
+
+///@pkg ID3Frame.h
+const DecodedFrameHeader& Frame::header() const { return frameHeader; }
 
 ///@pkg ID3Frame.h
 std::string Frame::print() const {
@@ -189,7 +247,7 @@ std::string Frame::print() const {
 	if(flag(FrameFlag::DATA_LENGTH_INDICATOR)) out << " -dataLengthIndicator";
 	out << '\n';
 	if(flag(FrameFlag::GROUPING_IDENTITY))
-		out << "Group identity: " << std::boolalpha << groupIdentity() << '\n';
+		out << "Group identity: " << static_cast<short>(groupIdentity()) << '\n';
 	out << "Header size:    " << std::dec << HEADER_SIZE << '\n';
 	out << "Header bytes:  ";
 	for(ulong i = 0; i < HEADER_SIZE && i < FRAME_SIZE; i++)
@@ -213,8 +271,8 @@ std::string Frame::print() const {
 
 ///@pkg ID3Frame.h
 ByteArray Frame::write() {
-	const bool GROUPING_IDENTITY = flag(FrameFlag::GROUPING_IDENTITY);
-	const uint8_t GROUP_IDENTITY = groupIdentity();
+	const bool GROUPING_IDENTITY = frameHeader.flag(FrameFlag::GROUPING_IDENTITY);
+	const uint8_t GROUP_IDENTITY = frameHeader.groupID;
 	
 	//Some frames have the Discard Upon Audio Alter flag set by default
 	bool discardUponAudioAlter;
@@ -246,13 +304,16 @@ ByteArray Frame::write() {
 	//Set the ID3 version to ID3::WRITE_VERSION
 	ID3Ver = WRITE_VERSION;
 	
+	//The new header only keeps the grouping identity
+	frameHeader = DecodedFrameHeader();
+	
 	if(isNull || empty()) {
 		//If null or empty, clear the frame
-		frameContent = ByteArray();
+		frameContent = SmallByteArray();
 	} else {
 		//Recreate the frame content to fit the new header
 		//This automatically clears any flags
-		frameContent = ByteArray(HEADER_SIZE, '\0');
+		frameContent = SmallByteArray(HEADER_SIZE, '\0');
 		
 		//Reserve space for the frame content
 		frameContent.reserve(requiredSize());
@@ -261,15 +322,15 @@ ByteArray Frame::write() {
 		for(ushort i = 0; i < 4 && i < id.size(); i++)
 			frameContent[i] = id[i];
 		
-		//Save the discard upon audio alter flag
-		if(discardUponAudioAlter)
-			frameContent[9] = FLAG1_DISCARD_UPON_AUDIO_ALTER_V4;
-		
-		//Save the grouping identity
+		//Save the discard upon audio alter flag and the grouping identity
+		frameHeader.flag(FrameFlag::DISCARD_UPON_AUDIO_ALTER, discardUponAudioAlter);
 		if(GROUPING_IDENTITY) {
-			frameContent[9] = frameContent[9] | FLAG2_GROUPING_IDENTITY_V4;
+			frameHeader.flag(FrameFlag::GROUPING_IDENTITY, true);
+			frameHeader.headerSize = HEADER_SIZE;
+			frameHeader.groupID = GROUP_IDENTITY;
 			frameContent[HEADER_SIZE - 1] = GROUP_IDENTITY;
 		}
+		frameHeader.encodeFlags(ID3Ver, frameContent);
 		
 		//Call the abstract method to write the body
 		writeBody();
@@ -282,39 +343,43 @@ ByteArray Frame::write() {
 		ByteArray size = intToByteArray(frameContent.size() - HEADER_BYTE_SIZE, 4, true);
 		for(ushort i = 0; i < 4 && i < id.size(); i++)
 			frameContent[i+4] = size[i];
+		frameHeader.bodySize = frameContent.size() - HEADER_BYTE_SIZE;
 	}
 	
 	isEdited = false;
 	
-	return frameContent;
+	return ByteArray(frameContent);
 }
 
 ///@pkg ID3Frame.h
 void Frame::unsynchronise() {
-	if(!flag(FrameFlag::UNSYNCHRONISED))
+	if(!frameHeader.flag(FrameFlag::UNSYNCHRONISED) || frameContent.size() < HEADER_BYTE_SIZE)
 		return;
 	
 	//The current frame size
 	const ulong FRAME_SIZE = frameContent.size();
 	
-	//The new byte vector
-	ByteArray newFrameContent;
+	//The new byte vector, starting with the standard header
+	SmallByteArray newFrameContent(frameContent.begin(), frameContent.begin() + HEADER_BYTE_SIZE);
 	
 	//Reserve space in the new vector to prevent internal array re-allocations
 	newFrameContent.reserve(FRAME_SIZE);
 	
 	//Loop through the frame bytes, starting after the standard header
-	for(ulong i = HEADER_BYTE_SIZE; i + 2 < FRAME_SIZE; i++) {
+	for(ulong i = HEADER_BYTE_SIZE; i < FRAME_SIZE; i++) {
 		newFrameContent.push_back(frameContent[i]);
 		
-		//If the byte pattern 0b11111111 0b00000000 0b111XXXXX is found, then the
-		//0 byte has been inserted to prevent false synchronisations and should
-		//be skipped over.
-		if(frameContent[i] == 0xFF && frameContent[i+1] == '\0' && frameContent[i+2] > 0xE0)
+		//Unsynchronisation inserts a 0 byte after every 0b11111111 byte that's
+		//followed by 0b111XXXXX or 0b00000000, so it should be skipped over.
+		if(frameContent[i] == 0xFF && i + 1 < FRAME_SIZE && frameContent[i+1] == '\0')
 			i++;
 	}
 	
-	frameContent = newFrameContent;
+	frameContent = std::move(newFrameContent);
+	
+	//The frame content is no longer unsynchronised
+	frameHeader.flag(FrameFlag::UNSYNCHRONISED, false);
+	frameHeader.encodeFlags(ID3Ver, frameContent);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -324,11 +389,11 @@ void Frame::unsynchronise() {
 ////////////////////////////////////////////////////////////////////////////////
 
 ///@pkg ID3Frame.h
-UnknownFrame::UnknownFrame(const FrameID&   frameName,
-                           const ushort     version,
-                           const ByteArray& frameBytes) : Frame::Frame(frameName,
-                                                                       version,
-                                                                       frameBytes) {}
+UnknownFrame::UnknownFrame(const FrameID&        frameName,
+                           const ushort          version,
+                           const SmallByteArray& frameBytes) : Frame::Frame(frameName,
+                                                                            version,
+                                                                            frameBytes) {}
 
 ///@pkg ID3Frame.h
 UnknownFrame::UnknownFrame(const FrameID& frameName) noexcept : Frame::Frame(frameName) {}
@@ -353,6 +418,9 @@ FrameClass UnknownFrame::type() const noexcept {
 	return FrameClass::CLASS_UNKNOWN;
 }
 
+///@pkg ID3Frame.h
+Frame* UnknownFrame::clone() const { return new UnknownFrame(*this); }
+
 ///@pkg ID3Frame.h
 bool UnknownFrame::empty() const {
 	return frameContent.size() <= HEADER_BYTE_SIZE;
@@ -376,18 +444,25 @@ ByteArray UnknownFrame::write() {
 	//then clear the frame
 	if(flag(FrameFlag::DISCARD_UPON_TAG_ALTER_IF_UNKNOWN) || isNull || empty() ||
 	   frameContent.size() < HEADER_BYTE_SIZE || frameContent.size() > MAX_TAG_SIZE) {
-		frameContent = ByteArray();
+		frameContent = SmallByteArray();
+		frameHeader = DecodedFrameHeader();
 		isNull = true;
-	} else if(OLD_VERSION <= 3) {
+	} else {
 		//Whether a frame size is synchsafe has been changed from ID3v2.3 to
-		//ID3v2.4, so it must be updated to report the correct frame size
+		//ID3v2.4, and unsynchronisation may have shrunk the frame, so it must be
+		//updated to report the correct frame size
 		//The size must also be valided, as it used to be able to hold 32 bits of
 		//information, now only 28 bits
 		if(frameContent.size() > MAX_TAG_SIZE) throw FrameSizeException(id, id.description());
 		ByteArray frameSize = intToByteArray(frameContent.size() - HEADER_BYTE_SIZE, 4, true);
 		for(short i = 0; i < 4; i++) frameContent[i+4] = frameSize[i];
+		frameHeader.bodySize = frameContent.size() - HEADER_BYTE_SIZE;
+		
+		//The ID3v2.3 flags are in different bits than in ID3v2.4. The frame
+		//isn't compressed or encrypted, so the group byte is in the same place.
+		if(OLD_VERSION == 3) frameHeader.encodeFlags(ID3Ver, frameContent);
 	}
-	return frameContent;
+	return ByteArray(frameContent);
 }
 
 ///@pkg ID3Frame.h
@@ -16,7 +16,8 @@
 #include <vector> //For std::vector
 #include <string> //For std::string
 
-#include "../ID3FrameID.hpp" //For the FrameID class
+#include "../ID3FrameID.hpp"        //For the FrameID class
+#include "../ID3SmallByteArray.hpp" //For the SmallByteArray class
 
 /**
  * The ID3 namespace defines everything related to reading and writing
@@ -103,6 +104,73 @@ namespace ID3 {
 		DATA_LENGTH_INDICATOR
 	};
 	
+	/**
+	 * The frame header decoded from its ID3v2 version's flag layout. It's
+	 * decoded once when the frame is read or written, so that checking a flag
+	 * or getting the header size doesn't read the header bytes again.
+	 * 
+	 * In ID3v2.3 the compressed flag adds the 4-byte decompressed size, then
+	 * the encrypted flag adds the encryption method byte, then the grouping
+	 * identity flag adds the group byte. In ID3v2.4 the grouping identity flag
+	 * adds the group byte, then the encrypted flag adds the encryption method
+	 * byte, then the data length indicator flag adds the 4-byte data length.
+	 * 
+	 * Defined in ID3Frame.cpp.
+	 * 
+	 * @see ID3::Frame::flag(FrameFlag)
+	 */
+	struct DecodedFrameHeader {
+		/**
+		 * An ID3v2 frame header with no flags.
+		 */
+		DecodedFrameHeader();
+		
+		uint8_t flags;      //A bit for each FrameFlag that's set, in the enum's order
+		uint8_t headerSize; //The header size, including the bytes the flags add
+		uint8_t groupID;    //The grouping identity, or 0 if there isn't one
+		ulong bodySize;     //The frame size in the header, which is the size on file without the 10-byte header
+		ulong dataLength;   //The decompressed size in ID3v2.3, or the data length indicator in ID3v2.4, or 0
+		
+		/**
+		 * @param flag The frame flag to check.
+		 * @return If the flag is set.
+		 */
+		inline bool flag(const FrameFlag flag) const { return (flags >> static_cast<uint8_t>(flag)) & 1; }
+		
+		/**
+		 * Set or clear a flag. This doesn't change the header size.
+		 * 
+		 * @param flag  The frame flag.
+		 * @param value If the flag is set.
+		 */
+		inline void flag(const FrameFlag flag, const bool value) {
+			const uint8_t BIT = 1 << static_cast<uint8_t>(flag);
+			flags = value ? (flags | BIT) : (flags & ~BIT);
+		}
+		
+		/**
+		 * Decode the header of a frame. ID3v2.2 frames have their headers
+		 * rebuilt as ID3v2.4 headers by ID3::FrameFactory, so every version
+		 * but ID3v2.3 is decoded as ID3v2.4.
+		 * 
+		 * @param version    The ID3v2 major version.
+		 * @param frameBytes The frame, including the frame header.
+		 * @return The decoded header, which has no flags if frameBytes is
+		 *         shorter than HEADER_BYTE_SIZE.
+		 */
+		static DecodedFrameHeader decode(const ushort version, const SmallByteArray& frameBytes);
+		
+		/**
+		 * Write the flags to the two flag bytes of a frame header, in a
+		 * version's flag layout. Flags the version doesn't have are dropped.
+		 * 
+		 * @param version    The ID3v2 major version.
+		 * @param frameBytes The frame, which must be at least HEADER_BYTE_SIZE
+		 *                   bytes long.
+		 */
+		void encodeFlags(const ushort version, SmallByteArray& frameBytes) const;
+	};
+	
 	/////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////
 	///////////////////////////////// F R A M E /////////////////////////////////
@@ -244,7 +312,7 @@ namespace ID3 {
 			 * @see ID3::Frame::null()
 			 */
 			bool operator==(bool boolean) const noexcept;
-			 
+			
 			/**
 			 * Get the FrameClass enum value that is associated with its class.
 			 * This method is to be implemented in child classes.
@@ -254,6 +322,13 @@ namespace ID3 {
 			 */
 			virtual FrameClass type() const noexcept = 0;
 			
+			/**
+			 * Copy the Frame, including changes that haven't been written yet.
+			 * 
+			 * @return A new Frame of the same class, which the caller owns.
+			 */
+			virtual Frame* clone() const = 0;
+			
 			/**
 			 * Get the content of the frame as bytes.
 			 * 
@@ -337,6 +412,14 @@ namespace ID3 {
 			 */
 			bool flag(const FrameFlag flag) const;
 			
+			/**
+			 * Get the frame header, decoded from the file or from the last call
+			 * of write().
+			 * 
+			 * @return The decoded frame header.
+			 */
+			const DecodedFrameHeader& header() const;
+			
 			/**
 			 * Get the grouping identity. If the grouping identity flag is not set,
 			 * this will always return 0.
@@ -347,11 +430,11 @@ namespace ID3 {
 			uint8_t groupIdentity() const;
 			
 			/**
-			 * Get the size of the frame header. This will be HEADER_BYTE_SIZE if
-			 * the grouping identity flag is not set, and HEADER_BYTE_SIZE+1
-			 * if it is.
+			 * Get the size of the frame header. This will be HEADER_BYTE_SIZE plus
+			 * the bytes the frame flags add to the header.
 			 * 
 			 * @return The size of the frame header.
+			 * @see ID3::DecodedFrameHeader
 			 */
 			ushort headerSize() const;
 			
@@ -401,7 +484,7 @@ namespace ID3 {
 			 */
 			Frame(const FrameID& frameName,
 			      const ushort version,
-			      const ByteArray& frameBytes);
+			      const SmallByteArray& frameBytes);
 			
 			/**
 			 * An empty constructor to initialize variables. Creating a Frame with
@@ -450,7 +533,8 @@ namespace ID3 {
 			/**
 			 * Unsynchronise frame byte contents. This checks for the
 			 * unsynchronisation frame flag to be set first, so it only supports
-			 * ID3v2.4+ frames.
+			 * ID3v2.4+ frames. The frame header is kept, and the flag is cleared
+			 * afterwards.
 			 * This method is automatically called from Frame(std::string&, ushort,
 			 * ByteArray&), and shouldn't be called elsewhere.
 			 */
@@ -470,11 +554,21 @@ namespace ID3 {
 			ushort ID3Ver;
 			
 			/**
-			 * This ByteArray records the bytes of the frame on file,
+			 * This SmallByteArray records the bytes of the frame on file,
 			 * including the frame header. This value will be updated
-			 * after calling ID3::Frame::write().
+			 * after calling ID3::Frame::write(). Frames of up to
+			 * SmallByteArray::INLINE_CAPACITY bytes don't allocate memory.
 			 */
-			ByteArray frameContent;
+			SmallByteArray frameContent;
+			
+			/**
+			 * The frame header in frameContent, decoded when the frame is read and
+			 * when it's written.
+			 * 
+			 * @see ID3::Frame::flag(FrameFlag)
+			 * @see ID3::Frame::headerSize()
+			 */
+			DecodedFrameHeader frameHeader;
 			
 			/**
 			 * This variable records if the Frame is null.
@@ -538,6 +632,11 @@ namespace ID3 {
 			 */
 			virtual FrameClass type() const noexcept;
 			
+			/**
+			 * @see ID3::Frame::clone()
+			 */
+			virtual Frame* clone() const;
+			
 			/**
 			 * Check if the Frame's content is empty. An UnknownFrame is empty if
 			 * the size of the frame in bytes is <= HEADER_BYTE_SIZE.
@@ -578,7 +677,7 @@ namespace ID3 {
 			 */
 			UnknownFrame(const FrameID& frameName,
 			             const ushort version,
-			             const ByteArray& frameBytes);
+			             const SmallByteArray& frameBytes);
 			
 			/**
 			 * This constructor creates calls ID3::Frame::Frame() and creates a
@@ -10,7 +10,7 @@
  * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
  **********************************************************************/
 
-#include <algorithm> //For std::all_of
+#include <algorithm> //For std::all_of and std::equal
 
 #include "ID3PictureFrame.hpp" //For the class definitions
 #include "../ID3.hpp"          //For the Picture struct
@@ -27,6 +27,162 @@ Picture::Picture(const ByteArray&   pictureByteArray,
 			                                          description(pictureDescription),
 			                                          data(pictureByteArray) {}
 
+///@pkg ID3PictureFrame.h
+ImageInfo::ImageInfo() : format(ImageFormat::UNKNOWN), width(0), height(0) {}
+
+///@pkg ID3PictureFrame.h
+std::string ImageInfo::mimeType() const {
+	switch(format) {
+		case ImageFormat::JPEG: return "image/jpeg";
+		case ImageFormat::PNG:  return "image/png";
+		case ImageFormat::GIF:  return "image/gif";
+		case ImageFormat::WEBP: return "image/webp";
+		case ImageFormat::BMP:  return "image/bmp";
+		default:                return "";
+	}
+}
+
+//Private namespace
+namespace {
+	/**
+	 * Read a big-endian integer.
+	 * 
+	 * @param bytes The start of the integer.
+	 * @param size  The number of bytes, up to 4.
+	 * @return The integer.
+	 */
+	static ulong readBigEndian(const uint8_t* bytes, const ushort size) {
+		ulong value = 0;
+		for(ushort i = 0; i < size; i++)
+			value = (value << 8) | bytes[i];
+		return value;
+	}
+	
+	/**
+	 * Read a little-endian integer.
+	 * 
+	 * @param bytes The start of the integer.
+	 * @param size  The number of bytes, up to 4.
+	 * @return The integer.
+	 */
+	static ulong readLittleEndian(const uint8_t* bytes, const ushort size) {
+		ulong value = 0;
+		for(ushort i = size; i > 0; i--)
+			value = (value << 8) | bytes[i - 1];
+		return value;
+	}
+	
+	/**
+	 * Find the size of a JPEG image from its start of frame (SOF) segment.
+	 * 
+	 * @param bytes The image data, which starts with the FF D8 start of image
+	 *              marker.
+	 * @param size  The size of the image data.
+	 * @param info  The image information to set the size of.
+	 */
+	static void sniffJPEG(const uint8_t* bytes, const ulong size, ImageInfo& info) {
+		ulong i = 2;
+		while(i + 1 < size) {
+			//Every segment starts with an FF byte, and any number of FF fill bytes
+			if(bytes[i] != 0xFF) return;
+			const uint8_t marker = bytes[i + 1];
+			if(marker == 0xFF) {
+				i++;
+				continue;
+			}
+			i += 2;
+			
+			//The standalone markers don't have a length
+			if(marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) continue;
+			//The start of scan and end of image markers come after the SOF segment
+			if(marker == 0xD9 || marker == 0xDA || i + 2 > size) return;
+			
+			const ulong SEGMENT_SIZE = readBigEndian(bytes + i, 2);
+			if(SEGMENT_SIZE < 2) return;
+			
+			//C4 (DHT), C8 (JPG), and CC (DAC) aren't SOF markers
+			if(marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+				//The length, the sample precision, the height, then the width
+				if(SEGMENT_SIZE < 7 || i + 7 > size) return;
+				info.height = readBigEndian(bytes + i + 3, 2);
+				info.width  = readBigEndian(bytes + i + 5, 2);
+				return;
+			}
+			
+			i += SEGMENT_SIZE;
+		}
+	}
+	
+	/**
+	 * Find the size of a WebP image from its first chunk.
+	 * 
+	 * @param bytes The image data, which starts with "RIFF", the RIFF size,
+	 *              then "WEBP".
+	 * @param size  The size of the image data.
+	 * @param info  The image information to set the size of.
+	 */
+	static void sniffWebP(const uint8_t* bytes, const ulong size, ImageInfo& info) {
+		if(size < 30) return;
+		const uint8_t* chunk = bytes + 12;
+		if(std::equal(chunk, chunk + 4, "VP8 ")) {
+			//Lossy: a 3-byte frame tag, the 9D 01 2A start code, then the 14-bit sizes
+			if(chunk[11] != 0x9D || chunk[12] != 0x01 || chunk[13] != 0x2A) return;
+			info.width  = readLittleEndian(chunk + 14, 2) & 0x3FFF;
+			info.height = readLittleEndian(chunk + 16, 2) & 0x3FFF;
+		} else if(std::equal(chunk, chunk + 4, "VP8L")) {
+			//Lossless: a 2F signature byte, then 14 bits each of the width and height minus 1
+			if(chunk[8] != 0x2F) return;
+			const ulong BITS = readLittleEndian(chunk + 9, 4);
+			info.width  = (BITS & 0x3FFF) + 1;
+			info.height = ((BITS >> 14) & 0x3FFF) + 1;
+		} else if(std::equal(chunk, chunk + 4, "VP8X")) {
+			//Extended: 4 bytes of flags, then 24 bits each of the canvas width and height minus 1
+			info.width  = readLittleEndian(chunk + 12, 3) + 1;
+			info.height = readLittleEndian(chunk + 15, 3) + 1;
+		}
+	}
+}
+
+///@pkg ID3PictureFrame.h
+ImageInfo PictureFrame::imageInfo(const uint8_t* bytes, const ulong size) {
+	static const uint8_t PNG_SIGNATURE[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	
+	ImageInfo info;
+	if(bytes == nullptr) return info;
+	
+	if(size >= 3 && bytes[0] == 0xFF && bytes[1] == 0xD8 && bytes[2] == 0xFF) {
+		info.format = ImageFormat::JPEG;
+		sniffJPEG(bytes, size, info);
+	} else if(size >= 8 && std::equal(bytes, bytes + 8, PNG_SIGNATURE)) {
+		info.format = ImageFormat::PNG;
+		//The IHDR chunk is always first
+		if(size >= 24 && std::equal(bytes + 12, bytes + 16, "IHDR")) {
+			info.width  = readBigEndian(bytes + 16, 4);
+			info.height = readBigEndian(bytes + 20, 4);
+		}
+	} else if(size >= 6 && (std::equal(bytes, bytes + 6, "GIF87a") || std::equal(bytes, bytes + 6, "GIF89a"))) {
+		info.format = ImageFormat::GIF;
+		if(size >= 10) {
+			info.width  = readLittleEndian(bytes + 6, 2);
+			info.height = readLittleEndian(bytes + 8, 2);
+		}
+	} else if(size >= 12 && std::equal(bytes, bytes + 4, "RIFF") && std::equal(bytes + 8, bytes + 12, "WEBP")) {
+		info.format = ImageFormat::WEBP;
+		sniffWebP(bytes, size, info);
+	} else if(size >= 2 && bytes[0] == 'B' && bytes[1] == 'M') {
+		info.format = ImageFormat::BMP;
+		//The BITMAPINFOHEADER and later headers have 32-bit sizes, and the
+		//height is negative for top-down bitmaps
+		if(size >= 26 && readLittleEndian(bytes + 14, 4) >= 40) {
+			const int32_t height = static_cast<int32_t>(readLittleEndian(bytes + 22, 4));
+			info.width  = readLittleEndian(bytes + 18, 4);
+			info.height = height < 0 ? -static_cast<long>(height) : height;
+		}
+	}
+	
+	return info;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////  P I C T U R E F R A M E ///////////////////////////
@@ -35,10 +191,10 @@ Picture::Picture(const ByteArray&   pictureByteArray,
 
 ///@pkg ID3PictureFrame.h
 PictureFrame::PictureFrame(const ushort version,
-                           const ByteArray& frameBytes) : Frame::Frame(FRAME_PICTURE,
-                                                                       version,
-                                                                       frameBytes),
-                                                          APICType(PictureType::OTHER) {
+                           const SmallByteArray& frameBytes) : Frame::Frame(FRAME_PICTURE,
+                                                                            version,
+                                                                            frameBytes),
+                                                               APICType(PictureType::OTHER) {
 	if(!isNull) read(); //If the frame content isn't null, then get the text content
 }
 
@@ -62,11 +218,14 @@ PictureFrame::~PictureFrame() {}
 ///@pkg ID3PictureFrame.h
 FrameClass PictureFrame::type() const noexcept { return FrameClass::CLASS_PICTURE; }
 
+///@pkg ID3PictureFrame.h
+Frame* PictureFrame::clone() const { return new PictureFrame(*this); }
+
 ///@pkg ID3PictureFrame.h
 bool PictureFrame::empty() const { return pictureData.size() == 0; }
 
 ///@pkg ID3PictureFrame.h
-std::string PictureFrame::mimeType() const { return textMIME; }
+const std::string& PictureFrame::mimeType() const { return textMIME; }
 
 ///@pkg ID3PictureFrame.h
 PictureType PictureFrame::pictureType() const { return APICType; }
@@ -78,7 +237,7 @@ void PictureFrame::pictureType(PictureType newType) {
 }
 
 ///@pkg ID3PictureFrame.h
-std::string PictureFrame::description() const { return textDescription; }
+const std::string& PictureFrame::description() const { return textDescription; }
 
 ///@pkg ID3PictureFrame.h
 void PictureFrame::description(const std::string& newDescription) {
@@ -87,7 +246,7 @@ void PictureFrame::description(const std::string& newDescription) {
 }
 
 ///@pkg ID3PictureFrame.h
-ByteArray PictureFrame::picture() const { return pictureData; }
+const ByteArray& PictureFrame::picture() const { return pictureData; }
 
 ///@pkg ID3PictureFrame.h
 void PictureFrame::picture(const ByteArray& newPictureData,
@@ -97,12 +256,24 @@ void PictureFrame::picture(const ByteArray& newPictureData,
 	textMIME = newMIMEType;
 }
 
+///@pkg ID3PictureFrame.h
+ImageInfo PictureFrame::imageInfo() const { return imageInfo(pictureData); }
+
+///@pkg ID3PictureFrame.h
+ulong PictureFrame::pictureSize() const { return pictureData.size(); }
+
+///@pkg ID3PictureFrame.h
+bool PictureFrame::samePicture(const PictureFrame& other) const { return pictureData == other.pictureData; }
+
 ///@pkg ID3PictureFrame.h
 std::string PictureFrame::print() const {
+	const ImageInfo image = imageInfo();
 	return Frame::print() +
 	       "Picture type:   "   + std::to_string((short)APICType) +
 	       "\nMIME type:      " + textMIME +
 	       "\nDescription:    " + textDescription +
+	       "\nImage type:     " + (image.format == ImageFormat::UNKNOWN ? "Unknown" : image.mimeType()) +
+	       "\nImage size:     " + std::to_string(image.width) + "x" + std::to_string(image.height) +
 	       "\nFrame class:    PictureFrame\n";
 }
 
@@ -154,7 +325,8 @@ void PictureFrame::read() {
 				mimeEnd = i;
 				//The MIME string is always stored in LATIN-1
 				textMIME = getUTF8String(ENCODING_LATIN1,
-				                         frameContent,
+				                         frameContent.data(),
+				                         frameContent.size(),
 				                         HEADER_SIZE+1,
 				                         i);
 				break;
@@ -207,7 +379,7 @@ void PictureFrame::read() {
 			if(frameContent[i] == '\0') {
 				if(wideChars && frameContent[i+1] != '\0') continue;
 				descEnd = i;
-				textDescription = getUTF8String(encoding, frameContent, descStart, descEnd);
+				textDescription = getUTF8String(encoding, frameContent.data(), frameContent.size(), descStart, descEnd);
 				break;
 			}
 		}
@@ -63,6 +63,42 @@ namespace ID3 {
 		NULL_PICTURE       = 0xFF //NOTE: This value is not used by PictureFrame
 	};
 	
+	/**
+	 * The image formats that can be found from the start of the picture data.
+	 */
+	enum class ImageFormat : uint8_t {
+		UNKNOWN = 0,
+		JPEG    = 1,
+		PNG     = 2,
+		GIF     = 3,
+		WEBP    = 4,
+		BMP     = 5
+	};
+	
+	/**
+	 * The format and size of an image, found from its header without decoding
+	 * it.
+	 * 
+	 * @see ID3::PictureFrame::imageInfo(const uint8_t*, ulong)
+	 */
+	struct ImageInfo {
+		ImageInfo();
+		ImageFormat format; //The image format, or UNKNOWN
+		ulong width;        //The width in pixels, or 0 if it's not known
+		ulong height;       //The height in pixels, or 0 if it's not known
+		
+		/**
+		 * @return The MIME type of the image format, such as "image/jpeg", or
+		 *         "" if the format is UNKNOWN.
+		 */
+		std::string mimeType() const;
+		
+		/**
+		 * @return The number of pixels.
+		 */
+		inline ulong pixels() const { return width * height; }
+	};
+	
 	/////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////
 	////////////////////////// P I C T U R E F R A M E //////////////////////////
@@ -101,6 +137,11 @@ namespace ID3 {
 			 */
 			virtual FrameClass type() const noexcept;
 			
+			/**
+			 * @see ID3::Frame::clone()
+			 */
+			virtual Frame* clone() const;
+			
 			/**
 			 * Check if the Frame's content is empty. A PictureFrame is empty if
 			 * the picture data is empty.
@@ -115,7 +156,7 @@ namespace ID3 {
 			 * 
 			 * @return The MIME type.
 			 */
-			std::string mimeType() const;
+			const std::string& mimeType() const;
 			
 			/**
 			 * Get the picture type.
@@ -136,7 +177,7 @@ namespace ID3 {
 			 * 
 			 * @return The description.
 			 */
-			std::string description() const;
+			const std::string& description() const;
 			
 			/**
 			 * Set the description. Call write() to finalize changes.
@@ -150,7 +191,7 @@ namespace ID3 {
 			 * 
 			 * @return The picture data as a uint8_t vector.
 			 */
-			ByteArray picture() const;
+			const ByteArray& picture() const;
 			
 			/**
 			 * Update the picture. Call write() to finalize changes.
@@ -179,6 +220,30 @@ namespace ID3 {
 				pictureType(newType);
 			}
 			
+			/**
+			 * Get the format and size of the picture from its header, without
+			 * copying or decoding it.
+			 * 
+			 * @return The image information.
+			 * @see ID3::PictureFrame::imageInfo(const uint8_t*, ulong)
+			 */
+			ImageInfo imageInfo() const;
+			
+			/**
+			 * @return The size of the picture data, without copying it.
+			 */
+			ulong pictureSize() const;
+			
+			/**
+			 * Check if another picture frame holds the same picture data, without
+			 * copying either picture. The MIME types, descriptions, and picture
+			 * types aren't compared.
+			 * 
+			 * @param other The other picture frame.
+			 * @return If the picture data is the same.
+			 */
+			bool samePicture(const PictureFrame& other) const;
+			
 			/**
 			 * Print information about the frame.
 			 * 
@@ -186,6 +251,30 @@ namespace ID3 {
 			 */
 			virtual std::string print() const;
 			
+			/**
+			 * Get the format and size of an image from its header. The format is
+			 * found from the file signature, and the size from the JPEG start of
+			 * frame (SOF) segment, the PNG IHDR chunk, the GIF logical screen,
+			 * the WebP VP8, VP8L, or VP8X chunk, or the BMP info header.
+			 * 
+			 * Only the first few dozen bytes are read, except for JPEG images,
+			 * where the segment headers before the SOF segment are skipped over
+			 * by their lengths without reading the segments.
+			 * 
+			 * NOTE: The image is not checked to be valid past its header.
+			 * 
+			 * @param bytes The image data.
+			 * @param size  The size of the image data.
+			 * @return The image information. If the format isn't recognised, the
+			 *         format is UNKNOWN and the size is 0x0.
+			 */
+			static ImageInfo imageInfo(const uint8_t* bytes, const ulong size);
+			
+			/** @see ID3::PictureFrame::imageInfo(const uint8_t*, ulong) */
+			static inline ImageInfo imageInfo(const ByteArray& bytes) {
+				return bytes.empty() ? ImageInfo() : imageInfo(&bytes.front(), bytes.size());
+			}
+			
 			/**
 			 * Check if a given MIME type is allowed for ID3v2 pictures.
 			 * The only allowed MIME types are "png" or "jpeg" with "image/"
@@ -219,7 +308,7 @@ namespace ID3 {
 			 *                        ByteArray&)
 			 */
 			PictureFrame(const ushort version,
-			             const ByteArray& frameBytes);
+			             const SmallByteArray& frameBytes);
 			
 			/**
 			 * This constructor manually creates a picture frame. A Frame created
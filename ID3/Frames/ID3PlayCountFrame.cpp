@@ -23,10 +23,10 @@ using namespace ID3;
 
 ///@pkg ID3PlayCountFrame.h
 PlayCountFrame::PlayCountFrame(const ushort version,
-                               const ByteArray& frameBytes) : Frame::Frame(FRAME_PLAY_COUNT,
-                                                                           version,
-                                                                           frameBytes),
-                                                              count(0ULL) {
+                               const SmallByteArray& frameBytes) : Frame::Frame(FRAME_PLAY_COUNT,
+                                                                                version,
+                                                                                frameBytes),
+                                                                   count(0ULL) {
 	//If the frame content isn't null, then get the text content
 	if(!isNull)
 		read();
@@ -42,6 +42,9 @@ PlayCountFrame::~PlayCountFrame() {}
 ///@pkg ID3PlayCountFrame.h
 FrameClass PlayCountFrame::type() const noexcept { return FrameClass::CLASS_PLAY_COUNT; }
 
+///@pkg ID3PlayCountFrame.h
+Frame* PlayCountFrame::clone() const { return new PlayCountFrame(*this); }
+
 ///@pkg ID3PlayCountFrame.h
 bool PlayCountFrame::empty() const { return count == 0ULL; }
 
@@ -108,9 +111,9 @@ bool PlayCountFrame::operator==(const Frame* const frame) const noexcept {
 
 ///@pkg ID3PlayCountFrame.h
 PopularimeterFrame::PopularimeterFrame(const ushort version,
-                                       const ByteArray& frameBytes) : Frame::Frame(FRAME_POPULARIMETER,
-                                                                                   version,
-                                                                                   frameBytes) {
+                                       const SmallByteArray& frameBytes) : Frame::Frame(FRAME_POPULARIMETER,
+                                                                                        version,
+                                                                                        frameBytes) {
 	count = 0ULL;
 	
 	//If the frame content isn't null, then get the text content
@@ -135,6 +138,9 @@ PopularimeterFrame::~PopularimeterFrame() {}
 ///@pkg ID3PlayCountFrame.h
 FrameClass PopularimeterFrame::type() const noexcept { return FrameClass::CLASS_POPULARIMETER; }
 
+///@pkg ID3PlayCountFrame.h
+Frame* PopularimeterFrame::clone() const { return new PopularimeterFrame(*this); }
+
 ///@pkg ID3PlayCountFrame.h
 bool PopularimeterFrame::empty() const { return count == 0ULL &&
 	                                             fiveStarRating == 0 &&
@@ -156,7 +162,7 @@ void PopularimeterFrame::rating(const uint8_t newRating) {
 }
 
 ///@pkg ID3PlayCountFrame.h
-std::string PopularimeterFrame::email() const { return emailAddress; }
+const std::string& PopularimeterFrame::email() const { return emailAddress; }
 
 ///@pkg ID3PlayCountFrame.h
 void PopularimeterFrame::email(const std::string& newEmail) {
@@ -216,7 +222,8 @@ void PopularimeterFrame::read() {
 		
 		//Read the email address
 		emailAddress = getUTF8String(ENCODING_LATIN1, //Email addresses are in LATIN-1, no encoding byte
-		                             frameContent,
+		                             frameContent.data(),
+		                             frameContent.size(),
 		                             HEADER_SIZE,
 		                             emailEnd);
 		
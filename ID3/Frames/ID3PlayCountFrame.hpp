@@ -65,6 +65,11 @@ namespace ID3 {
 			 */
 			virtual FrameClass type() const noexcept;
 			
+			/**
+			 * @see ID3::Frame::clone()
+			 */
+			virtual Frame* clone() const;
+			
 			/**
 			 * Check if the Frame's content is empty. A PlayCountFrame is empty
 			 * when its play count is 0.
@@ -108,8 +113,8 @@ namespace ID3 {
 			 *                        ushort,
 			 *                        ByteArray&)
 			 */
-			PlayCountFrame(const ushort     version,
-			               const ByteArray& frameBytes);
+			PlayCountFrame(const ushort          version,
+			               const SmallByteArray& frameBytes);
 			
 			/**
 			 * This constructor manually creates a play count frame. A Frame created
@@ -185,6 +190,11 @@ namespace ID3 {
 			 */
 			virtual FrameClass type() const noexcept;
 			
+			/**
+			 * @see ID3::Frame::clone()
+			 */
+			virtual Frame* clone() const;
+			
 			/**
 			 * Check if the Frame's content is empty. A PopularimeterFrame is empty
 			 * when its play count is 0, its rating is 0, and its email is an empty
@@ -200,7 +210,7 @@ namespace ID3 {
 			 * 
 			 * @return The email address.
 			 */
-			std::string email() const;
+			const std::string& email() const;
 			
 			/**
 			 * Set the email address. Call write() to finalize changes.
@@ -252,8 +262,8 @@ namespace ID3 {
 			 *                        ushort,
 			 *                        ByteArray&)
 			 */
-			PopularimeterFrame(const ushort     version,
-			                   const ByteArray& frameBytes);
+			PopularimeterFrame(const ushort          version,
+			                   const SmallByteArray& frameBytes);
 			
 			/**
 			 * This constructor manually creates a Popularimeter frame. A Frame
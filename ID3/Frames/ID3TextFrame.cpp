@@ -12,7 +12,7 @@
 
 #include "ID3TextFrame.hpp"    //For the class definitions
 #include "../ID3.hpp"          //For the Text struct
-#include "../ID3Functions.hpp" //For getUTF8String() and numericalString()
+#include "../ID3Functions.hpp" //For getUTF8String(), getEncodedString(), and numericalString()
 #include "../ID3Constants.hpp" //For MAX_TAG_SIZE
 
 using namespace ID3;
@@ -31,22 +31,25 @@ Text::Text(const std::string& textContent,
 ////////////////////////////////////////////////////////////////////////////////
 
 ///@pkg ID3TextFrame.h
-TextFrame::TextFrame(const FrameID&   frameName,
-                     const ushort     version,
-                     const ByteArray& frameBytes) : Frame::Frame(frameName,
-                                                                 version,
-                                                                 frameBytes) {
+TextFrame::TextFrame(const FrameID&        frameName,
+                     const ushort          version,
+                     const SmallByteArray& frameBytes) : Frame::Frame(frameName,
+                                                                      version,
+                                                                      frameBytes),
+                                                          optionSmallestEncoding(false) {
 	if(!isNull) read(); //If the frame content is not null, then get the text content
 }
 
 ///@pkg ID3TextFrame.h
 TextFrame::TextFrame(const FrameID&     frameName,
                      const std::string& value) noexcept : Frame::Frame(frameName),
-                                                          textContent(value) {}
+                                                          textContent(value),
+                                                          optionSmallestEncoding(false) {}
 
 ///@pkg ID3TextFrame.h
 TextFrame::TextFrame(const FrameID&                  frameName,
-                     const std::vector<std::string>& values) : Frame::Frame(frameName) {
+                     const std::vector<std::string>& values) : Frame::Frame(frameName),
+                                                               optionSmallestEncoding(false) {
 	contents(values);
 	isEdited = false; //Undo isEdited
 }
@@ -57,6 +60,9 @@ TextFrame::~TextFrame() {}
 ///@pkg ID3TextFrame.h
 FrameClass TextFrame::type() const noexcept { return FrameClass::CLASS_TEXT; }
 
+///@pkg ID3TextFrame.h
+Frame* TextFrame::clone() const { return new TextFrame(*this); }
+
 ///@pkg ID3TextFrame.h
 bool TextFrame::empty() const { return textContent.empty(); }
 
@@ -94,8 +100,23 @@ ByteArray TextFrame::write() {
 	return Frame::write();
 }
 
+///@pkg ID3TextFrame.h
+bool TextFrame::smallestEncoding() const { return optionSmallestEncoding; }
+
+///@pkg ID3TextFrame.h
+void TextFrame::smallestEncoding(const bool smallest) { optionSmallestEncoding = smallest; }
+
 ///@pkg ID3TextFrame.h
 void TextFrame::writeBody() {
+	if(optionSmallestEncoding) {
+		//Multiple strings aren't written in UTF-16, since each one would need a BOM
+		const uint8_t encoding = ID3::smallestEncoding(textContent, textContent.find('\0') == std::string::npos);
+		const ByteArray text = getEncodedString(encoding, textContent);
+		frameContent.push_back(encoding);
+		frameContent.insert(frameContent.end(), text.begin(), text.end());
+		return;
+	}
+	
 	//Check if the text content is pure ASCII or if it has to be encoded in UTF-8
 	bool isASCII = true;
 	for(const char currentChar : textContent) {
@@ -118,7 +139,8 @@ void TextFrame::read() {
 	//Make sure that there is enough room for text before reading the frame bytes
 	if(frameContent.size() > HEADER_SIZE) {
 		textContent = getUTF8String(frameContent[HEADER_SIZE], //Get the encoding byte
-		                            frameContent,
+		                            frameContent.data(),
+		                            frameContent.size(),
 		                            HEADER_SIZE+1);
 	} else {
 		isNull = true;
@@ -127,7 +149,7 @@ void TextFrame::read() {
 }
 
 ///@pkg ID3TextFrame.h
-std::string TextFrame::content() const { return textContent; }
+const std::string& TextFrame::content() const { return textContent; }
 
 ///@pkg ID3TextFrame.h
 void TextFrame::content(const std::string& newContent) {
@@ -225,11 +247,11 @@ TextFrame& TextFrame::operator+=(const std::string& str) noexcept {
 ////////////////////////////////////////////////////////////////////////////////
 
 ///@pkg ID3TextFrame.h
-NumericalTextFrame::NumericalTextFrame(const FrameID&   frameName,
-                                       const ushort     version,
-                                       const ByteArray& frameBytes) : Frame::Frame(frameName,
-                                                                                   version,
-                                                                                   frameBytes) {
+NumericalTextFrame::NumericalTextFrame(const FrameID&        frameName,
+                                       const ushort          version,
+                                       const SmallByteArray& frameBytes) : Frame::Frame(frameName,
+                                                                                        version,
+                                                                                        frameBytes) {
 	if(!isNull) read(); //If the frame content is not null
 }
 
@@ -263,6 +285,9 @@ NumericalTextFrame::~NumericalTextFrame() {}
 ///@pkg ID3TextFrame.h
 FrameClass NumericalTextFrame::type() const noexcept { return FrameClass::CLASS_NUMERICAL; }
 
+///@pkg ID3TextFrame.h
+Frame* NumericalTextFrame::clone() const { return new NumericalTextFrame(*this); }
+
 ///@pkg ID3TextFrame.h
 void NumericalTextFrame::content(const std::string& newContent) {
 	TextFrame::content(numericalString(newContent) ? newContent : "");
@@ -361,7 +386,7 @@ NumericalTextFrame& NumericalTextFrame::operator+=(const std::string& str) noexc
 ///@pkg ID3TextFrame.h
 DescriptiveTextFrame::DescriptiveTextFrame(const FrameID& frameName,
                                            const ushort version,
-                                           const ByteArray& frameBytes,
+                                           const SmallByteArray& frameBytes,
                                            const ushort options) : Frame::Frame(frameName, version, frameBytes),
                                                                    optionLanguage((options & OPTION_LANGUAGE) == OPTION_LANGUAGE),
                                                                    optionLatin1((options & OPTION_LATIN1_TEXT)==OPTION_LATIN1_TEXT),
@@ -399,6 +424,9 @@ DescriptiveTextFrame::~DescriptiveTextFrame() {}
 ///@pkg ID3TextFrame.h
 FrameClass DescriptiveTextFrame::type() const noexcept { return FrameClass::CLASS_DESCRIPTIVE; }
 
+///@pkg ID3TextFrame.h
+Frame* DescriptiveTextFrame::clone() const { return new DescriptiveTextFrame(*this); }
+
 ///@pkg ID3TextFrame.h
 std::string DescriptiveTextFrame::print() const {
 	return Frame::print() +
@@ -424,8 +452,16 @@ void DescriptiveTextFrame::writeBody() {
 			                                         2 - textContent.size());
 	}
 	
-	//Set the encoding to UTF-8
-	frameContent.push_back(FrameEncoding::ENCODING_UTF8);
+	//Set the encoding to UTF-8, or the encoding that takes the fewest bytes for
+	//the description and the text content (unless it's always LATIN-1)
+	uint8_t encoding = FrameEncoding::ENCODING_UTF8;
+	if(optionSmallestEncoding) {
+		const std::string description = optionNoDescription ? "" : textDescription;
+		encoding = ID3::smallestEncoding(optionLatin1        ? description :
+		                                 optionNoDescription ? textContent :
+		                                 description + '\0' + textContent);
+	}
+	frameContent.push_back(encoding);
 	
 	//Write the language to file
 	if(optionLanguage) {
@@ -435,12 +471,19 @@ void DescriptiveTextFrame::writeBody() {
 		
 	//Write the description and its null separator to file.
 	if(!optionNoDescription) {
-		frameContent.insert(frameContent.end(), textDescription.begin(), textDescription.end());
+		const ByteArray description = getEncodedString(encoding, textDescription);
+		frameContent.insert(frameContent.end(), description.begin(), description.end());
 		frameContent.push_back('\0');
+		if(encoding == FrameEncoding::ENCODING_UTF16BOM) frameContent.push_back('\0');
 	}
 	
 	//Write the text content to file
-	frameContent.insert(frameContent.end(), textContent.begin(), textContent.end());
+	if(optionLatin1) {
+		frameContent.insert(frameContent.end(), textContent.begin(), textContent.end());
+	} else {
+		const ByteArray content = getEncodedString(encoding, textContent);
+		frameContent.insert(frameContent.end(), content.begin(), content.end());
+	}
 }
 
 ///@pkg ID3TextFrame.h
@@ -462,7 +505,7 @@ void DescriptiveTextFrame::content(const std::string& newContent,
 }
 
 ///@pkg ID3TextFrame.h
-std::string DescriptiveTextFrame::description() const { return textDescription; }
+const std::string& DescriptiveTextFrame::description() const { return textDescription; }
 
 ///@pkg ID3TextFrame.h
 void DescriptiveTextFrame::description(const std::string& newDescription) {
@@ -473,7 +516,7 @@ void DescriptiveTextFrame::description(const std::string& newDescription) {
 }
 
 ///@pkg ID3TextFrame.h
-std::string DescriptiveTextFrame::language() const { return textLanguage; }
+const std::string& DescriptiveTextFrame::language() const { return textLanguage; }
 
 ///@pkg ID3TextFrame.h
 void DescriptiveTextFrame::language(const std::string& newLanguage) {
@@ -530,13 +573,15 @@ void DescriptiveTextFrame::read() {
 			textDescription = "";
 		} else { //Save the description
 			textDescription = getUTF8String(encoding,
-		                                   frameContent,
+		                                   frameContent.data(),
+		                                   frameContent.size(),
 		                                   descriptionStart,
 		                                   descriptionEnd);
 		}
 		//Save the text content, taking care of the LATIN1_TEXT option
 		textContent = getUTF8String(optionLatin1 ? ENCODING_LATIN1 : encoding,
-		                            frameContent,
+		                            frameContent.data(),
+		                            frameContent.size(),
 		                            descriptionEnd + descriptionGap);
 	}
 }
@@ -563,11 +608,11 @@ bool DescriptiveTextFrame::operator==(const Frame* const frame) const noexcept {
 ////////////////////////////////////////////////////////////////////////////////
 
 ///@pkg ID3TextFrame.h
-URLTextFrame::URLTextFrame(const FrameID&   frameName,
-                           const ushort     version,
-                           const ByteArray& frameBytes) : Frame::Frame(frameName,
-                                                                       version,
-                                                                       frameBytes) {
+URLTextFrame::URLTextFrame(const FrameID&        frameName,
+                           const ushort          version,
+                           const SmallByteArray& frameBytes) : Frame::Frame(frameName,
+                                                                            version,
+                                                                            frameBytes) {
 	if(!isNull) read(); //If the frame content is not null
 }
 
@@ -589,6 +634,9 @@ FrameClass URLTextFrame::type() const noexcept {
 	return FrameClass::CLASS_URL;
 }
 
+///@pkg ID3TextFrame.h
+Frame* URLTextFrame::clone() const { return new URLTextFrame(*this); }
+
 ///@pkg ID3TextFrame.h
 std::string URLTextFrame::print() const {
 	return Frame::print() +
@@ -612,7 +660,8 @@ void URLTextFrame::read() {
 	//Make sure that there is enough room for text before reading the frame bytes
 	if(frameContent.size() - 1 > HEADER_SIZE)
 		textContent = getUTF8String(ENCODING_LATIN1, //URL frames are in LATIN-1, no encoding byte
-		                            frameContent,
+		                            frameContent.data(),
+		                            frameContent.size(),
 		                            HEADER_SIZE);
 	else
 		textContent = "";
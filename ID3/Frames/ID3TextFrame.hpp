@@ -88,6 +88,11 @@ namespace ID3 {
 			 */
 			virtual FrameClass type() const noexcept;
 			
+			/**
+			 * @see ID3::Frame::clone()
+			 */
+			virtual Frame* clone() const;
+			
 			/**
 			 * Check if the Frame's content is empty. A TextFrame is empty if
 			 * the frame content is an empty string.
@@ -102,7 +107,7 @@ namespace ID3 {
 			 * 
 			 * @returns The text content of the frame in UTF-8 encoding.
 			 */
-			std::string content() const;
+			const std::string& content() const;
 			
 			/**
 			 * Set the text content. Call write() to finalize changes.
@@ -136,6 +141,27 @@ namespace ID3 {
 			 */
 			char stringSeparator() const;
 			
+			/**
+			 * Check if the text will be written in the encoding that takes the
+			 * fewest bytes.
+			 * 
+			 * @return If the smallest encoding will be used.
+			 * @see ID3::TextFrame::smallestEncoding(bool)
+			 */
+			bool smallestEncoding() const;
+			
+			/**
+			 * Set if the text should be written in the encoding that takes the
+			 * fewest bytes, out of LATIN-1, UTF-8, and UTF-16 with a BOM, instead
+			 * of LATIN-1 for ASCII text and UTF-8 for the rest.
+			 * 
+			 * NOTE: Text with more than one string is never written in UTF-16.
+			 * 
+			 * @param smallest If the smallest encoding should be used.
+			 * @see ID3::smallestEncoding(std::string&, bool)
+			 */
+			void smallestEncoding(const bool smallest);
+			
 			/**
 			 * Print information about the frame.
 			 * 
@@ -167,9 +193,9 @@ namespace ID3 {
 			 * 
 			 * @see ID3::Frame::Frame(FrameID&, ushort, ByteArray&)
 			 */
-			TextFrame(const FrameID&     frameName,
-			          const ushort       version,
-			          const ByteArray&   frameBytes);
+			TextFrame(const FrameID&          frameName,
+			          const ushort            version,
+			          const SmallByteArray&   frameBytes);
 			
 			/**
 			 * This constructor manually creates a text frame with
@@ -200,6 +226,13 @@ namespace ID3 {
 			 */
 			std::string textContent;
 			
+			/**
+			 * If the text should be written in the smallest encoding.
+			 * 
+			 * @see ID3::TextFrame::smallestEncoding(bool)
+			 */
+			bool optionSmallestEncoding;
+			
 			/**
 			 * The read() method for TextFrame first gets the text encoding of the
 			 * frame at the 11th byte, and saves every following byte in the
@@ -213,7 +246,9 @@ namespace ID3 {
 			/**
 			 * The writeBody() method for TextFrame the frame text to the frame
 			 * content, with LATIN-1 as the encoding if the text is in ASCII or
-			 * UTF-8 if characters fall outside of the ASCII range.
+			 * UTF-8 if characters fall outside of the ASCII range. If the smallest
+			 * encoding option is set, the encoding that takes the fewest bytes is
+			 * used instead.
 			 * 
 			 * @see ID3::Frame::writeBody()
 			 */
@@ -302,6 +337,11 @@ namespace ID3 {
 			 */
 			virtual FrameClass type() const noexcept;
 			
+			/**
+			 * @see ID3::Frame::clone()
+			 */
+			virtual Frame* clone() const;
+			
 			/**
 			 * Set the numerical content. Call write() to finalize changes.
 			 * 
@@ -365,9 +405,9 @@ namespace ID3 {
 			 * 
 			 * @see ID3::Frame::Frame(FrameID&, ushort, ByteArray&)
 			 */
-			NumericalTextFrame(const FrameID&   frameName,
-			                   const ushort     version,
-			                   const ByteArray& frameBytes);
+			NumericalTextFrame(const FrameID&        frameName,
+			                   const ushort          version,
+			                   const SmallByteArray& frameBytes);
 			
 			/**
 			 * This constructor manually creates a text frame with
@@ -498,6 +538,11 @@ namespace ID3 {
 			 */
 			virtual FrameClass type() const noexcept;
 			
+			/**
+			 * @see ID3::Frame::clone()
+			 */
+			virtual Frame* clone() const;
+			
 			/**
 			 * Set the text content. Call write() to finalize changes.
 			 * 
@@ -535,7 +580,7 @@ namespace ID3 {
 			 * 
 			 * @return The description of the frame in UTF-8 encoding.
 			 */
-			std::string description() const;
+			const std::string& description() const;
 			
 			/**
 			 * Set the description. Call write() to finalize changes.
@@ -553,7 +598,7 @@ namespace ID3 {
 			 * 
 			 * @returns The language of the frame in UTF-8 encoding.
 			 */
-			std::string language() const;
+			const std::string& language() const;
 			
 			/**
 			 * Set the language. Call write() to finalize changes.
@@ -593,10 +638,10 @@ namespace ID3 {
 			 *                ID3::DescriptiveTextFrame::OPTION_LATIN1_TEXT (optional).
 			 * @see ID3::Frame::Frame(FrameID&, ushort, ByteArray&)
 			 */
-			DescriptiveTextFrame(const FrameID&   frameName,
-			                     const ushort     version,
-			                     const ByteArray& frameBytes,
-			                     const ushort     options=0);
+			DescriptiveTextFrame(const FrameID&        frameName,
+			                     const ushort          version,
+			                     const SmallByteArray& frameBytes,
+			                     const ushort          options=0);
 			
 			/**
 			 * This constructor manually creates a text frame with
@@ -762,6 +807,11 @@ namespace ID3 {
 			 */
 			virtual FrameClass type() const noexcept;
 			
+			/**
+			 * @see ID3::Frame::clone()
+			 */
+			virtual Frame* clone() const;
+			
 			/**
 			 * Print information about the frame.
 			 * 
@@ -783,9 +833,9 @@ namespace ID3 {
 			 * 
 			 * @see ID3::Frame::Frame(FrameID&, ushort, ByteArray&)
 			 */
-			URLTextFrame(const FrameID&   frameName,
-			             const ushort     version,
-			             const ByteArray& frameBytes);
+			URLTextFrame(const FrameID&        frameName,
+			             const ushort          version,
+			             const SmallByteArray& frameBytes);
 			
 			/**
 			 * This constructor manually creates a text frame with custom text.
@@ -24,6 +24,12 @@
 #include "Frames/ID3EventTimingFrame.hpp" //For TimingCodes
 #include "ID3FrameID.hpp"                 //For frame IDs
 #include "ID3FrameFactory.hpp"            //For FrameFactory
+#include "ID3ByteSource.hpp"              //For ByteSource
+#include "ID3TrailingTags.hpp"            //For TrailingTags
+#include "ID3Chunks.hpp"                  //For ChunkIndex
+#include "ID3MP4Atoms.hpp"                //For AtomIndex
+#include "ID3Timestamp.hpp"               //For Timestamp
+#include "ID3FrameView.hpp"               //For FrameView and FrameFilter
 
 /**
  * The ID3 namespace defines everything related to reading and writing
@@ -163,12 +169,41 @@ namespace ID3 {
 		 *         Picture frame, excluding the header.
 		 */
 		inline ulong size() const { return MIME.size() + 3 + description.size() + data.size(); }
+		/**
+		 * @return The format and size of the image, from its header.
+		 * @see ID3::PictureFrame::imageInfo(const uint8_t*, ulong)
+		 */
+		inline ImageInfo image() const { return PictureFrame::imageInfo(data); }
 		std::string MIME;
 		PictureType type;
 		std::string description;
 		ByteArray   data;
 	};
 	
+	/**
+	 * A struct that describes a picture embedded in ID3v2 tags without holding
+	 * its data, so that every picture in a tag can be compared before choosing
+	 * one to copy.
+	 * 
+	 * @see ID3::Tag::pictureInfo()
+	 */
+	struct PictureInfo {
+		std::string MIME;        //The MIME type in the frame
+		PictureType type;        //The picture type
+		std::string description; //The description
+		ulong       bytes;       //The size of the picture data
+		ImageInfo   image;       //The format and size found from the picture data
+		
+		/**
+		 * @return If the MIME type in the frame is the type of the image data.
+		 *         If the image format isn't recognised, this is false.
+		 */
+		inline bool mimeMatches() const {
+			return image.format != ImageFormat::UNKNOWN &&
+			       (MIME == image.mimeType() || "image/" + MIME == image.mimeType());
+		}
+	};
+	
 	/**
 	 * A struct that contains information about an event timing code.
 	 * If the value of the timing code is not set in the tags, the value should
@@ -217,6 +252,143 @@ namespace ID3 {
 		std::string language;
 	};
 	
+	/**
+	 * A number and total, such as the track number and the number of tracks,
+	 * from the "number/total" text of the track and disc frames. A field that
+	 * isn't set, or isn't a valid integer, is 0.
+	 * 
+	 * @see ID3::Tag::trackNumbers()
+	 * @see ID3::Tag::discNumbers()
+	 */
+	struct NumberPair {
+		/**
+		 * Create a NumberPair struct. Both fields default to 0.
+		 * 
+		 * Defined in ID3Tag.cpp.
+		 * 
+		 * @param number The number.
+		 * @param total  The total.
+		 */
+		NumberPair(const ulong number=0, const ulong total=0);
+		ulong number; //The number, such as the track number
+		ulong total;  //The total, such as the number of tracks
+		
+		/**
+		 * Parse a NumberPair from the text of a track or disc frame.
+		 * 
+		 * Defined in ID3Tag.cpp.
+		 * 
+		 * @param text The frame text, such as "3/12".
+		 * @return The number and total.
+		 */
+		static NumberPair parse(const std::string& text);
+	};
+	
+	class SharedFrames;
+	
+	/**
+	 * What writing a tag does to the ID3v1, ID3v1.1, and ID3v1 Extended tags
+	 * at the end of an MP3 file.
+	 * 
+	 * NOTE: Removing the tags means rewriting the whole file, while keeping or
+	 *       updating them lets the ID3v2 tag be written in place. Files
+	 *       without ID3v1 tags never get one, and WAV, AIFF, and MP4 files
+	 *       always keep theirs as they are.
+	 * 
+	 * @see ID3::WriteOptions
+	 */
+	enum class V1Policy : uint8_t {
+		REMOVE, //Remove the tags
+		KEEP,   //Leave the tags as they are
+		UPDATE  //Overwrite the tags with the title, artist, album, year, comment, track, and genre
+	};
+	
+	/**
+	 * Options for writing a tag to file.
+	 * 
+	 * Defined in ID3Tag.cpp.
+	 * 
+	 * @see ID3::Tag::write(std::string&, WriteOptions&)
+	 */
+	struct WriteOptions {
+		WriteOptions();
+		float paddingFactor;              //The padding to add if the file is rewritten, as a fraction of the tag size (0.1)
+		ulong maxPadding;                 //The most padding to leave in the tag. If writing in place would leave more, the file is rewritten (no limit)
+		bool setFileNameUponSuccess;      //If the filename is only set once the write succeeds (true)
+		bool discardNonCoverPictures;     //If all but the first front cover picture are discarded (false)
+		bool discardUnknown;              //If unknown frames are discarded (false)
+		bool addTaggingTime;              //If the tagging time frame is set, or discarded if false (true)
+		bool smallestEncoding;            //If every text frame is written in the encoding that takes the fewest bytes (false)
+		bool dedupePictures;              //If pictures with the same data as an earlier picture are discarded (false)
+		bool dryRun;                      //If the file and the Tag are left unchanged, and only the result is worked out (false)
+		const SharedFrames* sharedFrames; //Frames written to the tag in place of the Tag's matching frames (nullptr)
+		V1Policy v1Policy;                //What happens to the ID3v1 tags at the end of MP3 files (REMOVE)
+	};
+	
+	/**
+	 * What writing a tag to file did, or would do for a dry run.
+	 * 
+	 * Defined in ID3Tag.cpp.
+	 * 
+	 * @see ID3::Tag::write(std::string&, WriteOptions&)
+	 */
+	struct WriteResult {
+		WriteResult();
+		bool rewritten;         //If the file was rewritten, or for WAV and AIFF files if the ID3 chunk was moved
+		ulong oldSize;          //The bytes the ID3v2 tag took up on file, plus any ID3v1 tags that were removed
+		ulong tagSize;          //The size of the new ID3v2 tag without padding, including the header
+		ulong padding;          //The padding after the new ID3v2 tag
+		ulong discardedFrames;  //The frames that weren't written because of the write options
+		ulong replacedFrames;   //The frames that weren't written because a shared frame replaced them
+		
+		/**
+		 * @return The bytes the new ID3v2 tag takes up on file.
+		 */
+		inline ulong newSize() const { return tagSize + padding; }
+	};
+	
+	/**
+	 * Why a write rewrites the file, or IN_PLACE if it doesn't.
+	 * 
+	 * @see ID3::WritePlan
+	 */
+	enum class WriteReason : uint8_t {
+		IN_PLACE,      //The tag fits in the space the old tag took up on file
+		V1_TAIL,       //The ID3v1 tags at the end of the file are being removed
+		NO_V2_TAG,     //There's no ID3v2 tag (or ID3 chunk) on file to write over
+		TAG_OVERFLOW,  //The tag is bigger than the space the old tag took up on file
+		EXCESS_PADDING //Writing in place would leave more padding than WriteOptions::maxPadding
+	};
+	
+	/**
+	 * What writing a tag to file would do, and how many bytes it would write.
+	 * 
+	 * Defined in ID3Tag.cpp.
+	 * 
+	 * @see ID3::Tag::planWrite(std::string&, WriteOptions&)
+	 */
+	struct WritePlan {
+		WritePlan();
+		bool rewrite;       //If the file would be rewritten, or for WAV and AIFF files if the ID3 chunk would be moved
+		WriteReason reason; //Why the file would be rewritten
+		bool removeV1;      //If the ID3v1 tags at the end of the file would be removed
+		ulong tagSize;      //The size of the new ID3v2 tag without padding, including the header
+		ulong padding;      //The padding after the new ID3v2 tag
+		ulong oldSize;      //The bytes the ID3v2 tag takes up on file, plus any ID3v1 tags that would be removed
+		ulong movedBytes;   //The audio and trailing tags that would be moved, or for WAV and AIFF files the bytes after the form
+		
+		/**
+		 * @return The bytes the new ID3v2 tag would take up on file.
+		 */
+		inline ulong newSize() const { return tagSize + padding; }
+		
+		/**
+		 * @return The bytes the write would write to file, not counting ID3v1
+		 *         tags written in place.
+		 */
+		inline ulong writtenBytes() const { return newSize() + movedBytes; }
+	};
+	
 	/////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////// C L A S S E S ///////////////////////////////
@@ -226,7 +398,7 @@ namespace ID3 {
 	/**
 	 * A class that, given a file or filename, will read its ID3 tags.
 	 * Call Tag::null() after instantiation to check if the file was
-	 * properly read. Files must be MP3, MP4, or WAV files.
+	 * properly read. Files must be MP3, MP4, WAV, or AIFF files.
 	 * 
 	 * Frame/tag fields with their own methods:
 	 *     Album
@@ -256,6 +428,8 @@ namespace ID3 {
 	 * Defined in ID3Tag.cpp.
 	 */	
 	class Tag {
+		friend class SharedFrames;
+		
 		public:
 			/**
 			 * Constructor that takes a filename and opens the file.
@@ -265,17 +439,45 @@ namespace ID3 {
 			 * NOTE: If the given file contains ID3v2 tags whose size is stated to
 			 *       be larger than the file itself, an ID3::FormatException will
 			 *       be thrown.
-			 * NOTE: If the file is not an MP3, MP4, or WAV file an
+			 * NOTE: If the file is not an MP3, MP4, WAV, or AIFF file an
 			 *       ID3::NotMP3FileException will be thrown.
 			 * 
 			 * @param fileLoc The file path.
 			 * @throws ID3::ID3FileNotFoundException if the file does not exist.
 			 * @throws ID3::FileFormatException if the ID3v2 tags on file are
 			 *         supposedly bigger than the file itself.
-			 * @throws ID3::NotMP3FileException if the file is not an MP3, MP4, or WAV file.
+			 * @throws ID3::NotMP3FileException if the file is not an MP3, MP4, WAV, or AIFF file.
 			 */
 			explicit Tag(const std::string& fileLoc);
 			
+			/**
+			 * Constructor that reads the tags from a ByteSource, such as the bytes
+			 * of a file already in memory. The Tag doesn't have a filename, so
+			 * it's given to write().
+			 * 
+			 * NOTE: The source isn't kept once the tags are read.
+			 * 
+			 * @param source The bytes of an MP3, MP4, WAV, or AIFF file.
+			 * @throws ID3::FileFormatException if the ID3v2 tags are supposedly
+			 *         bigger than the source itself.
+			 * @see ID3::MemoryByteSource
+			 */
+			explicit Tag(const std::shared_ptr<const ByteSource>& source);
+			
+			/**
+			 * Constructor that reads the tags of a file from a ByteSource, such as
+			 * one with the tag already read into memory. The Tag has the filename,
+			 * the same as ID3::Tag::Tag(std::string&).
+			 * 
+			 * @param fileLoc The file path.
+			 * @param source  The bytes of the file.
+			 * @throws ID3::FileFormatException if the ID3v2 tags are supposedly
+			 *         bigger than the source itself.
+			 * @throws ID3::NotMP3FileException if the file is not an MP3, MP4, WAV, or AIFF file.
+			 * @see ID3::PrefetchReader
+			 */
+			Tag(const std::string& fileLoc, const std::shared_ptr<const ByteSource>& source);
+			
 			/**
 			 * A constructor that creates a blank Tag object without a file.
 			 */
@@ -299,7 +501,7 @@ namespace ID3 {
 			 * NOTE: If the given file contains ID3v2 tags whose size is stated to
 			 *       be larger than the file itself, an ID3::FormatException will
 			 *       be thrown.
-			 * NOTE: If the file is not an MP3, MP4, or WAV file a
+			 * NOTE: If the file is not an MP3, MP4, WAV, or AIFF file a
 			 *       ID3::NotMP3FileException will be thrown.
 			 * NOTE: If another Tag object or another program has edited the ID3
 			 *       tags on the file between the creation of this object and the
@@ -313,6 +515,18 @@ namespace ID3 {
 			 *       size, then padding will be added to make it fit. If it is
 			 *       bigger, or a v1 tag is on file, then the entire file will be
 			 *       rewritten to contain the tags.
+			 * NOTE: APEv2 and Lyrics3 tags after the audio data are kept when the
+			 *       file is rewritten.
+			 * NOTE: In WAV and AIFF files the tag is written to the ID3 chunk. If
+			 *       it doesn't fit, the old chunk is renamed to a "JUNK" chunk
+			 *       ("FREE" in AIFF files, which have no JUNK chunk) and a new ID3
+			 *       chunk is added to the end of the RIFF or FORM, so the audio
+			 *       data is never moved. ID3v1 tags after the form are not removed.
+			 * NOTE: In MP4 files the tag is written to the ID32 box, which can
+			 *       grow into a free box right after it. If there is no ID32 box,
+			 *       a top-level free box is turned into a meta box holding one.
+			 *       If the tag doesn't fit, an ID3::WriteException is thrown, as
+			 *       MP4 files can't be rewritten. ID3v1 tags are not removed.
 			 * NOTE: The tagging time timestamp is in GMT, not your current timezone.
 			 * 
 			 * @param fileLoc        The file to write to.
@@ -358,6 +572,49 @@ namespace ID3 {
 			           const bool         discardUnknown=false,
 			           const bool         addTaggingTime=true);
 			
+			/**
+			 * Write the tags to the file location given, with write options.
+			 * 
+			 * If the new tag would leave more than options.maxPadding bytes of
+			 * padding when written in place, the file is rewritten to reclaim the
+			 * space, and the padding is limited to options.maxPadding. This is
+			 * ignored for WAV, AIFF, and MP4 files, where the audio data is never
+			 * moved.
+			 * 
+			 * If there are shared frames, the Tag's frames that they replace aren't
+			 * written, and the shared frames are written after the Tag's frames
+			 * without being copied. The replaced frames are deleted from the Tag
+			 * once the write succeeds, but the shared frames aren't added to it.
+			 * 
+			 * For a dry run, the file isn't changed, and the result says what the
+			 * write would do. The tag is built from copies of the frames, so the
+			 * Tag isn't changed either.
+			 * 
+			 * @param fileLoc The file to write to.
+			 * @param options The write options.
+			 * @return What the write did.
+			 * @see ID3::Tag::write(std::string&, float, bool, bool, bool, bool)
+			 */
+			WriteResult write(const std::string& fileLoc, const WriteOptions& options);
+			
+			/**
+			 * Work out what writing the tags to the file location given would do,
+			 * without opening the file for writing. The plan says whether the
+			 * tag fits in place or the file would be rewritten and why, and how
+			 * many bytes of audio would be moved, so callers can decide which
+			 * files to write first or leave alone.
+			 * 
+			 * NOTE: The tag is built from copies of the frames, so the Tag isn't
+			 *       changed. This copies every frame, pictures included.
+			 * 
+			 * @param fileLoc The file to plan a write to.
+			 * @param options The write options.
+			 * @return What the write would do.
+			 * @throws The same exceptions as a dry run of
+			 *         ID3::Tag::write(std::string&, WriteOptions&).
+			 */
+			WritePlan planWrite(const std::string& fileLoc, const WriteOptions& options=WriteOptions()) const;
+			
 			/**
 			 * Write the tags to the file. This method will write to the last valid
 			 * file location given in the write method, or if was never called the
@@ -680,18 +937,26 @@ namespace ID3 {
 			 * Get the genre tag.
 			 * 
 			 * @param process If true, this will process the genre string according
-			 *                to the specification of the TCOM frame. It will look
-			 *                for a number surrounded by parenthesis. If found, the
-			 *                substring will be removed, and if no text follows the
-			 *                substring, the number will be parsed and the
-			 *                corresponding ID3v1 genre will be returned.
+			 *                to the specification of the TCON frame with
+			 *                ID3::parseGenres(), and return the most specific
+			 *                genre: the refinement text if there is any, or the
+			 *                last ID3v1 genre reference otherwise, so "(4)Eurodisco"
+			 *                becomes "Eurodisco" and "(17)" becomes "Rock".
 			 *                If false, the raw genre string as it appears on file
 			 *                will be returned.
 			 * @return The genre of the tag, or "" if no genre is set.
 			 */
 			std::string genre(bool process=true) const;
-			/** @see ID3::Tag::genre(bool)
-			 *  @see ID3::Tag::textStrings(Frames) */
+			/**
+			 * Get every genre of the tag.
+			 * 
+			 * @param process If true, each genre string is parsed with
+			 *                ID3::parseGenres() and every genre it names is
+			 *                returned, so "(17)(RX)Garage Remix" becomes "Rock",
+			 *                "Remix", and "Garage Remix".
+			 * @return The genres of the tag.
+			 * @see ID3::Tag::genre(bool)
+			 * @see ID3::Tag::textStrings(Frames) */
 			std::vector<std::string> genres(bool process=true) const;
 			/**
 			 * Set the genre tag.
@@ -776,7 +1041,7 @@ namespace ID3 {
 			 * @return The year of the tag, or "" if no year is set.
 			 */
 			inline std::string year() const { return exists(FRAME_RECORDING_TIME) ?
-			                                         textString(FRAME_RECORDING_TIME).substr(0,4) :
+			                                         textReference(FRAME_RECORDING_TIME).substr(0,4) :
 			                                         textString(FRAME_YEAR); }
 			/**
 			 * Set the year tag. This sets both the ID3v2.3 year frame, and the
@@ -795,6 +1060,26 @@ namespace ID3 {
 			/** @see ID3::Tag::year(std::string&) */
 			inline void year(const ushort newYear) { year(std::to_string(newYear)); }
 			
+			/**
+			 * Get the timestamp of an ID3v2.4 time frame, such as the recording
+			 * time (TDRC), original release time (TDOR), release time (TDRL), or
+			 * tagging time (TDTG) frame.
+			 * 
+			 * @param frameName The frame ID.
+			 * @return The timestamp, which is empty if the frame isn't set or
+			 *         doesn't start with a four-digit year.
+			 * @see ID3::Timestamp::parse(std::string&)
+			 */
+			Timestamp timestamp(const FrameID& frameName) const;
+			/**
+			 * Set an ID3v2.4 time frame, to the timestamp's precision. An empty
+			 * timestamp empties the frame, so it isn't written to file.
+			 * 
+			 * @param frameName    The frame ID.
+			 * @param newTimestamp The new timestamp.
+			 */
+			void timestamp(const FrameID& frameName, const Timestamp& newTimestamp);
+			
 			/**
 			 * Get the track tag.
 			 * 
@@ -819,7 +1104,7 @@ namespace ID3 {
 			 */
 			void track(const std::string& newTrack);
 			/** @see ID3::Tag::track(std::string&) */
-			inline void track(const ulong newTrack) { track(std::to_string(newTrack)); }
+			inline void track(const ulong newTrack) { trackNumbers(NumberPair(newTrack, trackNumbers().total)); }
 			/**
 			 * Get the total number of tracks in the set of the original recording.
 			 * This is taken from the TRCK frame, and consists of text
@@ -839,7 +1124,22 @@ namespace ID3 {
 			 */
 			void trackTotal(const std::string& newTrackTotal);
 			/** @see ID3::Tag::trackTotal(std::string&) */
-			inline void trackTotal(const ulong newTrackTotal) { text(FRAME_TRACK, track()+'/'+std::to_string(newTrackTotal)); }
+			inline void trackTotal(const ulong newTrackTotal) { trackNumbers(NumberPair(trackNumbers().number, newTrackTotal)); }
+			/**
+			 * Get the track number and track total as integers.
+			 * 
+			 * @return The track number and total, with 0 for either if it isn't
+			 *         set.
+			 */
+			inline NumberPair trackNumbers() const { return NumberPair::parse(textReference(FRAME_TRACK)); }
+			/**
+			 * Set the track number and track total. A field that's 0 isn't
+			 * written, and if both are 0 the track frame is emptied, so it isn't
+			 * written to file.
+			 * 
+			 * @param numbers The new track number and total.
+			 */
+			inline void trackNumbers(const NumberPair& numbers) { numberPair(FRAME_TRACK, numbers); }
 			
 			/**
 			 * Get the disc number tag.
@@ -865,7 +1165,7 @@ namespace ID3 {
 			 */
 			void disc(const std::string& newDisc);
 			/** @see ID3::Tag::track(std::string&) */
-			inline void disc(const ulong newDisc) { disc(std::to_string(newDisc)); }
+			inline void disc(const ulong newDisc) { discNumbers(NumberPair(newDisc, discNumbers().total)); }
 			/**
 			 * Get the total number of discs in the set of the original recording.
 			 * This is taken from the TPOS frame, and consists of text
@@ -885,7 +1185,22 @@ namespace ID3 {
 			 */
 			void discTotal(const std::string& newDiscTotal);
 			/** @see ID3::Tag::discTotal(std::string&) */
-			inline void discTotal(const ulong newDiscTotal) { text(FRAME_DISC, disc()+'/'+std::to_string(newDiscTotal)); }
+			inline void discTotal(const ulong newDiscTotal) { discNumbers(NumberPair(discNumbers().number, newDiscTotal)); }
+			/**
+			 * Get the disc number and disc total as integers.
+			 * 
+			 * @return The disc number and total, with 0 for either if it isn't
+			 *         set.
+			 */
+			inline NumberPair discNumbers() const { return NumberPair::parse(textReference(FRAME_DISC)); }
+			/**
+			 * Set the disc number and disc total. A field that's 0 isn't
+			 * written, and if both are 0 the disc frame is emptied, so it isn't
+			 * written to file.
+			 * 
+			 * @param numbers The new disc number and total.
+			 */
+			inline void discNumbers(const NumberPair& numbers) { numberPair(FRAME_DISC, numbers); }
 			
 			/**
 			 * Get the composer tag.
@@ -1118,6 +1433,31 @@ namespace ID3 {
 			 * @return A vector of Picture structs.
 			 */
 			std::vector<Picture> pictures() const;
+			/**
+			 * Describe every attached picture, without copying the picture data.
+			 * The image format and size are read from the start of each picture.
+			 * 
+			 * @return The pictures, in the same order as pictures().
+			 * @see ID3::PictureFrame::imageInfo(const uint8_t*, ulong)
+			 */
+			std::vector<PictureInfo> pictureInfo() const;
+			/**
+			 * Get the best attached picture to use as artwork. Only the chosen
+			 * picture is copied.
+			 * 
+			 * Pictures are chosen by, in order:
+			 *   - Having picture data that is a recognised image format.
+			 *   - Having the given picture type.
+			 *   - Having the most pixels.
+			 *   - Having the smallest picture data.
+			 * 
+			 * NOTE: If there are no pictures in the tag, a "null" Picture is
+			 *       returned.
+			 * 
+			 * @param type The picture type to prefer. Defaults to FRONT_COVER.
+			 * @return The best picture.
+			 */
+			Picture bestPicture(const PictureType type=PictureType::FRONT_COVER) const;
 			/**
 			 * Set a picture.
 			 * 
@@ -1285,6 +1625,37 @@ namespace ID3 {
 			 */
 			size_t size() const;
 			
+			/**
+			 * @returns Roughly how many bytes the Tag takes up in memory, counting
+			 *          each frame's bytes twice for the parsed copy of its
+			 *          content.
+			 */
+			ulong memoryUsage() const;
+			
+			/**
+			 * Visit the frames in the order they were read from the file, followed
+			 * by the frames added since in the order they were added. Null and
+			 * empty frames are skipped.
+			 * 
+			 * Each frame is seen through a FrameView that points to its content,
+			 * so visiting the frames doesn't allocate memory.
+			 * 
+			 * Example:
+			 *     tag.visitFrames([&](const ID3::FrameView& frame) {
+			 *         std::cout << frame.id() << ": " << frame.text() << '\n';
+			 *         return true;
+			 *     }, ID3::FrameFilter{ID3::CLASS_TEXT, ID3::CLASS_DESCRIPTIVE});
+			 * 
+			 * NOTE: The Tag can't be changed by the visitor.
+			 * 
+			 * @param visitor The function called for each frame. Returning false
+			 *                stops visiting frames.
+			 * @param filter  Which frames to visit (defaults to every frame).
+			 * @return The number of frames visited.
+			 */
+			size_t visitFrames(const std::function<bool (const FrameView&)>& visitor,
+			                   const FrameFilter&                          filter=FrameFilter()) const;
+			
 			/**
 			 * @returns The filename last given in write(std::string&), or the
 			 *          filename given in the constructor
@@ -1301,6 +1672,24 @@ namespace ID3 {
 			 */
 			ulong fileSize() const;
 			
+			/**
+			 * @returns The ID3v1, APEv2, and Lyrics3 tags that were found after
+			 *          the audio data when the file was read.
+			 */
+			const TrailingTags& trailingTags() const;
+			
+			/**
+			 * @returns The position that the audio data starts on, which is the
+			 *          end of the ID3v2 tag, or 0 if there is no ID3v2 tag.
+			 */
+			ulong audioStart() const;
+			
+			/**
+			 * @returns The position right after the last byte of audio data, before
+			 *          any ID3v1, APEv2, or Lyrics3 tags.
+			 */
+			ulong audioEnd() const;
+			
 			/**
 			 * Print all the tag information.
 			 * 
@@ -1339,7 +1728,9 @@ namespace ID3 {
 				ulong size;                 //Tag size
 				ulong totalSize;            //Total tag size (tag size + header size
 				                            // + extended header size + footer size)
-				ulong paddingStart;         //The byte in which padding starts
+				ulong paddingStart;         //The byte in which padding starts,
+				                            // relative to the start of the tag
+				ulong offset;               //The file position the tag starts on
 			};
 			
 			/**
@@ -1386,6 +1777,24 @@ namespace ID3 {
 			 */
 			bool addFrame(const FramePair& frameMapPair);
 			
+			/**
+			 * Erase a frame from the FrameMap and the frame order. Its position in
+			 * the frame order is cleared instead of removed, and the cleared
+			 * positions are removed once they're half of the frame order, so
+			 * erasing frames one at a time is linear.
+			 * 
+			 * @param frame The frame's position in the FrameMap.
+			 */
+			void eraseFrame(FrameMap::const_iterator frame);
+			
+			/**
+			 * Erase every frame that a predicate is true for from the FrameMap and
+			 * the frame order. The predicate is only called on non-null pointers.
+			 * 
+			 * @param predicate The function that decides if a frame is erased.
+			 */
+			void eraseFrames(const std::function<bool (const Frame&)>& predicate);
+			
 			/**
 			 * A protected method to get a Frame from the FrameMap.
 			 * If the requested frame is not in the map, "null", or if it's not the
@@ -1402,6 +1811,36 @@ namespace ID3 {
 			template<typename DerivedFrame>
 			DerivedFrame* getFrame(const FrameID& frameName) const;
 			
+			/**
+			 * Get the text content of a frame without copying it.
+			 * 
+			 * @param frameName An ID3v2 frame ID.
+			 * @return The text content, or a reference to an empty string if the
+			 *         frame is not found, "null", or not a text frame.
+			 * @see ID3::Tag::textString(FrameID&)
+			 */
+			const std::string& textReference(const FrameID& frameName) const;
+			
+			/**
+			 * Set the text of a track or disc frame to a number and total,
+			 * without allocating for numbers that fit in a short string.
+			 * 
+			 * @param frameName The frame ID.
+			 * @param numbers   The number and total.
+			 */
+			void numberPair(const FrameID& frameName, const NumberPair& numbers);
+			
+			/**
+			 * Replace the number or the total in the text of a track or disc frame,
+			 * keeping the other field's text as it is. The frame's text is only
+			 * read once, and the new text is built without temporary strings.
+			 * 
+			 * @param frameName The frame ID.
+			 * @param field     The new number or total, or "" to remove it.
+			 * @param total     If the total is replaced instead of the number.
+			 */
+			void numberPairField(const FrameID& frameName, const std::string& field, const bool total);
+			
 			/**
 			 * A protected method to get a Frame from the FrameMap.
 			 * If the requested frame is not in the map, "null", or if it's not the
@@ -1452,13 +1891,17 @@ namespace ID3 {
 			/**
 			 * A constructor helper method that reads the ID3 tags from the file.
 			 * 
-			 * @param file       The file stream object.
+			 * @param source     The bytes of the file.
 			 * @param readFrames Whether to read frames or not.
 			 */
-			void readFile(std::istream& file, const bool readFrames=true);
+			void readFile(const std::shared_ptr<const ByteSource>& source, const bool readFrames=true);
 			
 			/**
-			 * A constructor helper method that reads the ID3v1 tags from the file.
+			 * A constructor helper method that reads the ID3v1 tags from the file,
+			 * along with the locations of all the other tags after the audio data.
+			 * 
+			 * NOTE: This must be called after readFileV2(), so that the ID3v2 tag
+			 *       isn't mistaken for a trailing tag on small files.
 			 * 
 			 * @param file The file stream object.
 			 * @param readFrames Whether to read frames or not.
@@ -1468,12 +1911,107 @@ namespace ID3 {
 			/**
 			 * A constructor helper method that reads the ID3v2 tags from the file.
 			 * 
-			 * @param file       The file stream object.
+			 * @param file       The stream over the bytes of the file.
 			 * @param readFrames Whether to read frames or not.
+			 * @param tagStart   The file position the ID3v2 tag starts on.
+			 * @param tagLimit   The file position the ID3v2 tag must end by, or
+			 *                   0 for the end of the file.
 			 * @throws ID3::FileFormatException if the ID3v2 tags on file are
-			 *         supposedly bigger than the file itself.
+			 *         supposedly bigger than the file itself or their chunk.
 			 */
-			void readFileV2(std::istream& file, const bool readFrames=true);
+			void readFileV2(ByteSourceStream& file,
+			                const bool        readFrames=true,
+			                const ulong       tagStart=0,
+			                const ulong       tagLimit=0);
+			
+			/**
+			 * A write helper method that copies the Tag along with each of its
+			 * frames, so that the copy's frames can be prepared for writing
+			 * without changing this Tag. Used for write plans and dry runs.
+			 * 
+			 * @return The copy.
+			 */
+			Tag frameCopy() const;
+			
+			/**
+			 * A write helper method that prepares the frames for writing and
+			 * serializes the ID3v2 tag, without the shared frames or padding. The
+			 * size bytes in the header are left as 0.
+			 * 
+			 * @param fileInfo        A Tag of the file's current information.
+			 * @param options         The write options.
+			 * @param discardedFrames The frames that the options discard, which
+			 *                        aren't written.
+			 * @param result          The write result, for the discarded and
+			 *                        replaced frame counts.
+			 * @return The ID3v2 tag header and frames.
+			 * @throws ID3::FrameSizeException if a frame is bigger than the
+			 *         maximum frame size.
+			 */
+			ByteArray tagData(const Tag&                 fileInfo,
+			                  const WriteOptions&        options,
+			                  std::vector<const Frame*>& discardedFrames,
+			                  WriteResult&               result);
+			
+			/**
+			 * A write helper method that works out whether a tag fits in place,
+			 * its padding, and the bytes that would be moved.
+			 * 
+			 * @param fileInfo   A Tag of the file's current information.
+			 * @param options    The write options.
+			 * @param frameBytes The size of the tag header and the Tag's frames.
+			 * @param fileLoc    The file location, for error messages.
+			 * @return The write plan.
+			 * @throws ID3::WriteException if an MP4 file has no room for the tag.
+			 * @throws ID3::TagSizeException if the tag would be bigger than the
+			 *         maximum tag size.
+			 */
+			WritePlan planWrite(const Tag&          fileInfo,
+			                    const WriteOptions& options,
+			                    const ulong         frameBytes,
+			                    const std::string&  fileLoc) const;
+			
+			/**
+			 * A write helper method that writes the ID3v2 tag into the ID3 chunk
+			 * of a WAV or AIFF file. If the tag doesn't fit in the chunk (or there
+			 * is no chunk), then the old chunk is renamed to "JUNK" in RIFF files or
+			 * "FREE" in AIFF files, a new chunk is appended to the end of the form,
+			 * and the form size is updated. Any bytes after the form are kept after
+			 * the new chunk.
+			 * 
+			 * @param file       The file stream object, open for reading and writing.
+			 * @param fileInfo   A Tag of the file's current information.
+			 * @param tagData    The ID3v2 tag to write.
+			 * @param moveChunk  If the tag needs a new chunk.
+			 * @param fileLoc    The file location, for error messages.
+			 * @return The file position the tag was written to.
+			 * @throws ID3::WriteException if the file cannot be written to or the
+			 *         form would become bigger than 4GiB.
+			 */
+			ulong writeChunk(std::fstream&      file,
+			                 const Tag&         fileInfo,
+			                 const ByteArray&   tagData,
+			                 const bool         moveChunk,
+			                 const std::string& fileLoc) const;
+			
+			/**
+			 * A write helper method that writes the ID3v2 tag into the ID32 box
+			 * of an MP4 file, resizing the box into the free box after it or
+			 * turning a top-level free box into a meta box.
+			 * 
+			 * NOTE: The tag must be exactly AtomIndex::id3Space() bytes.
+			 * 
+			 * @param file     The file stream object, open for reading and writing.
+			 * @param fileInfo A Tag of the file's current information.
+			 * @param tagData  The ID3v2 tag to write.
+			 * @param fileLoc  The file location, for error messages.
+			 * @return The file position the tag was written to.
+			 * @throws ID3::WriteException if the file cannot be written to.
+			 */
+			ulong writeAtom(std::fstream&      file,
+			                const Tag&         fileInfo,
+			                const ByteArray&   tagData,
+			                const std::string& fileLoc) const;
 			
 			/**
 			 * A constructor helper method that gets a v1 tag struct and sets the class'
@@ -1500,9 +2038,13 @@ namespace ID3 {
 			 * variables to the information in the struct. This will override any information
 			 * previously set from a v1 or v1.1 tag.
 			 * 
-			 * @param tags The ID3v1 Extended tag struct.
+			 * The title, artist, and album of an Extended tag continue the ones in
+			 * the v1 tag, so they're joined if the v1 field is full.
+			 * 
+			 * @param tags   The ID3v1 Extended tag struct.
+			 * @param v1Tags The ID3v1 or ID3v1.1 tag struct that follows it.
 			 */
-			void setTags(const V1::ExtendedTag& tags);
+			void setTags(const V1::ExtendedTag& tags, const V1::Tag& v1Tags);
 			
 			/**
 			 * A TagsOnFile struct that records all the ID3 versions
@@ -1516,11 +2058,40 @@ namespace ID3 {
 			 */
 			TagInfo v2TagInfo;
 			
+			/**
+			 * The tags found after the audio data.
+			 */
+			TrailingTags trailingTagInfo;
+			
+			/**
+			 * The top-level chunks of a WAV or AIFF file.
+			 */
+			ChunkIndex chunkIndex;
+			
+			/**
+			 * The boxes of an MP4 file that can hold the ID3v2 tag.
+			 */
+			AtomIndex atomIndex;
+			
 			/**
 			 * A map of all frames stored in the tag.
 			 */
 			FrameMap frames;
 			
+			/**
+			 * The frames in the map in the order they were read or added, for
+			 * visitFrames(). The map owns them, so a frame has to be removed from
+			 * here before it's erased from the map. Erased frames can leave null
+			 * pointers, which are skipped.
+			 */
+			std::vector<Frame*> frameOrder;
+			
+			/**
+			 * The position of each frame in the frame order. It's only filled by
+			 * eraseFrame(), so tags that never erase a single frame don't build it.
+			 */
+			std::unordered_map<const Frame*, size_t> framePositions;
+			
 			/**
 			 * The FrameFactory to create Frame objects.
 			 */
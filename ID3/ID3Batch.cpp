@@ -0,0 +1,139 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm> //For std::sort() and std::stable_sort()
+#include <atomic>    //For std::atomic
+#include <exception> //For std::exception
+#include <limits>    //For std::numeric_limits
+#include <mutex>     //For std::mutex
+#include <numeric>   //For std::iota()
+#include <thread>    //For std::thread
+
+#ifdef __linux__
+#include <fcntl.h>        //For open()
+#include <linux/fiemap.h> //For struct fiemap
+#include <linux/fs.h>     //For FS_IOC_FIEMAP and FIBMAP
+#include <sys/ioctl.h>    //For ioctl()
+#include <sys/stat.h>     //For fstat()
+#include <unistd.h>       //For close()
+#endif
+
+#include "ID3Batch.hpp"      //For the class definition
+#include "ID3IOThrottle.hpp" //For IOThrottle::Scope
+
+using namespace ID3;
+
+///@pkg ID3Batch.h
+BatchOptions::BatchOptions() : threads(0), throttle(nullptr), physicalOrder(false) {}
+
+///@pkg ID3Batch.h
+BatchError::BatchError(const size_t file, const std::string& message) : file(file), message(message) {}
+
+///@pkg ID3Batch.h
+Batch::Batch(const std::vector<std::string>& files, const BatchOptions& options) : fileList(files),
+                                                                                   batchOptions(options) {}
+
+///@pkg ID3Batch.h
+const std::vector<std::string>& Batch::files() const { return fileList; }
+
+///@pkg ID3Batch.h
+unsigned Batch::workers() const {
+	unsigned threads = batchOptions.threads != 0 ? batchOptions.threads : std::thread::hardware_concurrency();
+	if(threads > fileList.size()) threads = fileList.size();
+	return threads == 0 ? 1 : threads;
+}
+
+///@pkg ID3Batch.h
+std::vector<BatchError> Batch::run(const Task& task) const {
+	std::vector<BatchError> errors;
+	std::mutex errorMutex;
+	std::atomic<size_t> nextFile(0);
+	const std::vector<size_t> ORDER = order();
+	
+	//Take files until there are none left
+	auto work = [&](const unsigned worker) {
+		const IOThrottle::Scope scope(batchOptions.throttle);
+		for(size_t next = nextFile++; next < ORDER.size(); next = nextFile++) {
+			const size_t file = ORDER[next];
+			try {
+				task(file, worker);
+			} catch(const std::exception& e) {
+				std::lock_guard<std::mutex> lock(errorMutex);
+				errors.emplace_back(file, e.what());
+			} catch(...) {
+				std::lock_guard<std::mutex> lock(errorMutex);
+				errors.emplace_back(file, "Unknown exception");
+			}
+		}
+	};
+	
+	//Run the first worker on this thread
+	const unsigned WORKERS = workers();
+	std::vector<std::thread> threads;
+	for(unsigned worker = 1; worker < WORKERS; worker++)
+		threads.emplace_back(work, worker);
+	work(0);
+	for(std::thread& thread : threads) thread.join();
+	
+	std::sort(errors.begin(), errors.end(), [](const BatchError& first, const BatchError& second) {
+		return first.file < second.file;
+	});
+	return errors;
+}
+
+///@pkg ID3Batch.h
+std::vector<size_t> Batch::order() const {
+	std::vector<size_t> files(fileList.size());
+	std::iota(files.begin(), files.end(), 0);
+	if(!batchOptions.physicalOrder) return files;
+	
+	//Sort by the location on disk. Files that can't be located have the
+	//maximum offset, so the stable sort leaves them last in list order.
+	std::vector<ulong> offsets(fileList.size());
+	for(size_t file = 0; file < fileList.size(); file++)
+		offsets[file] = physicalOffset(fileList[file]);
+	std::stable_sort(files.begin(), files.end(), [&offsets](const size_t first, const size_t second) {
+		return offsets[first] < offsets[second];
+	});
+	return files;
+}
+
+///@pkg ID3Batch.h
+ulong Batch::physicalOffset(const std::string& fileLoc) {
+	ulong offset = std::numeric_limits<ulong>::max();
+	#ifdef __linux__
+	const int fd = open(fileLoc.c_str(), O_RDONLY);
+	if(fd < 0) return offset;
+	
+	//Ask for the first extent of the file
+	union {
+		struct fiemap map;
+		char bytes[sizeof(struct fiemap) + sizeof(struct fiemap_extent)];
+	} extents = {};
+	extents.map.fm_start = 0;
+	extents.map.fm_length = FIEMAP_MAX_OFFSET;
+	extents.map.fm_extent_count = 1;
+	if(ioctl(fd, FS_IOC_FIEMAP, &extents.map) == 0) {
+		if(extents.map.fm_mapped_extents > 0)
+			offset = extents.map.fm_extents[0].fe_physical;
+	} else {
+		//FIBMAP maps a block of the file to a block on the device
+		struct stat fileStat;
+		int block = 0;
+		if(fstat(fd, &fileStat) == 0 && ioctl(fd, FIBMAP, &block) == 0 && block > 0)
+			offset = static_cast<ulong>(block) * fileStat.st_blksize;
+	}
+	
+	close(fd);
+	#endif
+	return offset;
+}
@@ -0,0 +1,148 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_BATCH_HPP
+#define ID3_BATCH_HPP
+
+#include <functional> //For std::function
+#include <string>     //For std::string
+#include <vector>     //For std::vector
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	class IOThrottle;
+	
+	/**
+	 * Options for running a task over many files.
+	 */
+	struct BatchOptions {
+		BatchOptions();
+		unsigned threads;     //The number of worker threads, or 0 for the number of hardware threads
+		IOThrottle* throttle; //The I/O budget shared by the workers, or nullptr for no limit (nullptr)
+		bool physicalOrder;   //If files are taken in the order they're stored on disk, instead of list order (false)
+	};
+	
+	/**
+	 * A file that a batch task failed on.
+	 */
+	struct BatchError {
+		BatchError(const size_t file, const std::string& message);
+		size_t file;         //The position of the file in the batch
+		std::string message; //The exception message
+	};
+	
+	/**
+	 * Batch runs a task over a list of files on a pool of worker threads.
+	 * Workers take the next file as soon as they finish one, so slow files
+	 * don't hold up the rest of the batch.
+	 * 
+	 * Each call of the task is given the worker number, so that workers can
+	 * keep their own partial results and merge them when the batch is done,
+	 * instead of locking shared results for every file.
+	 * 
+	 * If the options have a throttle, it's set on every worker with an
+	 * ID3::IOThrottle::Scope, so the reads and writes of the whole batch share
+	 * one budget.
+	 * 
+	 * If the options ask for physical order, the files are sorted by where
+	 * their first block is stored on disk before the batch starts, so that
+	 * the reads sweep across the disk once instead of seeking back and forth.
+	 * This helps on spinning disks, where most of the time reading tags is
+	 * spent seeking. Files whose location can't be found are taken last, in
+	 * list order.
+	 * 
+	 * NOTE: Batches need to be compiled with -pthread.
+	 * 
+	 * Defined in ID3Batch.cpp.
+	 */
+	class Batch {
+		public:
+			/**
+			 * The task to run on each file.
+			 * 
+			 * @param file   The position of the file in the batch.
+			 * @param worker The worker number, from 0 to workers() - 1.
+			 */
+			typedef std::function<void(const size_t file, const unsigned worker)> Task;
+			
+			/**
+			 * Create a batch.
+			 * 
+			 * @param files   The file paths.
+			 * @param options The batch options.
+			 */
+			Batch(const std::vector<std::string>& files, const BatchOptions& options=BatchOptions());
+			
+			/**
+			 * @return The file paths.
+			 */
+			const std::vector<std::string>& files() const;
+			
+			/**
+			 * @return The number of workers run() will use. This is never more
+			 *         than the number of files, and at least 1.
+			 */
+			unsigned workers() const;
+			
+			/**
+			 * Run a task over every file, and wait for it to finish.
+			 * 
+			 * NOTE: Exceptions thrown by the task are caught and returned, and
+			 *       don't stop the batch.
+			 * 
+			 * @param task The task.
+			 * @return The files the task threw an exception on, in file order.
+			 */
+			std::vector<BatchError> run(const Task& task) const;
+			
+			/**
+			 * @return The order run() takes the files in, as positions in the
+			 *         file list.
+			 */
+			std::vector<size_t> order() const;
+			
+			/**
+			 * Get where the start of a file is stored on disk, using the
+			 * FIEMAP ioctl, or FIBMAP if FIEMAP isn't supported.
+			 * 
+			 * NOTE: This only works on Linux. FIBMAP needs root permissions,
+			 *       and some file systems, such as tmpfs, support neither.
+			 * 
+			 * @param fileLoc The file path.
+			 * @return The byte offset of the file's first block on the device,
+			 *         or the maximum ulong value if it can't be found.
+			 */
+			static ulong physicalOffset(const std::string& fileLoc);
+		
+		private:
+			/**
+			 * The file paths.
+			 */
+			std::vector<std::string> fileList;
+			
+			/**
+			 * The batch options.
+			 */
+			BatchOptions batchOptions;
+	};
+}
+
+#endif
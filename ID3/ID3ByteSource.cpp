@@ -0,0 +1,243 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm> //For std::min()
+#include <cerrno>    //For errno and EINTR
+#include <cstring>   //For memcpy()
+
+#include <fcntl.h>    //For open()
+#include <sys/mman.h> //For mmap() and munmap()
+#include <sys/stat.h> //For fstat()
+#include <unistd.h>   //For pread() and close()
+
+#include "ID3ByteSource.hpp" //For the class definitions
+#include "ID3Exception.hpp"  //For FileNotFoundException
+
+using namespace ID3;
+
+///@pkg ID3ByteSource.h
+ByteSource::~ByteSource() {}
+
+///@pkg ID3ByteSource.h
+FileByteSource::FileByteSource(const std::string& fileLoc) : fd(open(fileLoc.c_str(), O_RDONLY | O_CLOEXEC)),
+                                                             owned(true),
+                                                             fileSize(0) {
+	struct stat fileStat;
+	if(fd < 0 || fstat(fd, &fileStat) != 0) {
+		if(fd >= 0) close(fd);
+		throw FileNotFoundException("File \"" + fileLoc + "\" cannot be opened!\n");
+	}
+	fileSize = fileStat.st_size;
+}
+
+///@pkg ID3ByteSource.h
+FileByteSource::FileByteSource(const int fd, const bool owned) : fd(fd),
+                                                                 owned(owned),
+                                                                 fileSize(0) {
+	struct stat fileStat;
+	if(fstat(fd, &fileStat) != 0) {
+		if(owned) close(fd);
+		throw FileNotFoundException("File descriptor " + std::to_string(fd) + " cannot be read!\n");
+	}
+	fileSize = fileStat.st_size;
+}
+
+///@pkg ID3ByteSource.h
+FileByteSource::~FileByteSource() { if(owned) close(fd); }
+
+///@pkg ID3ByteSource.h
+ulong FileByteSource::size() const { return fileSize; }
+
+///@pkg ID3ByteSource.h
+size_t FileByteSource::read(const ulong position, void* buffer, const size_t bytes) const {
+	if(position >= fileSize) return 0;
+	const size_t WANTED = std::min<ulong>(bytes, fileSize - position);
+	
+	//pread() can return fewer bytes than asked for, so keep reading until the
+	//end of the file
+	size_t done = 0;
+	while(done < WANTED) {
+		const ssize_t got = pread(fd, static_cast<char*>(buffer) + done, WANTED - done, position + done);
+		if(got < 0 && errno == EINTR) continue;
+		if(got <= 0) break;
+		done += got;
+	}
+	return done;
+}
+
+///@pkg ID3ByteSource.h
+MappedByteSource::MappedByteSource(const std::string& fileLoc) : mapped(nullptr),
+                                                                 fileSize(0) {
+	const int fd = open(fileLoc.c_str(), O_RDONLY | O_CLOEXEC);
+	struct stat fileStat;
+	if(fd < 0 || fstat(fd, &fileStat) != 0) {
+		if(fd >= 0) close(fd);
+		throw FileNotFoundException("File \"" + fileLoc + "\" cannot be opened!\n");
+	}
+	fileSize = fileStat.st_size;
+	
+	//Empty files can't be mapped, and don't need to be
+	if(fileSize > 0) {
+		void* const memory = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(memory == MAP_FAILED) {
+			close(fd);
+			throw FileNotFoundException("File \"" + fileLoc + "\" cannot be mapped!\n");
+		}
+		mapped = static_cast<const uint8_t*>(memory);
+	}
+	
+	//The map stays valid once the file is closed
+	close(fd);
+}
+
+///@pkg ID3ByteSource.h
+MappedByteSource::~MappedByteSource() {
+	if(mapped != nullptr) munmap(const_cast<uint8_t*>(mapped), fileSize);
+}
+
+///@pkg ID3ByteSource.h
+const uint8_t* MappedByteSource::data() const { return mapped; }
+
+///@pkg ID3ByteSource.h
+ulong MappedByteSource::size() const { return fileSize; }
+
+///@pkg ID3ByteSource.h
+size_t MappedByteSource::read(const ulong position, void* buffer, const size_t bytes) const {
+	if(position >= fileSize) return 0;
+	const size_t READ = std::min<ulong>(bytes, fileSize - position);
+	memcpy(buffer, mapped + position, READ);
+	return READ;
+}
+
+///@pkg ID3ByteSource.h
+MemoryByteSource::MemoryByteSource(const uint8_t* data, const size_t size) : bytesStart(data),
+                                                                             bytesSize(size) {}
+
+///@pkg ID3ByteSource.h
+MemoryByteSource::MemoryByteSource(ByteArray&& bytes) : ownedBytes(std::move(bytes)),
+                                                        bytesStart(ownedBytes.data()),
+                                                        bytesSize(ownedBytes.size()) {}
+
+///@pkg ID3ByteSource.h
+ulong MemoryByteSource::size() const { return bytesSize; }
+
+///@pkg ID3ByteSource.h
+size_t MemoryByteSource::read(const ulong position, void* buffer, const size_t bytes) const {
+	if(position >= bytesSize) return 0;
+	const size_t READ = std::min<ulong>(bytes, bytesSize - position);
+	memcpy(buffer, bytesStart + position, READ);
+	return READ;
+}
+
+///@pkg ID3ByteSource.h
+CallbackByteSource::CallbackByteSource(const ulong size, const Reader& reader) : sourceSize(size),
+                                                                                 reader(reader) {}
+
+///@pkg ID3ByteSource.h
+ulong CallbackByteSource::size() const { return sourceSize; }
+
+///@pkg ID3ByteSource.h
+size_t CallbackByteSource::read(const ulong position, void* buffer, const size_t bytes) const {
+	if(position >= sourceSize) return 0;
+	const size_t WANTED = std::min<ulong>(bytes, sourceSize - position);
+	
+	//Keep calling the reader until it has read everything or returns 0, so
+	//readers can return fewer bytes than asked for
+	size_t done = 0;
+	while(done < WANTED) {
+		const size_t got = std::min(reader(position + done, static_cast<char*>(buffer) + done, WANTED - done), WANTED - done);
+		if(got == 0) break;
+		done += got;
+	}
+	return done;
+}
+
+///@pkg ID3ByteSource.h
+ByteSourceStream::ByteSourceStream(const std::shared_ptr<const ByteSource>& source,
+                                   const size_t                             bufferSize) : std::istream(nullptr),
+                                                                                          streamBuffer(source, bufferSize) {
+	rdbuf(&streamBuffer);
+}
+
+///@pkg ID3ByteSource.h
+const std::shared_ptr<const ByteSource>& ByteSourceStream::source() const { return streamBuffer.source; }
+
+///@pkg ID3ByteSource.h
+ByteSourceStream::Buffer::Buffer(const std::shared_ptr<const ByteSource>& source,
+                                 const size_t                             bufferSize) : source(source),
+                                                                                        buffer(std::max<size_t>(bufferSize, 1)),
+                                                                                        bufferStart(0) {
+	setg(buffer.data(), buffer.data(), buffer.data());
+}
+
+///@pkg ID3ByteSource.h
+ByteSourceStream::Buffer::int_type ByteSourceStream::Buffer::underflow() {
+	if(gptr() < egptr()) return traits_type::to_int_type(*gptr());
+	
+	//Refill the buffer from the position after the buffered bytes
+	bufferStart += egptr() - eback();
+	const size_t READ = source->read(bufferStart, buffer.data(), buffer.size());
+	setg(buffer.data(), buffer.data(), buffer.data() + READ);
+	return READ == 0 ? traits_type::eof() : traits_type::to_int_type(*gptr());
+}
+
+///@pkg ID3ByteSource.h
+std::streamsize ByteSourceStream::Buffer::xsgetn(char_type* s, std::streamsize count) {
+	//Copy what's buffered first
+	std::streamsize done = std::min<std::streamsize>(count, egptr() - gptr());
+	memcpy(s, gptr(), done);
+	gbump(done);
+	if(done == count) return done;
+	
+	//Read big requests straight from the source, and refill for small ones
+	const ulong POSITION = bufferStart + (gptr() - eback());
+	if(static_cast<size_t>(count - done) >= buffer.size()) {
+		const size_t READ = source->read(POSITION, s + done, count - done);
+		bufferStart = POSITION + READ;
+		setg(buffer.data(), buffer.data(), buffer.data());
+		return done + READ;
+	}
+	while(done < count && underflow() != traits_type::eof()) {
+		const std::streamsize COPY = std::min<std::streamsize>(count - done, egptr() - gptr());
+		memcpy(s + done, gptr(), COPY);
+		gbump(COPY);
+		done += COPY;
+	}
+	return done;
+}
+
+///@pkg ID3ByteSource.h
+ByteSourceStream::Buffer::pos_type ByteSourceStream::Buffer::seekoff(off_type                offset,
+                                                                     std::ios_base::seekdir  direction,
+                                                                     std::ios_base::openmode mode) {
+	const off_type CURRENT = bufferStart + (gptr() - eback());
+	const off_type BASE = direction == std::ios_base::beg ? 0 :
+	                      direction == std::ios_base::cur ? CURRENT :
+	                      static_cast<off_type>(source->size());
+	return seekpos(BASE + offset, mode);
+}
+
+///@pkg ID3ByteSource.h
+ByteSourceStream::Buffer::pos_type ByteSourceStream::Buffer::seekpos(pos_type position, std::ios_base::openmode mode) {
+	const off_type POSITION = position;
+	if((mode & std::ios_base::in) == 0 || POSITION < 0 || static_cast<ulong>(POSITION) > source->size())
+		return pos_type(off_type(-1));
+	
+	//Keep the buffer if the position is in it
+	if(static_cast<ulong>(POSITION) >= bufferStart && static_cast<ulong>(POSITION) <= bufferStart + (egptr() - eback())) {
+		setg(eback(), eback() + (POSITION - bufferStart), egptr());
+	} else {
+		bufferStart = POSITION;
+		setg(buffer.data(), buffer.data(), buffer.data());
+	}
+	return position;
+}
@@ -0,0 +1,315 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_BYTE_SOURCE_HPP
+#define ID3_BYTE_SOURCE_HPP
+
+#include <functional> //For std::function
+#include <istream>    //For std::istream and std::streambuf
+#include <memory>     //For std::shared_ptr
+#include <string>     //For std::string
+#include <vector>     //For std::vector
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * @see ID3.h
+	 */
+	typedef std::vector<uint8_t> ByteArray;
+	
+	/**
+	 * ByteSource is the bytes of a music file, read by position. Reads don't
+	 * change any state, so one source can be read from many threads at once,
+	 * and shared between every object that reads from it.
+	 * 
+	 * ID3::Tag reads files through a ByteSource, so a tag can be read from a
+	 * file, a memory map, a buffer already in memory, or anything else that
+	 * can read bytes by position.
+	 * 
+	 * Defined in ID3ByteSource.cpp.
+	 * 
+	 * @see ID3::Tag::Tag(std::shared_ptr<const ByteSource>&)
+	 */
+	class ByteSource {
+		public:
+			virtual ~ByteSource();
+			
+			/**
+			 * @return The number of bytes in the source.
+			 */
+			virtual ulong size() const = 0;
+			
+			/**
+			 * Read bytes from a position. Fewer bytes are read if the source ends
+			 * first.
+			 * 
+			 * @param position The position to start reading from.
+			 * @param buffer   The buffer to read into.
+			 * @param bytes    The number of bytes to read.
+			 * @return The number of bytes read, which is 0 if the position is at
+			 *         or past the end, or there was an error.
+			 */
+			virtual size_t read(const ulong position, void* buffer, const size_t bytes) const = 0;
+	};
+	
+	/**
+	 * FileByteSource reads a file with pread(), without a file position, so
+	 * it can be read from many threads at once.
+	 * 
+	 * NOTE: The size is found when the source is created, so bytes appended
+	 *       to the file after that aren't read.
+	 */
+	class FileByteSource : public ByteSource {
+		public:
+			/**
+			 * Open a file.
+			 * 
+			 * @param fileLoc The file path.
+			 * @throws ID3::FileNotFoundException if the file can't be opened.
+			 */
+			explicit FileByteSource(const std::string& fileLoc);
+			
+			/**
+			 * Read from a file that's already open.
+			 * 
+			 * @param fd    The file descriptor.
+			 * @param owned If the file descriptor is closed with the source.
+			 * @throws ID3::FileNotFoundException if the file size can't be found.
+			 */
+			FileByteSource(const int fd, const bool owned=false);
+			
+			/**
+			 * Closes the file if the source owns it.
+			 */
+			virtual ~FileByteSource();
+			
+			FileByteSource(const FileByteSource&) = delete;
+			FileByteSource& operator=(const FileByteSource&) = delete;
+			
+			/** @see ID3::ByteSource::size() */
+			virtual ulong size() const;
+			
+			/** @see ID3::ByteSource::read(ulong, void*, size_t) */
+			virtual size_t read(const ulong position, void* buffer, const size_t bytes) const;
+		
+		private:
+			/**
+			 * The file descriptor.
+			 */
+			int fd;
+			
+			/**
+			 * If the file descriptor is closed with the source.
+			 */
+			bool owned;
+			
+			/**
+			 * The file size.
+			 */
+			ulong fileSize;
+	};
+	
+	/**
+	 * MappedByteSource maps a whole file into memory, so reads are copies from
+	 * the page cache without a system call.
+	 * 
+	 * NOTE: Reading from the map after the file is truncated by another
+	 *       process raises SIGBUS.
+	 */
+	class MappedByteSource : public ByteSource {
+		public:
+			/**
+			 * Map a file.
+			 * 
+			 * @param fileLoc The file path.
+			 * @throws ID3::FileNotFoundException if the file can't be opened or
+			 *         mapped.
+			 */
+			explicit MappedByteSource(const std::string& fileLoc);
+			
+			/**
+			 * Unmaps the file.
+			 */
+			virtual ~MappedByteSource();
+			
+			MappedByteSource(const MappedByteSource&) = delete;
+			MappedByteSource& operator=(const MappedByteSource&) = delete;
+			
+			/**
+			 * @return The mapped file, or nullptr for an empty file.
+			 */
+			const uint8_t* data() const;
+			
+			/** @see ID3::ByteSource::size() */
+			virtual ulong size() const;
+			
+			/** @see ID3::ByteSource::read(ulong, void*, size_t) */
+			virtual size_t read(const ulong position, void* buffer, const size_t bytes) const;
+		
+		private:
+			/**
+			 * The mapped file.
+			 */
+			const uint8_t* mapped;
+			
+			/**
+			 * The file size.
+			 */
+			ulong fileSize;
+	};
+	
+	/**
+	 * MemoryByteSource reads from bytes in memory, such as a file a service has
+	 * already downloaded.
+	 */
+	class MemoryByteSource : public ByteSource {
+		public:
+			/**
+			 * Read from bytes owned by someone else.
+			 * 
+			 * NOTE: The bytes must outlive the source.
+			 * 
+			 * @param data The bytes.
+			 * @param size The number of bytes.
+			 */
+			MemoryByteSource(const uint8_t* data, const size_t size);
+			
+			/**
+			 * Read from bytes owned by the source.
+			 * 
+			 * @param bytes The bytes, which are moved into the source.
+			 */
+			explicit MemoryByteSource(ByteArray&& bytes);
+			
+			/** @see ID3::ByteSource::size() */
+			virtual ulong size() const;
+			
+			/** @see ID3::ByteSource::read(ulong, void*, size_t) */
+			virtual size_t read(const ulong position, void* buffer, const size_t bytes) const;
+		
+		private:
+			/**
+			 * The bytes, if the source owns them.
+			 */
+			ByteArray ownedBytes;
+			
+			/**
+			 * The bytes.
+			 */
+			const uint8_t* bytesStart;
+			
+			/**
+			 * The number of bytes.
+			 */
+			size_t bytesSize;
+	};
+	
+	/**
+	 * CallbackByteSource reads with a function, such as one that reads from
+	 * object storage with range requests.
+	 */
+	class CallbackByteSource : public ByteSource {
+		public:
+			/**
+			 * The function that reads bytes, with the same parameters and return
+			 * value as ID3::ByteSource::read(). It can read fewer bytes than
+			 * asked for, and is called again for the rest until it returns 0.
+			 * It has to be safe to call from every thread the source is read
+			 * from.
+			 */
+			typedef std::function<size_t(const ulong position, void* buffer, const size_t bytes)> Reader;
+			
+			/**
+			 * Create a source.
+			 * 
+			 * @param size   The number of bytes in the source.
+			 * @param reader The function that reads bytes.
+			 */
+			CallbackByteSource(const ulong size, const Reader& reader);
+			
+			/** @see ID3::ByteSource::size() */
+			virtual ulong size() const;
+			
+			/** @see ID3::ByteSource::read(ulong, void*, size_t) */
+			virtual size_t read(const ulong position, void* buffer, const size_t bytes) const;
+		
+		private:
+			/**
+			 * The number of bytes in the source.
+			 */
+			ulong sourceSize;
+			
+			/**
+			 * The function that reads bytes.
+			 */
+			Reader reader;
+	};
+	
+	/**
+	 * ByteSourceStream is a buffered std::istream over a ByteSource, for the
+	 * readers that seek and read, such as ID3::ChunkIndex and
+	 * ID3::TrailingTags. Each stream has its own position and buffer, so
+	 * streams over the same source can be used on different threads.
+	 */
+	class ByteSourceStream : public std::istream {
+		public:
+			/**
+			 * Create a stream at the start of a source.
+			 * 
+			 * @param source     The source.
+			 * @param bufferSize The bytes read from the source at once.
+			 */
+			explicit ByteSourceStream(const std::shared_ptr<const ByteSource>& source, const size_t bufferSize=8192);
+			
+			/**
+			 * @return The source.
+			 */
+			const std::shared_ptr<const ByteSource>& source() const;
+		
+		private:
+			/**
+			 * The stream buffer, which refills from the source at the stream
+			 * position.
+			 */
+			class Buffer : public std::streambuf {
+				public:
+					Buffer(const std::shared_ptr<const ByteSource>& source, const size_t bufferSize);
+					const std::shared_ptr<const ByteSource> source; //The source
+				
+				protected:
+					virtual int_type underflow();
+					virtual std::streamsize xsgetn(char_type* s, std::streamsize count);
+					virtual pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode);
+					virtual pos_type seekpos(pos_type position, std::ios_base::openmode mode);
+				
+				private:
+					std::vector<char> buffer; //The buffered bytes
+					ulong bufferStart;        //The source position of the first buffered byte
+			};
+			
+			/**
+			 * The stream buffer.
+			 */
+			Buffer streamBuffer;
+	};
+}
+
+#endif
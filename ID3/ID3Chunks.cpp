@@ -0,0 +1,118 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <cstring> //For memcmp()
+
+#include "ID3Chunks.hpp"     //For the class definition
+#include "ID3Functions.hpp"  //For byteIntVal() and littleEndianIntVal()
+#include "ID3Constants.hpp"  //For CHUNK_HEADER_BYTE_SIZE
+#include "ID3IOThrottle.hpp" //For IOThrottle::charge()
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The size of the RIFF or FORM header: the form ID, the form size, and
+	 * the form type.
+	 */
+	static const ushort FORM_HEADER_SIZE = 12;
+}
+
+///@pkg ID3Chunks.h
+Chunk::Chunk(const std::string& id,
+             const ulong        start,
+             const ulong        size) : id(id),
+                                        start(start),
+                                        size(size) {}
+
+///@pkg ID3Chunks.h
+ulong Chunk::dataStart() const { return start + CHUNK_HEADER_BYTE_SIZE; }
+
+///@pkg ID3Chunks.h
+ulong Chunk::end() const { return dataStart() + size + (size & 1); }
+
+///@pkg ID3Chunks.h
+ChunkIndex::ChunkIndex() : format(ChunkContainer::NONE),
+                           id3ChunkIndex(0),
+                           formSizeVal(0),
+                           formEndPos(0) {}
+
+///@pkg ID3Chunks.h
+ChunkIndex::ChunkIndex(std::istream& file, const ulong fileSize) : ChunkIndex() {
+	if(fileSize < FORM_HEADER_SIZE) return;
+	
+	uint8_t formHeader[FORM_HEADER_SIZE];
+	file.clear();
+	file.seekg(0, std::ios_base::beg);
+	if(!file) return;
+	IOThrottle::charge(FORM_HEADER_SIZE);
+	file.read(reinterpret_cast<char*>(formHeader), FORM_HEADER_SIZE);
+	if(!file) return;
+	
+	//Get the container format from the form ID and type
+	if(memcmp(formHeader, "RIFF", 4) == 0)
+		format = ChunkContainer::RIFF;
+	else if(memcmp(formHeader, "FORM", 4) == 0 &&
+	        (memcmp(formHeader + 8, "AIFF", 4) == 0 || memcmp(formHeader + 8, "AIFC", 4) == 0))
+		format = ChunkContainer::AIFF;
+	else
+		return;
+	
+	formSizeVal = littleEndian() ? littleEndianIntVal(formHeader + 4, 4) : byteIntVal(formHeader + 4, 4);
+	formEndPos = CHUNK_HEADER_BYTE_SIZE + formSizeVal;
+	if(formEndPos > fileSize) formEndPos = fileSize;
+	
+	//Walk the chunk headers
+	ulong pos = FORM_HEADER_SIZE;
+	uint8_t chunkHeader[8];
+	while(pos + CHUNK_HEADER_BYTE_SIZE <= formEndPos) {
+		file.seekg(pos, std::ios_base::beg);
+		if(!file) break;
+		IOThrottle::charge(CHUNK_HEADER_BYTE_SIZE);
+		file.read(reinterpret_cast<char*>(chunkHeader), CHUNK_HEADER_BYTE_SIZE);
+		if(!file) break;
+		
+		const ulong size = littleEndian() ? littleEndianIntVal(chunkHeader + 4, 4) : byteIntVal(chunkHeader + 4, 4);
+		chunkList.emplace_back(std::string(reinterpret_cast<char*>(chunkHeader), 4), pos, size);
+		
+		//Remember the first ID3 chunk
+		if(id3ChunkIndex == 0 && (chunkList.back().id == "id3 " || chunkList.back().id == "ID3 "))
+			id3ChunkIndex = chunkList.size();
+		
+		pos = chunkList.back().end();
+	}
+	
+	//Make sure the ID3 chunk fits in the form
+	if(id3ChunkIndex != 0 && chunkList[id3ChunkIndex - 1].dataStart() + chunkList[id3ChunkIndex - 1].size > formEndPos)
+		id3ChunkIndex = 0;
+	
+	file.clear();
+}
+
+///@pkg ID3Chunks.h
+ChunkContainer ChunkIndex::container() const { return format; }
+
+///@pkg ID3Chunks.h
+bool ChunkIndex::littleEndian() const { return format == ChunkContainer::RIFF; }
+
+///@pkg ID3Chunks.h
+const std::vector<Chunk>& ChunkIndex::chunks() const { return chunkList; }
+
+///@pkg ID3Chunks.h
+const Chunk* ChunkIndex::id3Chunk() const { return id3ChunkIndex == 0 ? nullptr : &chunkList[id3ChunkIndex - 1]; }
+
+///@pkg ID3Chunks.h
+ulong ChunkIndex::formSize() const { return formSizeVal; }
+
+///@pkg ID3Chunks.h
+ulong ChunkIndex::formEnd() const { return formEndPos; }
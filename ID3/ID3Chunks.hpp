@@ -0,0 +1,147 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_CHUNKS_HPP
+#define ID3_CHUNKS_HPP
+
+#include <istream> //For std::istream
+#include <string>  //For std::string
+#include <vector>  //For std::vector
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * The chunk-based container formats that can hold an ID3v2 tag in a chunk.
+	 */
+	enum class ChunkContainer {
+		NONE, //Not a chunk-based file, the ID3v2 tag is at the start of the file
+		RIFF, //A RIFF file, such as WAV. Sizes are little-endian.
+		AIFF  //An AIFF or AIFF-C file. Sizes are big-endian.
+	};
+	
+	/**
+	 * A chunk header found in a RIFF or AIFF file.
+	 */
+	struct Chunk {
+		Chunk(const std::string& id, const ulong start, const ulong size);
+		std::string id; //The 4-character chunk ID
+		ulong start;    //The file position of the chunk header
+		ulong size;     //The size of the chunk data, without the header or pad byte
+		
+		/**
+		 * @return The file position of the chunk data.
+		 */
+		ulong dataStart() const;
+		
+		/**
+		 * @return The file position after the chunk data and its pad byte.
+		 */
+		ulong end() const;
+	};
+	
+	/**
+	 * ChunkIndex walks the top-level chunks of a RIFF (WAV) or AIFF file by
+	 * reading only the chunk headers, so the ID3 chunk can be found with one
+	 * read per chunk without touching the audio data.
+	 * 
+	 * NOTE: If the file is not a RIFF or AIFF file, the index will be empty
+	 *       and container() will return ChunkContainer::NONE.
+	 * 
+	 * Defined in ID3Chunks.cpp.
+	 */
+	class ChunkIndex {
+		public:
+			/**
+			 * Index the chunks of a file.
+			 * 
+			 * @param file     The file stream object.
+			 * @param fileSize The size of the file.
+			 */
+			ChunkIndex(std::istream& file, const ulong fileSize);
+			
+			/**
+			 * The empty constructor, for a file that isn't chunk-based.
+			 */
+			ChunkIndex();
+			
+			/**
+			 * @return The container format of the file.
+			 */
+			ChunkContainer container() const;
+			
+			/**
+			 * @return If the chunk sizes are little-endian (RIFF) instead of
+			 *         big-endian (AIFF).
+			 */
+			bool littleEndian() const;
+			
+			/**
+			 * @return The top-level chunks, in file order.
+			 */
+			const std::vector<Chunk>& chunks() const;
+			
+			/**
+			 * @return The ID3 chunk ("id3 " or "ID3 "), or nullptr if there is
+			 *         none.
+			 */
+			const Chunk* id3Chunk() const;
+			
+			/**
+			 * @return The size stated in the RIFF or FORM header.
+			 */
+			ulong formSize() const;
+			
+			/**
+			 * @return The file position right after the RIFF or FORM, capped at
+			 *         the file size. Any bytes after it are not part of the form.
+			 */
+			ulong formEnd() const;
+		
+		private:
+			/**
+			 * The container format.
+			 */
+			ChunkContainer format;
+			
+			/**
+			 * The top-level chunks.
+			 */
+			std::vector<Chunk> chunkList;
+			
+			/**
+			 * The position of the ID3 chunk in chunkList plus one, or 0 if there
+			 * is no ID3 chunk.
+			 */
+			size_t id3ChunkIndex;
+			
+			/**
+			 * The size in the form header.
+			 */
+			ulong formSizeVal;
+			
+			/**
+			 * The end of the form.
+			 */
+			ulong formEndPos;
+	};
+}
+
+#endif
@@ -0,0 +1,126 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include "ID3Compaction.hpp" //For the class definitions
+#include "ID3FrameID.hpp"    //For FRAME_TAGGING_TIME
+
+using namespace ID3;
+
+///@pkg ID3Compaction.h
+CompactionPolicy::CompactionPolicy() : smallestEncoding(true),
+                                       dedupePictures(true),
+                                       discardNonCoverPictures(false),
+                                       discardUnknown(false),
+                                       paddingFactor(0.1),
+                                       maxPadding(16384) {}
+
+///@pkg ID3Compaction.h
+WriteOptions CompactionPolicy::writeOptions() const {
+	WriteOptions options;
+	options.smallestEncoding        = smallestEncoding;
+	options.dedupePictures          = dedupePictures;
+	options.discardNonCoverPictures = discardNonCoverPictures;
+	options.discardUnknown          = discardUnknown;
+	options.paddingFactor           = paddingFactor;
+	options.maxPadding              = maxPadding;
+	return options;
+}
+
+///@pkg ID3Compaction.h
+CompactionReport::CompactionReport() : files(0),
+                                       changedFiles(0),
+                                       rewrittenFiles(0),
+                                       discardedFrames(0),
+                                       bytesBefore(0),
+                                       bytesAfter(0) {}
+
+///@pkg ID3Compaction.h
+void CompactionReport::add(const WriteResult& result, const bool changed) {
+	files++;
+	bytesBefore += result.oldSize;
+	if(changed) {
+		changedFiles++;
+		if(result.rewritten) rewrittenFiles++;
+		discardedFrames += result.discardedFrames;
+		bytesAfter += result.newSize();
+	} else {
+		bytesAfter += result.oldSize;
+	}
+}
+
+///@pkg ID3Compaction.h
+void CompactionReport::merge(const CompactionReport& other) {
+	files           += other.files;
+	changedFiles    += other.changedFiles;
+	rewrittenFiles  += other.rewrittenFiles;
+	discardedFrames += other.discardedFrames;
+	bytesBefore     += other.bytesBefore;
+	bytesAfter      += other.bytesAfter;
+	errors.insert(errors.end(), other.errors.begin(), other.errors.end());
+}
+
+///@pkg ID3Compaction.h
+long long CompactionReport::savedBytes() const {
+	return static_cast<long long>(bytesBefore) - static_cast<long long>(bytesAfter);
+}
+
+///@pkg ID3Compaction.h
+void CompactionReport::print(std::ostream& os) const {
+	os << "Files: " << files << " compacted, " << changedFiles << " changed, "
+	   << rewrittenFiles << " rewritten, " << errors.size() << " failed" << std::endl
+	   << "Discarded frames: " << discardedFrames << std::endl
+	   << "Tag bytes: " << bytesBefore << " before, " << bytesAfter << " after, "
+	   << savedBytes() << " saved" << std::endl;
+}
+
+///@pkg ID3Compaction.h
+WriteResult ID3::compact(const std::string&      fileLoc,
+                         const CompactionPolicy& policy,
+                         const bool              dryRun,
+                         bool*                   changed) {
+	Tag tag(fileLoc);
+	
+	//Keep the tagging time up to date if there is one, but don't add one
+	WriteOptions options = policy.writeOptions();
+	options.addTaggingTime = tag.exists(Frames::FRAME_TAGGING_TIME);
+	options.dryRun = true;
+	
+	//Only write the tags if they'll take up less space, or frames are discarded
+	WriteResult result = tag.write(fileLoc, options);
+	const bool write = result.newSize() < result.oldSize || result.discardedFrames > 0;
+	if(changed != nullptr) *changed = write;
+	if(write && !dryRun) {
+		options.dryRun = false;
+		result = tag.write(fileLoc, options);
+	}
+	
+	return result;
+}
+
+///@pkg ID3Compaction.h
+CompactionReport ID3::compact(const std::vector<std::string>& files,
+                              const CompactionPolicy&         policy,
+                              const bool                      dryRun,
+                              const BatchOptions&             options) {
+	const Batch batch(files, options);
+	std::vector<CompactionReport> workerReports(batch.workers());
+	const std::vector<BatchError> errors = batch.run([&](const size_t file, const unsigned worker) {
+		bool changed = false;
+		const WriteResult result = compact(files[file], policy, dryRun, &changed);
+		workerReports[worker].add(result, changed);
+	});
+	
+	CompactionReport report;
+	for(const CompactionReport& partial : workerReports) report.merge(partial);
+	report.errors = errors;
+	return report;
+}
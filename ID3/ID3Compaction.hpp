@@ -0,0 +1,148 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_COMPACTION_HPP
+#define ID3_COMPACTION_HPP
+
+#include <ostream> //For std::ostream
+#include <string>  //For std::string
+#include <vector>  //For std::vector
+
+#include "ID3.hpp"      //For WriteOptions and WriteResult
+#include "ID3Batch.hpp" //For BatchOptions and BatchError
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * How to compact the tags of a file.
+	 * 
+	 * Compacted tags are always written as ID3v2.4 without ID3v1 tags, so
+	 * ID3v2.2 and ID3v2.3 tags lose their older frame layouts, and ID3v1 tags
+	 * at the end of MP3 files are removed.
+	 * 
+	 * Defined in ID3Compaction.cpp.
+	 */
+	struct CompactionPolicy {
+		CompactionPolicy();
+		bool smallestEncoding;        //If every text frame is written in the encoding that takes the fewest bytes (true)
+		bool dedupePictures;          //If pictures with the same data as an earlier picture are discarded (true)
+		bool discardNonCoverPictures; //If all but the first front cover picture are discarded (false)
+		bool discardUnknown;          //If unknown frames are discarded (false)
+		float paddingFactor;          //The padding to add if the file is rewritten, as a fraction of the tag size (0.1)
+		ulong maxPadding;             //The most padding to leave in the tag, in bytes (16 KiB)
+		
+		/**
+		 * @return The write options for the policy.
+		 */
+		WriteOptions writeOptions() const;
+	};
+	
+	/**
+	 * The totals of compacting many files, which can be merged the same way
+	 * as ID3::TagStatistics.
+	 * 
+	 * Defined in ID3Compaction.cpp.
+	 */
+	struct CompactionReport {
+		CompactionReport();
+		
+		ulong files;                    //The number of files compacted
+		ulong changedFiles;             //The number of files whose tags were written
+		ulong rewrittenFiles;           //The number of files that were rewritten, or had their ID3 chunk moved
+		ulong discardedFrames;          //The number of frames that were discarded
+		ulong bytesBefore;              //The bytes the ID3 tags took up on file before compacting
+		ulong bytesAfter;               //The bytes the ID3 tags take up on file after compacting
+		std::vector<BatchError> errors; //The files that couldn't be compacted
+		
+		/**
+		 * Add the result of compacting a file.
+		 * 
+		 * @param result  The write result.
+		 * @param changed If the tags were written.
+		 */
+		void add(const WriteResult& result, const bool changed);
+		
+		/**
+		 * Add the totals of other files.
+		 * 
+		 * NOTE: The errors are appended without being sorted.
+		 * 
+		 * @param other The other report.
+		 */
+		void merge(const CompactionReport& other);
+		
+		/**
+		 * @return The bytes that compacting saved, or would save for a dry
+		 *         run. This is negative if the tags grew.
+		 */
+		long long savedBytes() const;
+		
+		/**
+		 * Print the report in a human-readable form.
+		 * 
+		 * @param os The output stream.
+		 */
+		void print(std::ostream& os) const;
+	};
+	
+	/**
+	 * Compact the tags of a file under a policy.
+	 * 
+	 * A dry run of the write is done first, and the tags are only written if
+	 * they would take up fewer bytes on file or a frame would be discarded,
+	 * so files that are already compact aren't touched. The write is in place
+	 * unless the file has ID3v1 tags, the tag doesn't fit, or writing in place
+	 * would leave more than the policy's maximum padding.
+	 * 
+	 * @param fileLoc The file path.
+	 * @param policy  The compaction policy.
+	 * @param dryRun  If true, the file isn't changed, and the result is an
+	 *                estimate of what compacting would do.
+	 * @param changed Set to whether the tags were written, or would be
+	 *                written for a dry run (optional).
+	 * @return What compacting the file did.
+	 * @throws The same exceptions as the ID3::Tag::Tag(std::string&) and
+	 *         ID3::Tag::write(std::string&, WriteOptions&) methods.
+	 */
+	WriteResult compact(const std::string&      fileLoc,
+	                    const CompactionPolicy& policy=CompactionPolicy(),
+	                    const bool              dryRun=false,
+	                    bool*                   changed=nullptr);
+	
+	/**
+	 * Compact the tags of many files in parallel. Each worker keeps its own
+	 * report, which are merged once every file is done.
+	 * 
+	 * @param files   The file paths.
+	 * @param policy  The compaction policy.
+	 * @param dryRun  If true, the files aren't changed, and the report is an
+	 *                estimate of what compacting would do.
+	 * @param options The batch options.
+	 * @return The report of all of the files.
+	 * @see ID3::compact(std::string&, CompactionPolicy&, bool, bool*)
+	 */
+	CompactionReport compact(const std::vector<std::string>& files,
+	                         const CompactionPolicy&         policy,
+	                         const bool                      dryRun=false,
+	                         const BatchOptions&             options=BatchOptions());
+}
+
+#endif
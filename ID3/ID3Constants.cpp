@@ -45,6 +45,12 @@ const uint8_t ID3::FLAG_FOOTER =            0b00010000;
 ///@pkg ID3.h
 const ulong ID3::MAX_TAG_SIZE = (1UL << 28) - 1;
 
+///@pkg ID3.h
+const ulong ID3::TRAILING_TAG_READ_SIZE = 64 * 1024;
+
+///@pkg ID3.h
+const ushort ID3::CHUNK_HEADER_BYTE_SIZE = 8;
+
 ///@pkg ID3.h
 const std::vector<std::string> ID3::V1::GENRES = {
 	"Blues",               //0
@@ -98,6 +98,19 @@ namespace ID3 {
 	 * The value is therefore 2^28 - 1, ~268MB, or ~256MiB.
 	 */
 	extern const ulong MAX_TAG_SIZE;
+	
+	/**
+	 * The number of bytes read from the end of a file to find the ID3v1,
+	 * APEv2, and Lyrics3 tags that follow the audio data. Blocks that extend
+	 * past this range will need an additional read.
+	 */
+	extern const ulong TRAILING_TAG_READ_SIZE;
+	
+	/**
+	 * The number of bytes used in a RIFF or AIFF chunk header (a 4-character
+	 * chunk ID and a 4-byte size).
+	 */
+	extern const ushort CHUNK_HEADER_BYTE_SIZE;
 }
 
 #endif
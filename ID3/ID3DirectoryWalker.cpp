@@ -0,0 +1,326 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <condition_variable> //For std::condition_variable
+#include <cstring>            //For strlen()
+#include <deque>              //For std::deque
+#include <exception>          //For std::exception_ptr
+#include <mutex>              //For std::mutex
+#include <set>                //For std::set
+#include <thread>             //For std::thread
+#include <utility>            //For std::pair
+
+#include <dirent.h>   //For opendir(), readdir(), and the DT_ file types
+#include <fcntl.h>    //For open() and AT_SYMLINK_NOFOLLOW
+#include <sys/stat.h> //For fstatat()
+#include <unistd.h>   //For close()
+#ifdef __linux__
+#include <sys/syscall.h> //For SYS_getdents64
+#endif
+
+#include "ID3DirectoryWalker.hpp" //For the class definition
+#include "ID3Functions.hpp"       //For supportedFileType()
+#include "ID3Exception.hpp"       //For FileNotFoundException
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The size of the buffer getdents64 reads directory entries into.
+	 */
+	const size_t DIRECTORY_BUFFER_SIZE = 64 * 1024;
+	
+	/**
+	 * The most batches run() lets the walk get ahead of the workers.
+	 */
+	const size_t BATCHES_AHEAD = 4;
+	
+	#ifdef __linux__
+	/**
+	 * A directory entry returned by getdents64.
+	 */
+	struct Dirent64 {
+		uint64_t d_ino;          //The inode number
+		int64_t d_off;           //The offset to the next entry
+		unsigned short d_reclen; //The size of the entry
+		unsigned char d_type;    //The file type
+		char d_name[1];          //The null-terminated name
+	};
+	#endif
+	
+	/**
+	 * The state of a walk.
+	 */
+	struct Walk {
+		const WalkOptions& options;                    //The walk options
+		const DirectoryWalker::Callback& callback;     //The callback
+		std::vector<std::string> paths;                //The batch of paths found so far
+		ulong found;                                   //The number of paths found so far
+		std::set<std::pair<dev_t, ino_t>> directories; //The directories walked, to stop symbolic link loops
+	};
+	
+	/**
+	 * Check if a name is included by the walk options.
+	 * 
+	 * @param options   The walk options.
+	 * @param name      The file or directory name.
+	 * @param directory If the name is a directory.
+	 * @return If it's included.
+	 */
+	bool included(const WalkOptions& options, const char* name, const bool directory) {
+		for(const std::string& glob : options.exclude)
+			if(DirectoryWalker::globMatch(glob.c_str(), name)) return false;
+		if(directory || options.include.empty()) return true;
+		for(const std::string& glob : options.include)
+			if(DirectoryWalker::globMatch(glob.c_str(), name)) return true;
+		return false;
+	}
+	
+	/**
+	 * Walk a directory.
+	 * 
+	 * @param walk The walk state.
+	 * @param path The path of the directory, ending with a slash.
+	 * @return If the directory could be opened.
+	 */
+	bool walkDirectory(Walk& walk, const std::string& path) {
+		#ifdef __linux__
+		const int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if(fd < 0) return false;
+		#else
+		DIR* const dir = opendir(path.c_str());
+		if(dir == nullptr) return false;
+		const int fd = dirfd(dir);
+		#endif
+		
+		//Don't walk a directory twice through symbolic links
+		if(walk.options.followSymlinks) {
+			struct stat dirStat;
+			if(fstat(fd, &dirStat) != 0 || !walk.directories.emplace(dirStat.st_dev, dirStat.st_ino).second) {
+				#ifdef __linux__
+				close(fd);
+				#else
+				closedir(dir);
+				#endif
+				return true;
+			}
+		}
+		
+		//Subdirectories are walked once this directory is closed, so only one
+		//directory is open at a time
+		std::vector<std::string> subdirectories;
+		
+		const auto entry = [&](const char* name, unsigned char type) {
+			//Skip . and .., and hidden files if they aren't walked
+			if(name[0] == '.' && (!walk.options.hidden || name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+				return;
+			
+			//Files that can't be read are skipped before anything else
+			const size_t LENGTH = strlen(name);
+			if(type == DT_REG && !walk.options.allFiles && !supportedFileType(name, LENGTH)) return;
+			
+			//Only stat the file if its type isn't known, or to follow a link
+			if(type == DT_UNKNOWN || (type == DT_LNK && walk.options.followSymlinks)) {
+				struct stat fileStat;
+				if(fstatat(fd, name, &fileStat, walk.options.followSymlinks ? 0 : AT_SYMLINK_NOFOLLOW) != 0) return;
+				type = S_ISDIR(fileStat.st_mode) ? DT_DIR : S_ISREG(fileStat.st_mode) ? DT_REG : DT_UNKNOWN;
+			}
+			
+			if(type == DT_DIR) {
+				if(walk.options.recursive && included(walk.options, name, true)) subdirectories.emplace_back(name);
+				return;
+			}
+			if(type != DT_REG) return;
+			if(!walk.options.allFiles && !supportedFileType(name, LENGTH)) return;
+			if(!included(walk.options, name, false)) return;
+			
+			walk.paths.push_back(path + name);
+			walk.found++;
+			if(walk.paths.size() >= walk.options.batchSize) {
+				walk.callback(walk.paths);
+				walk.paths.clear();
+			}
+		};
+		
+		#ifdef __linux__
+		//Read as many entries as fit in the buffer with each system call
+		std::vector<char> buffer(DIRECTORY_BUFFER_SIZE);
+		long bytes;
+		while((bytes = syscall(SYS_getdents64, fd, &buffer.front(), buffer.size())) > 0) {
+			for(long pos = 0; pos < bytes;) {
+				const Dirent64* const dirent = reinterpret_cast<const Dirent64*>(&buffer[pos]);
+				pos += dirent->d_reclen;
+				entry(dirent->d_name, dirent->d_type);
+			}
+		}
+		close(fd);
+		#else
+		for(const dirent* dirent = readdir(dir); dirent != nullptr; dirent = readdir(dir))
+			entry(dirent->d_name, dirent->d_type);
+		closedir(dir);
+		#endif
+		
+		for(const std::string& subdirectory : subdirectories)
+			walkDirectory(walk, path + subdirectory + '/');
+		return true;
+	}
+}
+
+///@pkg ID3DirectoryWalker.h
+WalkOptions::WalkOptions() : recursive(true),
+                             followSymlinks(false),
+                             hidden(false),
+                             allFiles(false),
+                             batchSize(1024) {}
+
+///@pkg ID3DirectoryWalker.h
+DirectoryWalker::DirectoryWalker(const std::string& root, const WalkOptions& options) : rootPath(root),
+                                                                                        walkOptions(options) {}
+
+///@pkg ID3DirectoryWalker.h
+ulong DirectoryWalker::walk(const Callback& callback) const {
+	Walk walk = {walkOptions, callback, std::vector<std::string>(), 0, std::set<std::pair<dev_t, ino_t>>()};
+	
+	//Paths are built by appending names to the directory path
+	std::string root = rootPath.empty() ? "." : rootPath;
+	if(root.back() != '/') root += '/';
+	
+	if(!walkDirectory(walk, root))
+		throw FileNotFoundException("Directory \"" + rootPath + "\" cannot be opened!\n");
+	if(!walk.paths.empty()) callback(walk.paths);
+	return walk.found;
+}
+
+///@pkg ID3DirectoryWalker.h
+std::vector<BatchError> DirectoryWalker::run(const std::function<void(const std::string& path, const unsigned worker)>& task,
+                                             const BatchOptions& batchOptions) const {
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::deque<std::vector<std::string>> batches;
+	bool done = false;
+	std::exception_ptr walkError;
+	
+	//Walk on another thread, waiting whenever it gets too far ahead
+	std::thread walker([&]() {
+		try {
+			walk([&](const std::vector<std::string>& paths) {
+				std::unique_lock<std::mutex> lock(mutex);
+				changed.wait(lock, [&]() { return batches.size() < BATCHES_AHEAD; });
+				batches.push_back(paths);
+				changed.notify_all();
+			});
+		} catch(...) {
+			walkError = std::current_exception();
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		done = true;
+		changed.notify_all();
+	});
+	
+	//Run each batch as it's found
+	std::vector<BatchError> errors;
+	ulong walked = 0;
+	while(true) {
+		std::vector<std::string> paths;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [&]() { return !batches.empty() || done; });
+			if(batches.empty()) break;
+			paths.swap(batches.front());
+			batches.pop_front();
+			changed.notify_all();
+		}
+		
+		const Batch batch(paths, batchOptions);
+		for(BatchError& error : batch.run([&](const size_t file, const unsigned worker) { task(paths[file], worker); })) {
+			error.file += walked;
+			errors.push_back(error);
+		}
+		walked += paths.size();
+	}
+	
+	walker.join();
+	if(walkError) std::rethrow_exception(walkError);
+	return errors;
+}
+
+///@pkg ID3DirectoryWalker.h
+std::vector<std::string> DirectoryWalker::list() const {
+	std::vector<std::string> files;
+	walk([&files](const std::vector<std::string>& paths) {
+		files.insert(files.end(), paths.begin(), paths.end());
+	});
+	return files;
+}
+
+///@pkg ID3DirectoryWalker.h
+bool DirectoryWalker::globMatch(const char* glob, const char* name) {
+	//The position to go back to after a * fails to match
+	const char* starGlob = nullptr;
+	const char* starName = nullptr;
+	
+	while(*name != '\0') {
+		if(*glob == '*') {
+			starGlob = ++glob;
+			starName = name;
+			continue;
+		}
+		
+		bool matched = false;
+		if(*glob == '?') {
+			matched = true;
+			glob++;
+		} else if(*glob == '[') {
+			//Match a character class, such as [a-z] or [!0-9]
+			const char* end = glob + 1;
+			if(*end == '!') end++;
+			if(*end == ']') end++;
+			while(*end != '\0' && *end != ']') end++;
+			if(*end == ']') {
+				const bool negate = glob[1] == '!';
+				bool inClass = false;
+				for(const char* c = glob + (negate ? 2 : 1); c < end; c++) {
+					if(c + 2 < end && c[1] == '-') {
+						if(*name >= c[0] && *name <= c[2]) inClass = true;
+						c += 2;
+					} else if(*name == *c) {
+						inClass = true;
+					}
+				}
+				matched = inClass != negate;
+				glob = end + 1;
+			} else {
+				//An unclosed [ is matched literally
+				matched = *name == '[';
+				glob++;
+			}
+		} else if(*glob != '\0' && *glob == *name) {
+			matched = true;
+			glob++;
+		}
+		
+		if(matched) {
+			name++;
+		} else if(starGlob != nullptr) {
+			//Let the last * take one more character
+			glob = starGlob;
+			name = ++starName;
+		} else {
+			return false;
+		}
+	}
+	
+	//Only trailing *s can match the end of the name
+	while(*glob == '*') glob++;
+	return *glob == '\0';
+}
@@ -0,0 +1,144 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_DIRECTORY_WALKER_HPP
+#define ID3_DIRECTORY_WALKER_HPP
+
+#include <functional> //For std::function
+#include <string>     //For std::string
+#include <vector>     //For std::vector
+
+#include "ID3Batch.hpp" //For BatchOptions and BatchError
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * Options for walking a directory.
+	 */
+	struct WalkOptions {
+		WalkOptions();
+		bool recursive;                   //If subdirectories are walked (true)
+		bool followSymlinks;              //If symbolic links to files and directories are followed (false)
+		bool hidden;                      //If files and directories starting with a dot are walked (false)
+		bool allFiles;                    //If files of every type are listed, not just those ID3::Tag can read (false)
+		std::vector<std::string> include; //Globs a file name has to match one of to be listed, or empty to list every file
+		std::vector<std::string> exclude; //Globs of file and directory names to skip. Skipped directories aren't walked
+		size_t batchSize;                 //The number of paths handed to the callback at once (1024)
+	};
+	
+	/**
+	 * DirectoryWalker lists the files in a directory tree that ID3::Tag can
+	 * read, without opening or stat-ing them.
+	 * 
+	 * On Linux, directories are read with the getdents64 system call into a
+	 * large buffer, and the file type comes from the entry itself, so a file
+	 * is only stat-ed if the file system doesn't store its type, or if it's a
+	 * symbolic link that is followed. Names are checked against the supported
+	 * extensions with ID3::supportedFileType(), then against the include and
+	 * exclude globs, before the path is built. Other systems use readdir().
+	 * 
+	 * Paths are handed over in batches as they are found, so tags can be read
+	 * while the rest of the tree is still being walked.
+	 * 
+	 * Globs support * (any characters), ? (any one character), and [...]
+	 * (one of the characters, with ranges such as a-z and ! to negate). They
+	 * are matched against the name only, not the whole path, and are case
+	 * sensitive.
+	 * 
+	 * NOTE: Directories that can't be opened are skipped.
+	 * 
+	 * Defined in ID3DirectoryWalker.cpp.
+	 */
+	class DirectoryWalker {
+		public:
+			/**
+			 * The function given each batch of paths.
+			 * 
+			 * @param paths The paths, in the order they were found.
+			 */
+			typedef std::function<void(const std::vector<std::string>& paths)> Callback;
+			
+			/**
+			 * Create a walker.
+			 * 
+			 * @param root    The directory to walk.
+			 * @param options The walk options.
+			 */
+			DirectoryWalker(const std::string& root, const WalkOptions& options=WalkOptions());
+			
+			/**
+			 * Walk the directory tree, and call the callback with every batch of
+			 * paths.
+			 * 
+			 * @param callback The callback.
+			 * @return The number of paths found.
+			 * @throws ID3::FileNotFoundException if the root directory can't be
+			 *         opened.
+			 */
+			ulong walk(const Callback& callback) const;
+			
+			/**
+			 * Walk the directory tree, and run a task over every path on a pool
+			 * of worker threads, one batch of paths at a time. The tree is
+			 * walked on its own thread, a few batches ahead of the workers.
+			 * 
+			 * @param task         The task, which is given each path and the
+			 *                     worker number.
+			 * @param batchOptions The batch options.
+			 * @return The paths the task threw an exception on, with the
+			 *         position of the path in the walk.
+			 * @throws ID3::FileNotFoundException if the root directory can't be
+			 *         opened.
+			 * @see ID3::Batch::run(Task&)
+			 */
+			std::vector<BatchError> run(const std::function<void(const std::string& path, const unsigned worker)>& task,
+			                            const BatchOptions& batchOptions=BatchOptions()) const;
+			
+			/**
+			 * @return Every path in the directory tree.
+			 * @throws ID3::FileNotFoundException if the root directory can't be
+			 *         opened.
+			 */
+			std::vector<std::string> list() const;
+			
+			/**
+			 * Check if a name matches a glob.
+			 * 
+			 * @param glob The glob.
+			 * @param name The name.
+			 * @return If the name matches.
+			 */
+			static bool globMatch(const char* glob, const char* name);
+		
+		private:
+			/**
+			 * The root directory.
+			 */
+			std::string rootPath;
+			
+			/**
+			 * The walk options.
+			 */
+			WalkOptions walkOptions;
+	};
+}
+
+#endif
@@ -10,6 +10,8 @@
  * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
  **********************************************************************/
 
+#include <cstring> //For memcpy()
+
 #include "ID3FrameFactory.hpp"            //For the class definition
 #include "Frames/ID3TextFrame.hpp"        //For TextFrame
 #include "Frames/ID3PictureFrame.hpp"     //For PictureFrame and PictureType
@@ -17,41 +19,39 @@
 #include "Frames/ID3EventTimingFrame.hpp" //For EventTimingFrame
 #include "ID3Functions.hpp"               //For translating numbers from char arrays to ints and vice verse
 #include "ID3Constants.hpp"               //For constants such as HEADER_BYTE_SIZE
+#include "ID3IOThrottle.hpp"              //For IOThrottle::charge()
 
 using namespace ID3;
 
 ///@pkg ID3FrameFactory.h
-FrameFactory::FrameFactory(std::istream&  file,
-                           const ushort   version,
-                           const ulong    tagEnd) : musicFile(&file),
-                                                    ID3Ver(version),
-                                                    ID3Size(tagEnd) {}
+FrameFactory::FrameFactory(const std::shared_ptr<const ByteSource>& source,
+                           const ushort                             version,
+                           const ulong                              tagEnd) : source(source),
+                                                                              ID3Ver(version),
+                                                                              ID3Size(tagEnd) {}
 
 ///@pkg ID3FrameFactory.h	                                              
-FrameFactory::FrameFactory(const ushort version) : musicFile(nullptr),
+FrameFactory::FrameFactory(const ushort version) : source(nullptr),
                                                    ID3Ver(version),
                                                    ID3Size(0) {}
 
 ///@pkg ID3FrameFactory.h	                                              
-FrameFactory::FrameFactory() : musicFile(nullptr),
+FrameFactory::FrameFactory() : source(nullptr),
                                ID3Ver(WRITE_VERSION),
                                ID3Size(0) {}
 
 ///@pkg ID3FrameFactory.h
 FramePtr FrameFactory::create(const ulong readpos) const {
-	//Validate the file
-	if(readpos + HEADER_BYTE_SIZE > ID3Size || musicFile == nullptr || !musicFile->good())
+	//Validate the read position
+	if(readpos + HEADER_BYTE_SIZE > ID3Size || source == nullptr)
 		return FramePtr(new UnknownFrame());
 	
-	//Seek to the read position
-	musicFile->seekg(readpos, std::ifstream::beg);
-	if(musicFile->fail()) return FramePtr(new UnknownFrame());
-	
 	//The Frame class that should be returned
 	FrameClass frameType;
 	
-	//The ByteArray of the frame's bytes read from the file
-	ByteArray frameBytes;
+	//The frame's bytes read from the file, which small frames store without
+	//allocating memory
+	SmallByteArray frameBytes;
 	
 	//The ID3v2 frame ID that will be read from file
 	FrameID id;
@@ -61,13 +61,16 @@ FramePtr FrameFactory::create(const ulong readpos) const {
 	if(ID3Ver >= 3) {
 		//Read the frame header
 		FrameHeader header;
-		musicFile->read(reinterpret_cast<char*>(&header), HEADER_BYTE_SIZE);
+		IOThrottle::charge(HEADER_BYTE_SIZE);
+		if(source->read(readpos, &header, HEADER_BYTE_SIZE) != HEADER_BYTE_SIZE)
+			return FramePtr(new UnknownFrame());
 		
 		//Get the size of the frame
 		ulong frameSize = byteIntVal(header.size, 4, ID3Ver >= 4);
 		
-		//Validate the frame size
-		if(frameSize == 0 || frameSize + HEADER_BYTE_SIZE > ID3Size)
+		//Validate the frame size. The frame has to end by the end of the tag, so
+		//that a hostile size can't make the frame read past it.
+		if(frameSize == 0 || readpos + HEADER_BYTE_SIZE + frameSize > ID3Size)
 			return FramePtr(new UnknownFrame());
 		
 		//Get the frame ID
@@ -76,24 +79,28 @@ FramePtr FrameFactory::create(const ulong readpos) const {
 		//Get the class the Frame should be
 		frameType = FrameFactory::frameType(id);
 		
-		//Create the ByteArray with the entire frame contents
-		frameBytes = ByteArray(frameSize + HEADER_BYTE_SIZE, '\0');
-		musicFile->seekg(readpos, std::ifstream::beg);
-		if(musicFile->fail()) return FramePtr(new UnknownFrame(id));
-		musicFile->read(reinterpret_cast<char*>(&frameBytes.front()), frameSize + HEADER_BYTE_SIZE);
+		//Create the SmallByteArray with the entire frame contents, reading the rest
+		//of the frame after the header that was already read
+		frameBytes = SmallByteArray(frameSize + HEADER_BYTE_SIZE, '\0');
+		memcpy(&frameBytes.front(), &header, HEADER_BYTE_SIZE);
+		IOThrottle::charge(frameSize);
+		if(source->read(readpos + HEADER_BYTE_SIZE, &frameBytes[HEADER_BYTE_SIZE], frameSize) != frameSize)
+			return FramePtr(new UnknownFrame(id));
 	} else {
 		//The ID3v2.2 frame header has 6 bytes instead of 10
 		const ushort OLD_FRAME_HEADER_BYTE_SIZE = sizeof(V2FrameHeader);
 		
 		//Read the frame header
 		V2FrameHeader header;
-		musicFile->read(reinterpret_cast<char*>(&header), OLD_FRAME_HEADER_BYTE_SIZE);
+		IOThrottle::charge(OLD_FRAME_HEADER_BYTE_SIZE);
+		if(source->read(readpos, &header, OLD_FRAME_HEADER_BYTE_SIZE) != OLD_FRAME_HEADER_BYTE_SIZE)
+			return FramePtr(new UnknownFrame());
 		
 		//Get the size of the frame
 		ulong frameSize = byteIntVal(header.size, 3, false);
 		
-		//Validate the frame size
-		if(frameSize == 0 || frameSize + OLD_FRAME_HEADER_BYTE_SIZE > ID3Size)
+		//Validate the frame size. The frame has to end by the end of the tag.
+		if(frameSize == 0 || readpos + OLD_FRAME_HEADER_BYTE_SIZE + frameSize > ID3Size)
 			return FramePtr(new UnknownFrame());
 		
 		//Get the ID3v2.2 frame ID, and then convert it to its ID3v2.4 equivalent
@@ -102,14 +109,15 @@ FramePtr FrameFactory::create(const ulong readpos) const {
 		//Get the class the Frame should be
 		frameType = FrameFactory::frameType(id);
 		
-		//Create the ByteArray with room for the entire frame content, if it were
+		//Create the SmallByteArray with room for the entire frame content, if it were
 		//a new ID3v2 tag
-		frameBytes = ByteArray(frameSize + HEADER_BYTE_SIZE, '\0');
-		musicFile->seekg(readpos, std::ifstream::beg);
-		if(musicFile->fail()) return FramePtr(new UnknownFrame(id));
+		frameBytes = SmallByteArray(frameSize + HEADER_BYTE_SIZE, '\0');
 		
-		//Get the frame bytes, reserving the first four bytes in the ByteArray
-		musicFile->read(reinterpret_cast<char*>(&frameBytes.front()+4), frameSize + OLD_FRAME_HEADER_BYTE_SIZE);
+		//Get the frame bytes, reserving the first four bytes in the SmallByteArray
+		memcpy(&frameBytes[4], &header, OLD_FRAME_HEADER_BYTE_SIZE);
+		IOThrottle::charge(frameSize);
+		if(source->read(readpos + OLD_FRAME_HEADER_BYTE_SIZE, &frameBytes[HEADER_BYTE_SIZE], frameSize) != frameSize)
+			return FramePtr(new UnknownFrame(id));
 		
 		//===========================================
 		//Reconstruct the header as an ID3v2.4 header
@@ -13,7 +13,6 @@
 #ifndef ID3_FRAME_FACTORY_HPP
 #define ID3_FRAME_FACTORY_HPP
 
-#include <fstream>       //For std::ifstream
 #include <string>        //For std::string
 #include <unordered_map> //For std::unordered_map and std::pair
 #include <memory>        //For std::shared_ptr
@@ -21,6 +20,7 @@
 #include "Frames/ID3Frame.hpp"        //For the Frame class
 #include "Frames/ID3PictureFrame.hpp" //For the PictureType enum
 #include "ID3FrameID.hpp"             //For the FrameID class
+#include "ID3ByteSource.hpp"          //For ByteSource
 
 /**
  * The ID3 namespace defines everything related to reading and writing
@@ -59,9 +59,9 @@ namespace ID3 {
 	 * it will be treated as ID3::MIN_SUPPORTED_VERSION if smaller or
 	 * ID3::MAX_SUPPORTED_VERSION if bigger.
 	 * 
-	 * NOTE: Although a FrameFactory object holds an fstream file object, it will
-	 * not close the file upon destruction. You must close the file manually,
-	 * after you are finished with the FrameFactory object.
+	 * NOTE: Frames are read from a shared ByteSource by position, so a
+	 * FrameFactory keeps its source alive, and copies of it can create frames
+	 * on different threads at once.
 	 */
 	class FrameFactory {
 		protected:
@@ -70,15 +70,15 @@ namespace ID3 {
 			/**
 			 * The protected constructor to create a FrameFactory.
 			 * 
-			 * @param file    An fstream file object.
+			 * @param source  The bytes of the file.
 			 * @param version The ID3 major version to use.
 			 * @param tagEnd  The byte position that the ID3v2 tags end on. It is
 			 *                assumed that the tag size has already been checked to
 			 *                be smaller than the filesize.
 			 */
-			FrameFactory(std::istream&  file,
-			             const ushort   version,
-			             const ulong    tagEnd);
+			FrameFactory(const std::shared_ptr<const ByteSource>& source,
+			             const ushort                             version,
+			             const ulong                              tagEnd);
 			
 			/**
 			 * The empty constructor.
@@ -94,8 +94,7 @@ namespace ID3 {
 			 * Creates a Frame by reading from the given position on the file
 			 * passed in the constructor.
 			 * 
-			 * NOTE: The passed file object must not be closed or null, and the
-			 *       FrameFactory must not have been created with the empty
+			 * NOTE: The FrameFactory must not have been created with the empty
 			 *       constructor, or a "null" UnknownFrame will be returned. The
 			 *       read position must also be smaller than the ID3v2 tag size.
 			 * 
@@ -331,9 +330,9 @@ namespace ID3 {
 			static ushort frameOptions(const FrameID& frameID);
 			
 			/**
-			 * A pointer to the istream object given in the protected constructor.
+			 * The bytes of the file given in the protected constructor.
 			 */
-			std::istream* musicFile;
+			std::shared_ptr<const ByteSource> source;
 			
 			/**
 			 * The ID3v2 major version given in the constructor.
@@ -0,0 +1,120 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm> //For std::find()
+
+#include "ID3FrameView.hpp"             //For the class definitions
+#include "Frames/ID3TextFrame.hpp"      //For TextFrame and DescriptiveTextFrame
+#include "Frames/ID3PlayCountFrame.hpp" //For PlayCountFrame and PopularimeterFrame
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * Returned by FrameView getters for frames without the field.
+	 */
+	const std::string EMPTY_STRING;
+	const ByteArray EMPTY_BYTES;
+}
+
+///@pkg ID3FrameView.h
+FrameFilter::FrameFilter() : classes(0) {}
+
+///@pkg ID3FrameView.h
+FrameFilter::FrameFilter(std::initializer_list<FrameClass> frameClasses) : classes(0) {
+	for(const FrameClass frameClass : frameClasses)
+		classes |= 1 << frameClass;
+}
+
+///@pkg ID3FrameView.h
+FrameFilter::FrameFilter(std::initializer_list<FrameID> frameIDs) : classes(0),
+                                                                     ids(frameIDs) {}
+
+///@pkg ID3FrameView.h
+bool FrameFilter::matches(const Frame& frame) const {
+	if(classes != 0 && (classes & (1 << frame.type())) == 0)
+		return false;
+	return ids.empty() || std::find(ids.begin(), ids.end(), frame.frame()) != ids.end();
+}
+
+///@pkg ID3FrameView.h
+FrameView::FrameView(const Frame& frame) : viewFrame(&frame),
+                                           frameClass(frame.type()) {}
+
+///@pkg ID3FrameView.h
+const std::string& FrameView::text() const {
+	switch(frameClass) {
+		case FrameClass::CLASS_TEXT:
+		case FrameClass::CLASS_NUMERICAL:
+		case FrameClass::CLASS_DESCRIPTIVE:
+		case FrameClass::CLASS_URL:
+			return dynamic_cast<const TextFrame&>(*viewFrame).content();
+		default:
+			return EMPTY_STRING;
+	}
+}
+
+///@pkg ID3FrameView.h
+const std::string& FrameView::description() const {
+	switch(frameClass) {
+		case FrameClass::CLASS_DESCRIPTIVE:
+			return dynamic_cast<const DescriptiveTextFrame&>(*viewFrame).description();
+		case FrameClass::CLASS_PICTURE:
+			return dynamic_cast<const PictureFrame&>(*viewFrame).description();
+		default:
+			return EMPTY_STRING;
+	}
+}
+
+///@pkg ID3FrameView.h
+const std::string& FrameView::language() const {
+	if(frameClass != FrameClass::CLASS_DESCRIPTIVE) return EMPTY_STRING;
+	return dynamic_cast<const DescriptiveTextFrame&>(*viewFrame).language();
+}
+
+///@pkg ID3FrameView.h
+const ByteArray& FrameView::picture() const {
+	if(frameClass != FrameClass::CLASS_PICTURE) return EMPTY_BYTES;
+	return dynamic_cast<const PictureFrame&>(*viewFrame).picture();
+}
+
+///@pkg ID3FrameView.h
+const std::string& FrameView::mimeType() const {
+	if(frameClass != FrameClass::CLASS_PICTURE) return EMPTY_STRING;
+	return dynamic_cast<const PictureFrame&>(*viewFrame).mimeType();
+}
+
+///@pkg ID3FrameView.h
+PictureType FrameView::pictureType() const {
+	if(frameClass != FrameClass::CLASS_PICTURE) return PictureType::OTHER;
+	return dynamic_cast<const PictureFrame&>(*viewFrame).pictureType();
+}
+
+///@pkg ID3FrameView.h
+unsigned long long FrameView::playCount() const {
+	if(frameClass != FrameClass::CLASS_PLAY_COUNT && frameClass != FrameClass::CLASS_POPULARIMETER)
+		return 0ULL;
+	return dynamic_cast<const PlayCountFrame&>(*viewFrame).playCount();
+}
+
+///@pkg ID3FrameView.h
+ushort FrameView::rating() const {
+	if(frameClass != FrameClass::CLASS_POPULARIMETER) return 0;
+	return dynamic_cast<const PopularimeterFrame&>(*viewFrame).rating();
+}
+
+///@pkg ID3FrameView.h
+const std::string& FrameView::email() const {
+	if(frameClass != FrameClass::CLASS_POPULARIMETER) return EMPTY_STRING;
+	return dynamic_cast<const PopularimeterFrame&>(*viewFrame).email();
+}
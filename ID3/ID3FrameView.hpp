@@ -0,0 +1,179 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_FRAME_VIEW_HPP
+#define ID3_FRAME_VIEW_HPP
+
+#include <initializer_list> //For std::initializer_list
+#include <string>           //For std::string
+#include <vector>           //For std::vector
+
+#include "Frames/ID3Frame.hpp"        //For Frame, FrameClass, FrameFlag, and DecodedFrameHeader
+#include "Frames/ID3PictureFrame.hpp" //For PictureType
+#include "ID3FrameID.hpp"             //For FrameID
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * Which frames ID3::Tag::visitFrames() visits. By default it matches every
+	 * frame. A frame matches if its class is one of the classes and its ID is
+	 * one of the IDs, where no classes or no IDs match any.
+	 * 
+	 * Defined in ID3FrameView.cpp.
+	 */
+	struct FrameFilter {
+		/**
+		 * A filter that matches every frame.
+		 */
+		FrameFilter();
+		
+		/**
+		 * A filter that matches frames of some classes.
+		 * 
+		 * @param frameClasses The frame classes.
+		 */
+		FrameFilter(std::initializer_list<FrameClass> frameClasses);
+		
+		/**
+		 * A filter that matches frames with some IDs.
+		 * 
+		 * @param frameIDs The frame IDs.
+		 */
+		FrameFilter(std::initializer_list<FrameID> frameIDs);
+		
+		uint16_t classes;         //A bit for each FrameClass value that matches, or 0 for every class
+		std::vector<FrameID> ids; //The frame IDs that match, or empty for every ID
+		
+		/**
+		 * @param frame The frame.
+		 * @return If the frame matches.
+		 */
+		bool matches(const Frame& frame) const;
+	};
+	
+	/**
+	 * FrameView is a frame seen through ID3::Tag::visitFrames(). It points to
+	 * the frame's content instead of copying it, so visiting every frame of a
+	 * tag doesn't allocate memory.
+	 * 
+	 * Each getter works on every frame, and gives an empty value if the frame
+	 * doesn't have that field.
+	 * 
+	 * NOTE: A FrameView is only valid until the Tag is changed, and references
+	 *       from it until the frame is changed.
+	 * 
+	 * Defined in ID3FrameView.cpp.
+	 */
+	class FrameView {
+		public:
+			/**
+			 * View a frame.
+			 * 
+			 * @param frame The frame.
+			 */
+			explicit FrameView(const Frame& frame);
+			
+			/**
+			 * @return The frame.
+			 */
+			inline const Frame& frame() const { return *viewFrame; }
+			
+			/**
+			 * @return The frame ID.
+			 */
+			inline FrameID id() const { return viewFrame->frame(); }
+			
+			/**
+			 * @return The frame class.
+			 */
+			inline FrameClass type() const { return frameClass; }
+			
+			/**
+			 * @param flag The frame flag to check.
+			 * @return If the flag is set.
+			 * @see ID3::Frame::flag(FrameFlag)
+			 */
+			inline bool flag(const FrameFlag flag) const { return viewFrame->header().flag(flag); }
+			
+			/**
+			 * @return The frame header.
+			 */
+			inline const DecodedFrameHeader& header() const { return viewFrame->header(); }
+			
+			/**
+			 * @return The text content of text frames, or the URL of URL frames.
+			 */
+			const std::string& text() const;
+			
+			/**
+			 * @return The description of descriptive text frames and pictures.
+			 */
+			const std::string& description() const;
+			
+			/**
+			 * @return The language of descriptive text frames that have one.
+			 */
+			const std::string& language() const;
+			
+			/**
+			 * @return The picture data.
+			 */
+			const ByteArray& picture() const;
+			
+			/**
+			 * @return The MIME type of pictures.
+			 */
+			const std::string& mimeType() const;
+			
+			/**
+			 * @return The picture type of pictures, or PictureType::OTHER.
+			 */
+			PictureType pictureType() const;
+			
+			/**
+			 * @return The play count of play count and popularimeter frames.
+			 */
+			unsigned long long playCount() const;
+			
+			/**
+			 * @return The rating of popularimeter frames, from 0 to 5.
+			 */
+			ushort rating() const;
+			
+			/**
+			 * @return The email address of popularimeter frames.
+			 */
+			const std::string& email() const;
+		
+		private:
+			/**
+			 * The frame.
+			 */
+			const Frame* viewFrame;
+			
+			/**
+			 * The frame class, so it isn't found for every getter.
+			 */
+			FrameClass frameClass;
+	};
+}
+
+#endif
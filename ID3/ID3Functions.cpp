@@ -11,20 +11,24 @@
  **********************************************************************/
 
 #include <cstring>          //For ::strlen()
+#include <cctype>           //For ::tolower()
 #include <unicode/unistr.h> //For icu::UnicodeString
 #include <algorithm>        //For std::reverse() and std::all_of()
 
 #include "ID3Functions.hpp"    //For the function definitions
 #include "ID3Constants.hpp"    //For ID3::GENRES
+#include "ID3Chunks.hpp"       //For ChunkIndex
+#include "ID3MP4Atoms.hpp"     //For AtomIndex
 #include "Frames/ID3Frame.hpp" //For the FrameEncoding enum
 
 using namespace ID3;
 
 ///@pkg ID3Functions.h
-std::string ID3::V1::getGenreString(ushort genre) {
+const std::string& ID3::V1::getGenreString(ushort genre) {
+	static const std::string NO_GENRE;
 	if(genre < V1::GENRES.size())
 		return V1::GENRES[genre];
-	return "";
+	return NO_GENRE;
 }
 
 ///@pkg ID3Functions.h
@@ -70,6 +74,26 @@ ByteArray ID3::intToByteArray(unsigned long long val, ushort length, bool synchs
 	}
 }
 
+///@pkg ID3Functions.h
+unsigned long long ID3::littleEndianIntVal(const uint8_t* array, int length) {
+	if(array == nullptr || length < 1) return 0;
+	
+	unsigned long long value = 0;
+	
+	//Start from the most significant byte at the end of the array
+	for(int i = length - 1; i >= 0; i--)
+		value = (value << 8) + array[i];
+	
+	return value;
+}
+
+///@pkg ID3Functions.h
+ByteArray ID3::intToLittleEndianByteArray(unsigned long long val, ushort length) {
+	ByteArray byteVector = intToByteArray(val, length);
+	std::reverse(byteVector.begin(), byteVector.end());
+	return byteVector;
+}
+
 ///@pkg ID3Functions.h
 std::string ID3::terminatedstring(const char* str, std::string::size_type maxlength) {
 	std::string::size_type nullcharpos = ::strlen(str);
@@ -78,6 +102,14 @@ std::string ID3::terminatedstring(const char* str, std::string::size_type maxlen
 
 ///@pkg ID3Functions.h
 std::string ID3::utf16toutf8(const ByteArray& u16s,
+                             long start,
+                             long end) {
+	return utf16toutf8(u16s.data(), u16s.size(), start, end);
+}
+
+///@pkg ID3Functions.h
+std::string ID3::utf16toutf8(const uint8_t* u16s,
+                             ulong size,
                              long start,
                              long end) {	
 	//Set the start
@@ -85,8 +117,8 @@ std::string ID3::utf16toutf8(const ByteArray& u16s,
 		start = 0;
 	
 	//Set the end
-	if(end < 0 || static_cast<ulong>(end) > u16s.size())
-		end = u16s.size();
+	if(end < 0 || static_cast<ulong>(end) > size)
+		end = size;
 	
 	//UTF-16 uses 2-byte character widths. If there's 0 bytes then
 	//it's an empty string anyways, and if there's 1 byte then it's
@@ -94,16 +126,10 @@ std::string ID3::utf16toutf8(const ByteArray& u16s,
 	if(end - start < 2)
 		return "";
 	
-	const int u16sSize = end - start;
+	const long u16sSize = end - start;
 	
 	//The byte offset to start processing the UTF-16 string
-	int offset = 0;
-	
-	//Create an array of 2-byte characters that is encoded in UTF-16
-	uint16_t* utf16CharArr = new uint16_t[u16sSize / 2];
-	
-	//The string to return
-	std::string toReturn;
+	long offset = 0;
 	
 	//If it has the BOM, it checks the first character in the string.
 	//If it's 0xFFFE then it uses little endian, and the bytes for each character
@@ -112,40 +138,42 @@ std::string ID3::utf16toutf8(const ByteArray& u16s,
 	//ICU does not seem to processes the BOM or little endian encoding, so it has
 	//to be manually done. This is automatically checked and processed in
 	//utf16toutf8(), no need to mess with the BOM beforehand.
-	if((uint8_t)u16s[start] == 0xFF && (uint8_t)u16s[start+1] == 0xFE) { //Has Little Endian BOM
+	const bool littleEndian = u16s[start] == 0xFF && u16s[start+1] == 0xFE;
+	if(littleEndian || (u16s[start] == 0xFE && u16s[start+1] == 0xFF))
 		offset = 2; //Don't want to include the BOM in the returned string
-		
-		//Since this is in the case of little endian-ness, the byte with
-		//the most significant values are in the second byte.
-		for(int i = 0; i < u16sSize; i += 2)
-			utf16CharArr[i/2] = ((uint16_t)u16s[start + offset + i + 1] << 8) + (uint16_t)u16s[start + offset + i];
-	} else { //May or may not have BOM, is Big Endian
-		//Checks if the first character is 0xFEFF. If it is, then increment the
-		//starting position by two to remove the BOM from the returned string
-		if((uint8_t)u16s[start] == 0xFE && (uint8_t)u16s[start+1] == 0xFF)
-			offset = 2;
-		
-		for(int i = 0; i < u16sSize; i += 2)
-			utf16CharArr[i/2] = ((uint16_t)u16s[start + offset + i] << 8) + (uint16_t)u16s[start + i + offset + 1];
-	}
 	
-	//Create a UnicodeString from the UTF-16 character array
-	//If there was a BOM, the string will be one character shorter
-	//than the char vector.
-	icu::UnicodeString icuStr(utf16CharArr, (u16sSize - offset) / 2);
+	//The number of 2-byte characters, which is one less if there was a BOM
+	const int32_t CHARACTERS = (u16sSize - offset) / 2;
+	
+	//Write the characters straight into the UnicodeString's buffer, instead of
+	//copying them from a separate array
+	icu::UnicodeString icuStr;
+	UChar* const utf16CharArr = icuStr.getBuffer(CHARACTERS);
+	if(utf16CharArr == nullptr) return "";
+	
+	//In the case of little endian-ness, the byte with the most significant
+	//values is the second byte.
+	const uint8_t* const CHARACTER_BYTES = u16s + start + offset;
+	const ushort HIGH_BYTE = littleEndian ? 1 : 0;
+	for(int32_t i = 0; i < CHARACTERS; i++)
+		utf16CharArr[i] = (static_cast<uint16_t>(CHARACTER_BYTES[2*i + HIGH_BYTE]) << 8) + CHARACTER_BYTES[2*i + 1 - HIGH_BYTE];
+	icuStr.releaseBuffer(CHARACTERS);
 	
 	//Have the UnicodeString converted to UTF-8 and store the result
 	//in toReturn.
+	std::string toReturn;
 	icuStr.toUTF8String(toReturn);
 	
-	//Prevent memory leaks.
-	delete [] utf16CharArr;
-	
 	return toReturn;
 }
 
 ///@pkg ID3Functions.h
 std::string ID3::latin1toutf8(const ByteArray& latin1s, long start, long end) {
+	return latin1toutf8(latin1s.data(), latin1s.size(), start, end);
+}
+
+///@pkg ID3Functions.h
+std::string ID3::latin1toutf8(const uint8_t* latin1s, ulong size, long start, long end) {
 	//0x80 (128) is the first character beyond ASCII
 	static const uint8_t BEYOND_ASCII = 0x80;
 	
@@ -164,44 +192,38 @@ std::string ID3::latin1toutf8(const ByteArray& latin1s, long start, long end) {
 		start = 0;
 	
 	//Set the end 
-	if(end < 0 || static_cast<ulong>(end) > latin1s.size())
-		end = latin1s.size();
+	if(end < 0 || static_cast<ulong>(end) > size)
+		end = size;
 	
 	//Empty string base case
 	if(end <= start)
 		return "";
 	
-	const int latin1sSize = end - start;
+	//Every non-ASCII character takes two bytes in UTF-8, so count them to
+	//size the string once. Short strings then fit in the string object itself
+	//without allocating memory.
+	long utf8Size = end - start;
+	for(long i = start; i < end; i++)
+		if(latin1s[i] >= BEYOND_ASCII) utf8Size++;
 	
-	int curPos = 0;
-		
-	//Create a char array to hold the translated UTF-8 string.
-	//In the worst case utf8CharArr's byte size will have to be twice the LATIN-1
-	//string's size, which will happen if the LATIN-1 string contains no ASCII
-	//characters.
-	char* utf8CharArr = new char[latin1sSize * 2];
+	std::string toReturn(utf8Size, '\0');
+	long curPos = 0;
 	
 	for(long i = start; i < end; i++) {
 		uint8_t curChar = latin1s[i];
 		
 		if(curChar < BEYOND_ASCII) {
 			//If curChar <= 127, it is an ASCII character that is identical in UTF-8
-			utf8CharArr[curPos] = curChar;
+			toReturn[curPos] = curChar;
 			curPos++;
 		} else {
 			//Translate the LATIN-1 character to a UTF-8 character
-			utf8CharArr[curPos] = UTF8_TWO_BYTE_MASK | (curChar >> VARIABLE_UTF8_CHAR_USABLE_BITS);
-			utf8CharArr[curPos+1] = BEYOND_ASCII | (curChar & UTF8_BYTE_TWO_MASK);
+			toReturn[curPos] = UTF8_TWO_BYTE_MASK | (curChar >> VARIABLE_UTF8_CHAR_USABLE_BITS);
+			toReturn[curPos+1] = BEYOND_ASCII | (curChar & UTF8_BYTE_TWO_MASK);
 			curPos += 2;
 		}
 	}
 	
-	//Create a string from the array
-	std::string toReturn(utf8CharArr, curPos);
-	
-	//Prevent memory leaks
-	delete [] utf8CharArr;
-	
 	//Return the string
 	return toReturn;
 }
@@ -211,13 +233,22 @@ std::string ID3::getUTF8String(uint8_t encoding,
                                const ByteArray& bytes,
                                long start,
                                long end) {
+	return getUTF8String(encoding, bytes.data(), bytes.size(), start, end);
+}
+
+///@pkg ID3Functions.h
+std::string ID3::getUTF8String(uint8_t encoding,
+                               const uint8_t* bytes,
+                               ulong size,
+                               long start,
+                               long end) {
 	//Set the start
 	if(start < 0)
 		start = 0;
 	
 	//Set the end 
-	if(end < 0 || static_cast<ulong>(end) > bytes.size())
-		end = bytes.size();
+	if(end < 0 || static_cast<ulong>(end) > size)
+		end = size;
 	
 	//Empty string base case
 	if(end <= start)
@@ -226,18 +257,162 @@ std::string ID3::getUTF8String(uint8_t encoding,
 	switch(encoding) {
 		//UTF-16 case
 		case FrameEncoding::ENCODING_UTF16BOM:
-		case FrameEncoding::ENCODING_UTF16: return utf16toutf8(bytes, start, end);
+		case FrameEncoding::ENCODING_UTF16: return utf16toutf8(bytes, size, start, end);
 		//UTF-8 case
-		case FrameEncoding::ENCODING_UTF8: return std::string(bytes.begin()+start,
-		                                                      bytes.begin()+end);
+		case FrameEncoding::ENCODING_UTF8: return std::string(bytes+start,
+		                                                      bytes+end);
 		//LATIN-1 case
 		case FrameEncoding::ENCODING_LATIN1: default: return latin1toutf8(bytes,
+		                                                                  size,
 		                                                                  start,
 		                                                                  end);
 	}
 }
 
+//Private namespace
+namespace {
+	/**
+	 * Decode the UTF-8 character at a position in a string.
+	 * 
+	 * @param str The UTF-8 string.
+	 * @param pos The position of the character, which is moved past it.
+	 * @return The code point, or -1 if the character isn't valid UTF-8.
+	 */
+	static long nextCodePoint(const std::string& str, std::string::size_type& pos) {
+		const uint8_t first = str[pos++];
+		if(first < 0x80) return first;
+		
+		//The number of continuation bytes, and the bits of the first byte
+		ushort extra;
+		long codePoint;
+		if((first & 0xE0) == 0xC0)      extra = 1, codePoint = first & 0x1F;
+		else if((first & 0xF0) == 0xE0) extra = 2, codePoint = first & 0x0F;
+		else if((first & 0xF8) == 0xF0) extra = 3, codePoint = first & 0x07;
+		else                            return -1;
+		
+		for(; extra > 0; extra--) {
+			if(pos >= str.size() || (static_cast<uint8_t>(str[pos]) & 0xC0) != 0x80) return -1;
+			codePoint = (codePoint << 6) | (static_cast<uint8_t>(str[pos++]) & 0x3F);
+		}
+		return codePoint > 0x10FFFF ? -1 : codePoint;
+	}
+}
+
+///@pkg ID3Functions.h
+uint8_t ID3::smallestEncoding(const std::string& str, const bool allowUTF16) {
+	ulong utf16Size = 2; //The first BOM
+	bool fitsLatin1 = true;
+	
+	for(std::string::size_type pos = 0; pos < str.size();) {
+		const long codePoint = nextCodePoint(str, pos);
+		if(codePoint < 0) return FrameEncoding::ENCODING_UTF8;
+		
+		if(codePoint > 0xFF) fitsLatin1 = false;
+		//Characters past the BMP take a surrogate pair, and every string
+		//after a null separator has its own BOM
+		utf16Size += codePoint > 0xFFFF ? 4 : (codePoint == 0 ? 4 : 2);
+	}
+	
+	//LATIN-1 always takes one byte per character, so it's never bigger than UTF-8
+	if(fitsLatin1)                           return FrameEncoding::ENCODING_LATIN1;
+	if(allowUTF16 && utf16Size < str.size()) return FrameEncoding::ENCODING_UTF16BOM;
+	return FrameEncoding::ENCODING_UTF8;
+}
+
+///@pkg ID3Functions.h
+ByteArray ID3::getEncodedString(uint8_t encoding, const std::string& str) {
+	ByteArray bytes;
+	
+	switch(encoding) {
+		//UTF-8 case
+		case FrameEncoding::ENCODING_UTF8: {
+			bytes.assign(str.begin(), str.end());
+			break;
+		//UTF-16 case
+		} case FrameEncoding::ENCODING_UTF16BOM:
+		  case FrameEncoding::ENCODING_UTF16: {
+			const bool bom = encoding == FrameEncoding::ENCODING_UTF16BOM;
+			bytes.reserve(str.size() * 2 + 2);
+			if(bom) bytes.push_back(0xFF), bytes.push_back(0xFE);
+			
+			icu::UnicodeString icuStr = icu::UnicodeString::fromUTF8(str);
+			for(int32_t i = 0; i < icuStr.length(); i++) {
+				const char16_t unit = icuStr[i];
+				bytes.push_back(unit & 0xFF);
+				bytes.push_back(unit >> 8);
+				if(unit == 0 && bom) bytes.push_back(0xFF), bytes.push_back(0xFE);
+			}
+			break;
+		//LATIN-1 case
+		} case FrameEncoding::ENCODING_LATIN1: default: {
+			bytes.reserve(str.size());
+			for(std::string::size_type pos = 0; pos < str.size();) {
+				const long codePoint = nextCodePoint(str, pos);
+				bytes.push_back(codePoint >= 0 && codePoint <= 0xFF ? codePoint : '?');
+			}
+		}
+	}
+	
+	return bytes;
+}
+
 ///@pkg ID3Functions.h
 bool ID3::numericalString(const std::string& str) {
 	return std::all_of(str.begin(), str.end(), ::isdigit);
 }
+
+///@pkg ID3Functions.h
+bool ID3::locateV2Tag(std::istream& file, const ulong fileSize, ulong& tagStart, ulong& tagLimit) {
+	tagStart = 0;
+	tagLimit = fileSize;
+	
+	const ChunkIndex chunks(file, fileSize);
+	if(chunks.container() != ChunkContainer::NONE) {
+		if(chunks.id3Chunk() == nullptr) return false;
+		tagStart = chunks.id3Chunk()->dataStart();
+		tagLimit = tagStart + chunks.id3Chunk()->size;
+		return true;
+	}
+	
+	const AtomIndex atoms(file, fileSize);
+	if(atoms.mp4()) {
+		if(atoms.id32Atom() == nullptr) return false;
+		tagStart = atoms.id3Start();
+		tagLimit = atoms.id32Atom()->end();
+	}
+	
+	return true;
+}
+
+///@pkg ID3Functions.h
+bool ID3::supportedFileType(const char* name, const size_t length) {
+	//The supported extensions, packed the same way as below
+	static const uint32_t EXTENSIONS[] = {
+		0x6D7033, 0x746167,                                         //mp3, tag
+		0x6D7034, 0x6D3461, 0x6D3470, 0x6D3462, 0x6D3472, 0x6D3476, //mp4, m4a, m4p, m4b, m4r, m4v
+		0x776176, 0x77617665,                                       //wav, wave
+		0x616966, 0x61696666, 0x61696663                            //aif, aiff, aifc
+	};
+	
+	//Find the dot, which has to be 4 or 5 characters from the end
+	size_t dot = length;
+	for(size_t i = 1; i <= 5 && i <= length; i++) {
+		if(name[length - i] == '.') {
+			dot = length - i;
+			break;
+		}
+	}
+	if(dot == length || length - dot < 4) return false;
+	
+	//Pack the lowercase extension into an integer
+	uint32_t extension = 0;
+	for(size_t i = dot + 1; i < length; i++)
+		extension = (extension << 8) | static_cast<uint8_t>(::tolower(static_cast<uint8_t>(name[i])));
+	
+	for(const uint32_t supported : EXTENSIONS)
+		if(extension == supported) return true;
+	return false;
+}
+
+///@pkg ID3Functions.h
+bool ID3::supportedFileType(const std::string& name) { return supportedFileType(name.c_str(), name.size()); }
@@ -13,8 +13,9 @@
 #ifndef ID3_FUNCTIONS_HPP
 #define ID3_FUNCTIONS_HPP
 
-#include <string> //For std::string
-#include <vector> //For std::vector
+#include <istream> //For std::istream
+#include <string>  //For std::string
+#include <vector>  //For std::vector
 
 /**
  * The ID3 namespace defines everything related to reading and writing
@@ -40,8 +41,9 @@ namespace ID3 {
 		 * A function to get the genre of a song, from an ID3v1 genre int.
 		 * @param genre The integer ID for the ID3v1 genre.
 		 * @returns The genre if the genre was found, and a blank string otherwise.
+		 * @see ID3::V1::getGenreID(std::string&)
 		 */
-		std::string getGenreString(ushort genre);
+		const std::string& getGenreString(ushort genre);
 	}
 	
 	/**
@@ -75,6 +77,30 @@ namespace ID3 {
 	 */
 	ByteArray intToByteArray(unsigned long long val, ushort length=0, bool synchsafe=false);
 	
+	/**
+	 * Receives a little-endian byte array, such as the sizes in APE tags and
+	 * RIFF chunks, and calculates the unsigned integer that it encodes.
+	 * 
+	 * NOTE: The size of the array is not checked, segmentation faults will
+	 *       not be prevented if given a length longer the length of the array.
+	 * 
+	 * @param array The byte array.
+	 * @param length The length of the byte array.
+	 * @return The value of the little-endian integer.
+	 */
+	unsigned long long littleEndianIntVal(const uint8_t* array, int length);
+	
+	/**
+	 * Given an unsigned integer value, receive a ByteArray that encodes the
+	 * integer value in little-endian byte order.
+	 * 
+	 * @param val The integer value to encode. If it does not fit in the
+	 *            ByteArray, the maximum value that fits is encoded instead.
+	 * @param length The length of the ByteArray to return.
+	 * @return The integer value encoded as a little-endian ByteArray.
+	 */
+	ByteArray intToLittleEndianByteArray(unsigned long long val, ushort length);
+	
 	/**
 	 * Create a std::string object with the call std::string(const char* s, size_type n).
 	 * The difference is that the string will be trimmed to the position
@@ -103,6 +129,8 @@ namespace ID3 {
 	 * @return The UTF-8 encoded string.
 	 */
 	std::string utf16toutf8(const ByteArray& u16s, long start=-1, long end=-1);
+	/** @see ID3::utf16toutf8(const ByteArray&, long, long) */
+	std::string utf16toutf8(const uint8_t* u16s, ulong size, long start=-1, long end=-1);
 	
 	/**
 	 * utf16toutf8() takes a char vector of a string encoded in LATIN-1 created
@@ -119,6 +147,8 @@ namespace ID3 {
 	 * @return The UTF-8 encoded string.
 	 */
 	std::string latin1toutf8(const ByteArray& ulatin1s, long start=-1, long end=-1);
+	/** @see ID3::latin1toutf8(const ByteArray&, long, long) */
+	std::string latin1toutf8(const uint8_t* ulatin1s, ulong size, long start=-1, long end=-1);
 	
 	/**
 	 * Get a ByteArray encoded in either LATIN-1, UTF-8, or UTF-16, and return
@@ -144,6 +174,47 @@ namespace ID3 {
 	                          const ByteArray& bytes,
 	                          long start=-1,
 	                          long end=-1);
+	/**
+	 * @see ID3::getUTF8String(uint8_t, const ByteArray&, long, long)
+	 * @param size The number of bytes.
+	 */
+	std::string getUTF8String(uint8_t encoding,
+	                          const uint8_t* bytes,
+	                          ulong size,
+	                          long start=-1,
+	                          long end=-1);
+	
+	/**
+	 * Find the encoding that takes the fewest bytes to store a UTF-8 string:
+	 * LATIN-1 if every character fits in it, UTF-8, or UTF-16 with a BOM,
+	 * which is smaller for text that is mostly characters past U+07FF. Ties
+	 * go to LATIN-1, then UTF-8.
+	 * 
+	 * NOTE: If the string isn't valid UTF-8, it will be UTF-8 so that it's
+	 *       written unchanged.
+	 * 
+	 * @param str        The UTF-8 string. Null characters separate strings,
+	 *                   which each get their own BOM in UTF-16.
+	 * @param allowUTF16 If UTF-16 can be returned (optional, defaults to true).
+	 * @return The encoding, as an ID3::FrameEncoding value.
+	 */
+	uint8_t smallestEncoding(const std::string& str, const bool allowUTF16=true);
+	
+	/**
+	 * Encode a UTF-8 string in LATIN-1, UTF-8, or UTF-16. This is the reverse
+	 * of ID3::getUTF8String().
+	 * 
+	 * NOTE: Characters that don't fit in LATIN-1 are replaced with '?'.
+	 * NOTE: UTF-16 is written in little endian. With ENCODING_UTF16BOM, each
+	 *       null-separated string starts with a BOM.
+	 * 
+	 * @param encoding A char whose int values are represented by the enum
+	 *                 ID3::FrameEncoding. If the encoding is unknown it will
+	 *                 default to LATIN-1.
+	 * @param str      The UTF-8 string.
+	 * @return The encoded string.
+	 */
+	ByteArray getEncodedString(uint8_t encoding, const std::string& str);
 	
 	/**
 	 * Check if a string contains only digits.
@@ -152,6 +223,40 @@ namespace ID3 {
 	 * @return If the string is numerical.
 	 */
 	bool numericalString(const std::string& str);
+	
+	/**
+	 * Find where the ID3v2 tag of a file can be, the same way ID3::Tag does:
+	 * in the ID3 chunk of WAV and AIFF files, in the ID32 box of MP4 files, or
+	 * at the start of any other file.
+	 * 
+	 * @param file     The file stream object.
+	 * @param fileSize The size of the file.
+	 * @param tagStart Set to the file position of the tag.
+	 * @param tagLimit Set to the position the tag must end by.
+	 * @return False if the file is a WAV, AIFF, or MP4 file without an ID3v2
+	 *         tag, and true otherwise.
+	 */
+	bool locateV2Tag(std::istream& file, const ulong fileSize, ulong& tagStart, ulong& tagLimit);
+	
+	/**
+	 * Check if a file name has the extension of a file type ID3::Tag can read:
+	 * MP3 (.mp3 and .tag), MP4 (.mp4, .m4a, .m4p, .m4b, .m4r, and .m4v), WAV
+	 * (.wav and .wave), or AIFF (.aif, .aiff, and .aifc). Case is ignored.
+	 * 
+	 * NOTE: The extension is packed into an integer and compared against a
+	 *       table, so this is cheap enough to run on every name in a
+	 *       directory before any file is opened.
+	 * 
+	 * @param name   The file name or path.
+	 * @param length The length of the name.
+	 * @return If the extension is supported.
+	 */
+	bool supportedFileType(const char* name, const size_t length);
+	
+	/**
+	 * @see ID3::supportedFileType(const char*, size_t)
+	 */
+	bool supportedFileType(const std::string& name);
 }
 
 #endif
@@ -0,0 +1,195 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm> //For std::fill(), std::find(), and std::stable_sort()
+#include <numeric>   //For std::iota()
+#include <strings.h> //For strncasecmp()
+
+#include "ID3Genre.hpp"     //For the function definitions
+#include "ID3Functions.hpp" //For getGenreString() and numericalString()
+#include "ID3Constants.hpp" //For V1::GENRES
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The number of slots in the genre hash table, a power of two.
+	 */
+	static const ushort GENRE_TABLE_SIZE = 256;
+	
+	/**
+	 * The number of buckets the genres are split into before being given a
+	 * slot, a power of two.
+	 */
+	static const ushort GENRE_BUCKETS = 64;
+	
+	/**
+	 * A case-insensitive (for ASCII letters) FNV-1a hash.
+	 * 
+	 * @param text   The text.
+	 * @param length The length of the text.
+	 * @param seed   The hash seed.
+	 * @return The hash.
+	 */
+	static constexpr uint32_t genreHash(const char* text, const size_t length, const uint32_t seed) {
+		uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+		for(size_t i = 0; i < length; i++) {
+			const char character = text[i] >= 'A' && text[i] <= 'Z' ? text[i] + ('a' - 'A') : text[i];
+			hash = (hash ^ static_cast<uint8_t>(character)) * 16777619u;
+		}
+		return hash ^ (hash >> 15);
+	}
+	
+	/**
+	 * A perfect hash table of the ID3v1 genre names, built with hash and
+	 * displace: each name is put in a bucket by its hash, and each bucket gets
+	 * the first seed that puts all of its names in empty slots.
+	 */
+	struct GenreTable {
+		/**
+		 * Fill the table, starting with the biggest buckets.
+		 */
+		GenreTable() {
+			std::vector<std::vector<ushort>> buckets(GENRE_BUCKETS);
+			for(ushort id = 0; id < V1::GENRES.size(); id++)
+				buckets[bucket(V1::GENRES[id])].push_back(id);
+			
+			std::vector<ushort> order(GENRE_BUCKETS);
+			std::iota(order.begin(), order.end(), 0);
+			std::stable_sort(order.begin(), order.end(), [&buckets](const ushort first, const ushort second) {
+				return buckets[first].size() > buckets[second].size();
+			});
+			
+			std::fill(slots, slots + GENRE_TABLE_SIZE, 0);
+			std::fill(seeds, seeds + GENRE_BUCKETS, 0);
+			for(const ushort bucketIndex : order) {
+				const std::vector<ushort>& ids = buckets[bucketIndex];
+				if(ids.empty()) break;
+				
+				//Try seeds until every name in the bucket gets its own empty slot
+				for(uint32_t seed = 1; ; seed++) {
+					std::vector<ushort> taken;
+					for(const ushort id : ids) {
+						const ushort genreSlot = slot(V1::GENRES[id], seed);
+						if(slots[genreSlot] != 0 || std::find(taken.begin(), taken.end(), genreSlot) != taken.end()) break;
+						taken.push_back(genreSlot);
+					}
+					if(taken.size() == ids.size()) {
+						seeds[bucketIndex] = seed;
+						for(size_t i = 0; i < ids.size(); i++) slots[taken[i]] = ids[i] + 1;
+						break;
+					}
+				}
+			}
+		}
+		
+		/**
+		 * @return The bucket of a name.
+		 */
+		static ushort bucket(const std::string& name) {
+			return genreHash(name.c_str(), name.size(), 0) & (GENRE_BUCKETS - 1);
+		}
+		
+		/**
+		 * @return The slot of a name with a bucket's seed.
+		 */
+		static ushort slot(const std::string& name, const uint32_t seed) {
+			return genreHash(name.c_str(), name.size(), seed) & (GENRE_TABLE_SIZE - 1);
+		}
+		
+		/**
+		 * @return The slot of a name.
+		 */
+		ushort slot(const std::string& name) const { return slot(name, seeds[bucket(name)]); }
+		
+		uint32_t seeds[GENRE_BUCKETS];  //Each bucket's seed
+		ushort slots[GENRE_TABLE_SIZE]; //Each slot's genre ID plus one, or 0
+	};
+	
+	/**
+	 * Get the ID3v1 genre name of a genre reference.
+	 * 
+	 * @param reference The text of the reference, such as "17" or "RX".
+	 * @return The genre name, or "" if the text isn't a genre reference.
+	 */
+	static std::string referencedGenre(const std::string& reference) {
+		if(reference == "RX") return "Remix";
+		if(reference == "CR") return "Cover";
+		if(reference.empty() || reference.size() > 3 || !numericalString(reference)) return "";
+		return V1::getGenreString(std::stoi(reference));
+	}
+	
+	/**
+	 * Add a genre if it isn't already in a list, ignoring the case of ASCII
+	 * letters.
+	 */
+	static void addGenre(std::vector<std::string>& genres, const std::string& genre) {
+		if(genre.empty()) return;
+		for(const std::string& added : genres)
+			if(added.size() == genre.size() && strncasecmp(added.c_str(), genre.c_str(), genre.size()) == 0) return;
+		genres.push_back(genre);
+	}
+}
+
+///@pkg ID3Genre.h
+short V1::getGenreID(const std::string& genre) {
+	static const GenreTable table;
+	const ushort slot = table.slots[table.slot(genre)];
+	if(slot == 0) return -1;
+	const std::string& name = V1::GENRES[slot - 1];
+	if(name.size() != genre.size() || strncasecmp(name.c_str(), genre.c_str(), name.size()) != 0) return -1;
+	return slot - 1;
+}
+
+///@pkg ID3Genre.h
+std::vector<std::string> ID3::parseGenres(const std::string& genre) {
+	std::vector<std::string> genres;
+	size_t stringStart = 0;
+	
+	while(stringStart <= genre.size()) {
+		//Get the next null-separated string
+		size_t stringEnd = genre.find('\0', stringStart);
+		if(stringEnd == std::string::npos) stringEnd = genre.size();
+		const std::string text = genre.substr(stringStart, stringEnd - stringStart);
+		stringStart = stringEnd + 1;
+		
+		if(text.empty()) continue;
+		
+		//A number on its own is an ID3v1 genre, and is ignored if it's not
+		//in the ID3v1 genre list
+		if(numericalString(text)) {
+			const std::string referenced = referencedGenre(text);
+			if(!referenced.empty()) addGenre(genres, referenced);
+			continue;
+		}
+		
+		//Parse the ID3v2.3 genre references. Numbers that aren't in the ID3v1
+		//genre list are skipped over.
+		size_t pos = 0;
+		while(pos + 1 < text.size() && text[pos] == '(' && text[pos + 1] != '(') {
+			const size_t close = text.find(')', pos + 1);
+			if(close == std::string::npos) break;
+			const std::string reference = text.substr(pos + 1, close - pos - 1);
+			const std::string referenced = referencedGenre(reference);
+			if(referenced.empty() && (reference.empty() || !numericalString(reference))) break;
+			if(!referenced.empty()) addGenre(genres, referenced);
+			pos = close + 1;
+		}
+		
+		//The rest is refinement text, where "((" is an escaped "("
+		if(text.compare(pos, 2, "((") == 0) pos++;
+		addGenre(genres, text.substr(pos));
+	}
+	
+	return genres;
+}
@@ -0,0 +1,72 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_GENRE_HPP
+#define ID3_GENRE_HPP
+
+#include <string> //For std::string
+#include <vector> //For std::vector
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * ID3v1 Functions.
+	 */
+	namespace V1 {
+		/**
+		 * Get the ID3v1 genre ID of a genre name, ignoring the case of ASCII
+		 * letters. This is the reverse of ID3::V1::getGenreString().
+		 * 
+		 * The names are found with a perfect hash table, so a lookup hashes the
+		 * name once and compares it with at most one genre.
+		 * 
+		 * @param genre The genre name, such as "Rock" or "hip-hop".
+		 * @return The genre ID, or -1 if the name isn't an ID3v1 genre.
+		 */
+		short getGenreID(const std::string& genre);
+	}
+	
+	/**
+	 * Parse the text of a genre (TCON) frame into genre names, without
+	 * regular expressions.
+	 * 
+	 * ID3v2.3 genres can start with ID3v1 genre references in parentheses,
+	 * such as "(17)" for Rock, or "(RX)" and "(CR)" for Remix and Cover. Text
+	 * after the references refines them, so "(17)(RX)Garage Remix" is parsed
+	 * into "Rock", "Remix", and "Garage Remix". Refinement text starting with
+	 * "((" starts with a literal "(".
+	 * 
+	 * ID3v2.4 genres are null-separated lists, where a string that is only a
+	 * number is an ID3v1 genre reference.
+	 * 
+	 * NOTE: Refinement text that is the same as a referenced genre (such as
+	 *       "(17)Rock") is only returned once.
+	 * NOTE: Numbers that aren't in the ID3v1 genre list, such as "200" or
+	 *       "(200)", are ignored.
+	 * 
+	 * @param genre The genre frame text. Null characters separate strings.
+	 * @return The genres, in the order they are in the text. Refinement text
+	 *         comes after the genres it refines.
+	 */
+	std::vector<std::string> parseGenres(const std::string& genre);
+}
+
+#endif
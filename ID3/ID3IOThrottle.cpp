@@ -0,0 +1,184 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm> //For std::min() and std::max()
+#include <thread>    //For std::this_thread::sleep_for()
+
+#ifdef __linux__
+#include <sys/syscall.h> //For SYS_ioprio_get and SYS_ioprio_set
+#include <unistd.h>      //For syscall()
+#endif
+
+#include "ID3IOThrottle.hpp" //For the class definitions
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The throttle set on each thread by ID3::IOThrottle::Scope.
+	 */
+	thread_local IOThrottle* currentThrottle = nullptr;
+	
+	/**
+	 * The values the Linux kernel uses for ioprio_set().
+	 */
+	const int IOPRIO_WHO_PROCESS = 1;
+	const int IOPRIO_CLASS_SHIFT = 13;
+	
+	/**
+	 * Get the I/O priority of the current thread.
+	 * 
+	 * @return The I/O priority, or -1 if it can't be read.
+	 */
+	int getThreadIOPriority() {
+		#ifdef __linux__
+		return syscall(SYS_ioprio_get, IOPRIO_WHO_PROCESS, 0);
+		#else
+		return -1;
+		#endif
+	}
+	
+	/**
+	 * Set the I/O priority of the current thread.
+	 * 
+	 * @param priority The I/O priority, in the form ioprio_get() returns.
+	 * @return If the priority was set.
+	 */
+	bool setThreadIOPriority(const int priority) {
+		#ifdef __linux__
+		return syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, priority) == 0;
+		#else
+		return false;
+		#endif
+	}
+	
+	/**
+	 * Take tokens out of a bucket, and get how long it'll take the bucket to
+	 * pay its debt.
+	 * 
+	 * @param tokens The tokens in the bucket.
+	 * @param take   The tokens to take.
+	 * @param rate   The tokens added per second, or 0 for no limit.
+	 * @return The seconds to wait.
+	 */
+	double takeTokens(double& tokens, const double take, const double rate) {
+		if(rate <= 0.0) return 0.0;
+		tokens -= take;
+		return tokens < 0.0 ? -tokens / rate : 0.0;
+	}
+}
+
+///@pkg ID3IOThrottle.h
+IOBudget::IOBudget() : bytesPerSecond(0.0),
+                       operationsPerSecond(0.0),
+                       burstSeconds(0.25),
+                       priority(IOPriority::UNCHANGED),
+                       priorityLevel(4) {}
+
+///@pkg ID3IOThrottle.h
+IORates::IORates() : bytes(0), operations(0), seconds(0.0), waitSeconds(0.0) {}
+
+///@pkg ID3IOThrottle.h
+double IORates::bytesPerSecond() const { return seconds > 0.0 ? bytes / seconds : 0.0; }
+
+///@pkg ID3IOThrottle.h
+double IORates::operationsPerSecond() const { return seconds > 0.0 ? operations / seconds : 0.0; }
+
+///@pkg ID3IOThrottle.h
+void IORates::print(std::ostream& os) const {
+	os << "I/O: " << bytes << " bytes, " << operations << " operations in " << seconds << " seconds" << std::endl
+	   << "Rates: " << bytesPerSecond() << " bytes/s, " << operationsPerSecond() << " operations/s" << std::endl
+	   << "Waited: " << waitSeconds << " seconds" << std::endl;
+}
+
+///@pkg ID3IOThrottle.h
+IOThrottle::Scope::Scope(IOThrottle* throttle) : previous(currentThrottle), previousPriority(-1) {
+	currentThrottle = throttle;
+	if(throttle == nullptr || throttle->ioBudget.priority == IOPriority::UNCHANGED) return;
+	
+	const int OLD_PRIORITY = getThreadIOPriority();
+	const int NEW_PRIORITY = (static_cast<int>(throttle->ioBudget.priority) << IOPRIO_CLASS_SHIFT) |
+	                         std::min<int>(throttle->ioBudget.priorityLevel, 7);
+	if(OLD_PRIORITY >= 0 && setThreadIOPriority(NEW_PRIORITY))
+		previousPriority = OLD_PRIORITY;
+}
+
+///@pkg ID3IOThrottle.h
+IOThrottle::Scope::~Scope() {
+	currentThrottle = previous;
+	if(previousPriority >= 0) setThreadIOPriority(previousPriority);
+}
+
+///@pkg ID3IOThrottle.h
+IOThrottle::IOThrottle(const IOBudget& budget) : ioBudget(budget),
+                                                 byteTokens(budget.bytesPerSecond * budget.burstSeconds),
+                                                 operationTokens(budget.operationsPerSecond * budget.burstSeconds),
+                                                 refilled(Clock::now()) {}
+
+///@pkg ID3IOThrottle.h
+const IOBudget& IOThrottle::budget() const { return ioBudget; }
+
+///@pkg ID3IOThrottle.h
+void IOThrottle::acquire(const ulong bytes, const ulong operations) {
+	double wait;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		const Clock::time_point NOW = Clock::now();
+		
+		//Refill the buckets, up to the burst size
+		const double ELAPSED = std::chrono::duration<double>(NOW - refilled).count();
+		refilled = NOW;
+		byteTokens = std::min(byteTokens + ELAPSED * ioBudget.bytesPerSecond,
+		                      ioBudget.bytesPerSecond * ioBudget.burstSeconds);
+		operationTokens = std::min(operationTokens + ELAPSED * ioBudget.operationsPerSecond,
+		                           ioBudget.operationsPerSecond * ioBudget.burstSeconds);
+		
+		//Wait until both buckets are out of debt
+		wait = std::max(takeTokens(byteTokens, bytes, ioBudget.bytesPerSecond),
+		                takeTokens(operationTokens, operations, ioBudget.operationsPerSecond));
+		
+		//Update the rates with the time the read or write will go through
+		if(ioRates.bytes == 0 && ioRates.operations == 0) first = NOW;
+		const Clock::time_point DONE = NOW + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(wait));
+		if(DONE > last) last = DONE;
+		ioRates.bytes += bytes;
+		ioRates.operations += operations;
+		ioRates.waitSeconds += wait;
+	}
+	
+	if(wait > 0.0) std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+}
+
+///@pkg ID3IOThrottle.h
+IORates IOThrottle::rates() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	IORates rates = ioRates;
+	if(rates.bytes > 0 || rates.operations > 0)
+		rates.seconds = std::chrono::duration<double>(last - first).count();
+	return rates;
+}
+
+///@pkg ID3IOThrottle.h
+void IOThrottle::reset() {
+	std::lock_guard<std::mutex> lock(mutex);
+	ioRates = IORates();
+	last = Clock::time_point();
+}
+
+///@pkg ID3IOThrottle.h
+IOThrottle* IOThrottle::current() { return currentThrottle; }
+
+///@pkg ID3IOThrottle.h
+void IOThrottle::charge(const ulong bytes, const ulong operations) {
+	if(currentThrottle != nullptr) currentThrottle->acquire(bytes, operations);
+}
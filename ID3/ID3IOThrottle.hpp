@@ -0,0 +1,227 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_IO_THROTTLE_HPP
+#define ID3_IO_THROTTLE_HPP
+
+#include <chrono>  //For std::chrono::steady_clock
+#include <cstdint> //For uint8_t
+#include <mutex>   //For std::mutex
+#include <ostream> //For std::ostream
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * The I/O scheduling classes of the Linux ioprio_set() system call.
+	 */
+	enum class IOPriority : uint8_t {
+		UNCHANGED   = 0, //Keep the thread's I/O priority
+		REALTIME    = 1, //Served before everything else (needs CAP_SYS_ADMIN)
+		BEST_EFFORT = 2, //The default class, with a level from 0 to 7
+		IDLE        = 3  //Only served when no other process is doing I/O
+	};
+	
+	/**
+	 * The I/O budget of an ID3::IOThrottle.
+	 */
+	struct IOBudget {
+		IOBudget();
+		double bytesPerSecond;      //The most bytes to read or write per second, or 0 for no limit (0)
+		double operationsPerSecond; //The most reads and writes per second, or 0 for no limit (0)
+		double burstSeconds;        //How many seconds of the budget can be spent at once after being idle (0.25)
+		IOPriority priority;        //The I/O class of the threads the throttle is used on (UNCHANGED)
+		uint8_t priorityLevel;      //The level in the I/O class, from 0 (highest) to 7 (lowest) (4)
+	};
+	
+	/**
+	 * The I/O done through an ID3::IOThrottle.
+	 */
+	struct IORates {
+		IORates();
+		ulong bytes;        //The bytes read and written
+		ulong operations;   //The reads and writes
+		double seconds;     //The seconds from the first read or write to the last one
+		double waitSeconds; //The seconds threads spent waiting for the budget, added over every thread
+		
+		/**
+		 * @return The achieved bytes per second.
+		 */
+		double bytesPerSecond() const;
+		
+		/**
+		 * @return The achieved reads and writes per second.
+		 */
+		double operationsPerSecond() const;
+		
+		/**
+		 * Print the rates in a human-readable form.
+		 * 
+		 * @param os The output stream.
+		 */
+		void print(std::ostream& os) const;
+	};
+	
+	/**
+	 * IOThrottle limits the bytes and operations per second of the file reads
+	 * and writes done by the library, so that background scans don't starve
+	 * other programs using the same disks.
+	 * 
+	 * The budget is kept in two token buckets, one for bytes and one for
+	 * operations, which are shared by every thread using the throttle. Each
+	 * read or write takes its tokens out of the buckets right away, even if
+	 * that leaves them in debt, and then waits until the buckets would have
+	 * refilled. This way threads are served in the order they asked, a big
+	 * read never has to wait for the bucket to hold all of it at once, and a
+	 * burst of reads is spread out over time instead of being let through.
+	 * 
+	 * A throttle is used by the ID3::Tag constructors, ID3::Tag::write(),
+	 * and the batch scans when it's set on the current thread with an
+	 * ID3::IOThrottle::Scope. ID3::Batch sets it on every worker thread when
+	 * it's given in ID3::BatchOptions.
+	 * 
+	 * NOTE: The bytes metered are the bytes the library asks for. Reads
+	 *       served from the stream's buffer or the page cache are counted all
+	 *       the same.
+	 * 
+	 * Defined in ID3IOThrottle.cpp.
+	 */
+	class IOThrottle {
+		public:
+			/**
+			 * Sets the throttle that the library's reads and writes on the
+			 * current thread are metered with, and the thread's I/O priority,
+			 * until it goes out of scope.
+			 * 
+			 * NOTE: The I/O priority is only set on Linux. If it can't be set,
+			 *       such as the realtime class without the permissions for it,
+			 *       the thread's I/O priority is left unchanged.
+			 */
+			class Scope {
+				public:
+					/**
+					 * @param throttle The throttle, or nullptr to not meter
+					 *                 reads and writes.
+					 */
+					explicit Scope(IOThrottle* throttle);
+					~Scope();
+					
+					Scope(const Scope&) = delete;
+					Scope& operator=(const Scope&) = delete;
+				
+				private:
+					/**
+					 * The throttle that was set on the thread before this one.
+					 */
+					IOThrottle* previous;
+					
+					/**
+					 * The I/O priority the thread had before, or -1 if it wasn't
+					 * changed.
+					 */
+					int previousPriority;
+			};
+			
+			/**
+			 * Create a throttle.
+			 * 
+			 * @param budget The I/O budget.
+			 */
+			explicit IOThrottle(const IOBudget& budget=IOBudget());
+			
+			IOThrottle(const IOThrottle&) = delete;
+			IOThrottle& operator=(const IOThrottle&) = delete;
+			
+			/**
+			 * @return The I/O budget.
+			 */
+			const IOBudget& budget() const;
+			
+			/**
+			 * Take a read or write out of the budget, waiting until there's room
+			 * for it.
+			 * 
+			 * @param bytes      The number of bytes.
+			 * @param operations The number of reads or writes.
+			 */
+			void acquire(const ulong bytes, const ulong operations=1);
+			
+			/**
+			 * @return The I/O done through the throttle since it was created or
+			 *         last reset.
+			 */
+			IORates rates() const;
+			
+			/**
+			 * Reset the rates to start measuring a new run. The buckets are left
+			 * as they are.
+			 */
+			void reset();
+			
+			/**
+			 * @return The throttle set on the current thread, or nullptr if
+			 *         there is none.
+			 */
+			static IOThrottle* current();
+			
+			/**
+			 * Take a read or write out of the budget of the throttle set on the
+			 * current thread. Nothing happens if there is none.
+			 * 
+			 * @param bytes      The number of bytes.
+			 * @param operations The number of reads or writes.
+			 * @see ID3::IOThrottle::acquire(ulong, ulong)
+			 */
+			static void charge(const ulong bytes, const ulong operations=1);
+		
+		private:
+			typedef std::chrono::steady_clock Clock;
+			
+			/**
+			 * The I/O budget.
+			 */
+			const IOBudget ioBudget;
+			
+			/**
+			 * Guards the buckets and the rates.
+			 */
+			mutable std::mutex mutex;
+			
+			/**
+			 * The tokens in the buckets. These are negative when the buckets are
+			 * in debt.
+			 */
+			double byteTokens, operationTokens;
+			
+			/**
+			 * The last time the buckets were refilled.
+			 */
+			Clock::time_point refilled;
+			
+			/**
+			 * The rates since the throttle was created or reset, and the time of
+			 * the first and last read or write.
+			 */
+			IORates ioRates;
+			Clock::time_point first, last;
+	};
+}
+
+#endif
@@ -0,0 +1,274 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <cstring> //For memcmp()
+
+#include "ID3MP4Atoms.hpp"   //For the class definition
+#include "ID3Functions.hpp"  //For byteIntVal() and intToByteArray()
+#include "ID3IOThrottle.hpp" //For IOThrottle::charge()
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The size of a box header with a 32-bit size.
+	 */
+	static const ushort BOX_HEADER_SIZE = 8;
+	
+	/**
+	 * The size of the version and flags at the start of a full box.
+	 */
+	static const ushort FULL_BOX_SIZE = 4;
+	
+	/**
+	 * The bytes in the ID32 box before the ID3v2 tag: the version, flags,
+	 * and the language code.
+	 */
+	static const ushort ID32_PREFIX_SIZE = FULL_BOX_SIZE + 2;
+	
+	/**
+	 * The size of the hdlr box written when creating a meta box: the header,
+	 * version and flags, pre-defined value, handler type, 3 reserved ints,
+	 * and an empty name.
+	 */
+	static const ushort HDLR_BOX_SIZE = BOX_HEADER_SIZE + FULL_BOX_SIZE + 4 + 4 + 12 + 1;
+	
+	/**
+	 * The bytes needed to wrap an ID3v2 tag in a new meta box with a handler.
+	 */
+	static const ushort META_BOX_OVERHEAD = BOX_HEADER_SIZE + FULL_BOX_SIZE + HDLR_BOX_SIZE +
+	                                        BOX_HEADER_SIZE + ID32_PREFIX_SIZE;
+	
+	/**
+	 * The maximum nesting depth to walk, to stop on malformed files.
+	 */
+	static const ushort MAX_DEPTH = 4;
+	
+	/**
+	 * Check if a box should be entered, given the box that holds it.
+	 * 
+	 * @param type   The box type.
+	 * @param parent The parent box type, or "" for the top level.
+	 * @return If the box can hold a meta box with an ID32 box.
+	 */
+	static bool enterBox(const std::string& type, const std::string& parent) {
+		if(type == "meta") return parent.empty() || parent == "moov" || parent == "trak" || parent == "udta";
+		if(parent.empty()) return type == "moov";
+		if(parent == "moov") return type == "trak" || type == "udta";
+		return false;
+	}
+	
+	/**
+	 * Check if a box is free space.
+	 */
+	static bool freeBox(const std::string& type) { return type == "free" || type == "skip"; }
+}
+
+///@pkg ID3MP4Atoms.h
+Atom::Atom(const std::string& type,
+           const ulong        start,
+           const ushort       headerSize,
+           const ulong        size,
+           const ushort       depth) : type(type),
+                                       start(start),
+                                       headerSize(headerSize),
+                                       size(size),
+                                       depth(depth) {}
+
+///@pkg ID3MP4Atoms.h
+ulong Atom::dataStart() const { return start + headerSize; }
+
+///@pkg ID3MP4Atoms.h
+ulong Atom::end() const { return start + size; }
+
+///@pkg ID3MP4Atoms.h
+AtomIndex::AtomIndex() : isMP4(false), id32Index(0), freeIndex(0) {}
+
+///@pkg ID3MP4Atoms.h
+AtomIndex::AtomIndex(std::istream& file, const ulong fileSize) : AtomIndex() {
+	if(fileSize < BOX_HEADER_SIZE) return;
+	
+	//MP4 files start with a file type box
+	uint8_t header[BOX_HEADER_SIZE];
+	file.clear();
+	file.seekg(0, std::ios_base::beg);
+	if(!file) return;
+	IOThrottle::charge(BOX_HEADER_SIZE);
+	file.read(reinterpret_cast<char*>(header), BOX_HEADER_SIZE);
+	if(!file || memcmp(header + 4, "ftyp", 4) != 0) return;
+	
+	isMP4 = true;
+	walk(file, 0, fileSize, "", 0);
+	
+	if(id32Index != 0) {
+		//Use a free box right after the ID32 box, in the same parent box
+		const Atom& id32 = atomList[id32Index - 1];
+		if(id32Index < atomList.size() && freeBox(atomList[id32Index].type) &&
+		   atomList[id32Index].start == id32.end() && atomList[id32Index].depth == id32.depth)
+			freeIndex = id32Index + 1;
+	} else {
+		//Use the biggest top-level free box
+		for(size_t i = 0; i < atomList.size(); i++) {
+			if(atomList[i].depth == 0 && freeBox(atomList[i].type) &&
+			   (freeIndex == 0 || atomList[i].size > atomList[freeIndex - 1].size))
+				freeIndex = i + 1;
+		}
+	}
+	
+	file.clear();
+}
+
+///@pkg ID3MP4Atoms.h
+void AtomIndex::walk(std::istream&      file,
+                     const ulong        start,
+                     const ulong        end,
+                     const std::string& parent,
+                     const ushort       depth) {
+	uint8_t header[16];
+	ulong pos = start;
+	
+	while(pos + BOX_HEADER_SIZE <= end) {
+		//Read the box header
+		file.seekg(pos, std::ios_base::beg);
+		if(!file) return;
+		IOThrottle::charge(BOX_HEADER_SIZE);
+		file.read(reinterpret_cast<char*>(header), BOX_HEADER_SIZE);
+		if(!file) return;
+		
+		const std::string type(reinterpret_cast<char*>(header) + 4, 4);
+		ushort headerSize = BOX_HEADER_SIZE;
+		ulong size = byteIntVal(header, 4);
+		
+		if(size == 1) {
+			//A 64-bit size follows the type
+			if(pos + 16 > end) return;
+			IOThrottle::charge(8);
+			file.read(reinterpret_cast<char*>(header) + BOX_HEADER_SIZE, 8);
+			if(!file) return;
+			size = byteIntVal(header + BOX_HEADER_SIZE, 8);
+			headerSize = 16;
+		} else if(size == 0) {
+			//The box extends to the end of its parent
+			size = end - pos;
+		}
+		
+		//Stop on malformed boxes
+		if(size < headerSize || size > end - pos) return;
+		
+		atomList.emplace_back(type, pos, headerSize, size, depth);
+		
+		if(type == "ID32" && parent == "meta" && id32Index == 0 &&
+		   size >= static_cast<ulong>(headerSize + ID32_PREFIX_SIZE)) {
+			id32Index = atomList.size();
+		} else if(depth < MAX_DEPTH && enterBox(type, parent)) {
+			ulong childStart = pos + headerSize;
+			
+			//The meta box is a full box in MP4 files, but not in QuickTime
+			//files. QuickTime meta boxes start with the hdlr box instead of a
+			//version and flags.
+			if(type == "meta" && childStart + BOX_HEADER_SIZE <= pos + size) {
+				file.seekg(childStart, std::ios_base::beg);
+				IOThrottle::charge(BOX_HEADER_SIZE);
+				file.read(reinterpret_cast<char*>(header), BOX_HEADER_SIZE);
+				if(!file) return;
+				if(memcmp(header + 4, "hdlr", 4) != 0) childStart += FULL_BOX_SIZE;
+			}
+			
+			walk(file, childStart, pos + size, type, depth + 1);
+			if(!file) return;
+		}
+		
+		pos += size;
+	}
+}
+
+///@pkg ID3MP4Atoms.h
+bool AtomIndex::mp4() const { return isMP4; }
+
+///@pkg ID3MP4Atoms.h
+const std::vector<Atom>& AtomIndex::atoms() const { return atomList; }
+
+///@pkg ID3MP4Atoms.h
+const Atom* AtomIndex::id32Atom() const { return id32Index == 0 ? nullptr : &atomList[id32Index - 1]; }
+
+///@pkg ID3MP4Atoms.h
+ulong AtomIndex::id3Start() const {
+	return id32Index == 0 ? 0 : atomList[id32Index - 1].dataStart() + ID32_PREFIX_SIZE;
+}
+
+///@pkg ID3MP4Atoms.h
+ulong AtomIndex::id3Space() const {
+	const ulong freeSize = freeIndex == 0 ? 0 : atomList[freeIndex - 1].size;
+	
+	if(id32Index != 0) {
+		const Atom& id32 = atomList[id32Index - 1];
+		return id32.size - id32.headerSize - ID32_PREFIX_SIZE + freeSize;
+	}
+	
+	//A new meta box needs a 32-bit size
+	return freeSize > META_BOX_OVERHEAD && freeSize <= 0xFFFFFFFFUL ? freeSize - META_BOX_OVERHEAD : 0;
+}
+
+///@pkg ID3MP4Atoms.h
+ulong AtomIndex::tagBoxStart() const {
+	if(id32Index != 0) return atomList[id32Index - 1].start;
+	return freeIndex == 0 ? 0 : atomList[freeIndex - 1].start;
+}
+
+///@pkg ID3MP4Atoms.h
+ulong AtomIndex::tagWriteStart() const {
+	if(id32Index != 0) return id3Start();
+	return freeIndex == 0 ? 0 : atomList[freeIndex - 1].start + META_BOX_OVERHEAD;
+}
+
+///@pkg ID3MP4Atoms.h
+ByteArray AtomIndex::tagBoxHeader(const ulong tagSize) const {
+	ByteArray boxBytes;
+	
+	//Append a box header with a 32-bit size
+	auto addHeader = [&boxBytes](const ulong size, const char* type) {
+		const ByteArray sizeBytes = intToByteArray(size, 4);
+		boxBytes.insert(boxBytes.end(), sizeBytes.begin(), sizeBytes.end());
+		boxBytes.insert(boxBytes.end(), type, type + 4);
+	};
+	
+	if(id32Index != 0) {
+		//Resize the existing ID32 box, keeping its header size and language
+		const Atom& id32 = atomList[id32Index - 1];
+		const ulong newSize = id32.headerSize + ID32_PREFIX_SIZE + tagSize;
+		if(id32.headerSize == BOX_HEADER_SIZE) {
+			addHeader(newSize, "ID32");
+		} else {
+			addHeader(1, "ID32");
+			const ByteArray sizeBytes = intToByteArray(newSize, 8);
+			boxBytes.insert(boxBytes.end(), sizeBytes.begin(), sizeBytes.end());
+		}
+		return boxBytes;
+	}
+	
+	//Turn the free box into a meta box holding a handler and an ID32 box
+	addHeader(META_BOX_OVERHEAD + tagSize, "meta");
+	boxBytes.insert(boxBytes.end(), FULL_BOX_SIZE, 0);
+	
+	addHeader(HDLR_BOX_SIZE, "hdlr");
+	boxBytes.insert(boxBytes.end(), FULL_BOX_SIZE + 4, 0);
+	boxBytes.insert(boxBytes.end(), {'I', 'D', '3', '2'});
+	boxBytes.insert(boxBytes.end(), 12 + 1, 0);
+	
+	addHeader(BOX_HEADER_SIZE + ID32_PREFIX_SIZE + tagSize, "ID32");
+	boxBytes.insert(boxBytes.end(), FULL_BOX_SIZE, 0);
+	//The packed ISO-639-2/T language code "und" (undetermined)
+	boxBytes.insert(boxBytes.end(), {0x55, 0xC4});
+	
+	return boxBytes;
+}
@@ -0,0 +1,188 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_MP4_ATOMS_HPP
+#define ID3_MP4_ATOMS_HPP
+
+#include <istream> //For std::istream
+#include <string>  //For std::string
+#include <vector>  //For std::vector
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * @see ID3.h
+	 */
+	typedef std::vector<uint8_t> ByteArray;
+	
+	/**
+	 * A box (atom) header found in an MP4 (ISO base media) file.
+	 */
+	struct Atom {
+		Atom(const std::string& type,
+		     const ulong        start,
+		     const ushort       headerSize,
+		     const ulong        size,
+		     const ushort       depth);
+		std::string type;  //The 4-character box type
+		ulong start;       //The file position of the box header
+		ushort headerSize; //The size of the box header (8, or 16 for 64-bit sizes)
+		ulong size;        //The size of the box, including the header
+		ushort depth;      //How deep the box is nested, 0 for top-level boxes
+		
+		/**
+		 * @return The file position of the box contents.
+		 */
+		ulong dataStart() const;
+		
+		/**
+		 * @return The file position after the box.
+		 */
+		ulong end() const;
+	};
+	
+	/**
+	 * AtomIndex walks the boxes of an MP4 file that can hold an ID3v2 tag,
+	 * jumping from box header to box header. Only the file, movie (moov), track
+	 * (trak), and user data (udta) levels are entered, so the media data (mdat)
+	 * is never read.
+	 * 
+	 * ID3v2 tags are stored in an ID32 box inside a meta box. The ID32 box
+	 * contents are a version and flags, a 2-byte language code, and then the
+	 * ID3v2 tag.
+	 * 
+	 * NOTE: If the file does not start with an ftyp box, the index will be
+	 *       empty and mp4() will return false.
+	 * 
+	 * Defined in ID3MP4Atoms.cpp.
+	 */
+	class AtomIndex {
+		public:
+			/**
+			 * Index the boxes of a file.
+			 * 
+			 * @param file     The file stream object.
+			 * @param fileSize The size of the file.
+			 */
+			AtomIndex(std::istream& file, const ulong fileSize);
+			
+			/**
+			 * The empty constructor, for a file that isn't an MP4 file.
+			 */
+			AtomIndex();
+			
+			/**
+			 * @return If the file is an MP4 file.
+			 */
+			bool mp4() const;
+			
+			/**
+			 * @return The boxes that were walked, in file order.
+			 */
+			const std::vector<Atom>& atoms() const;
+			
+			/**
+			 * @return The ID32 box, or nullptr if there is none.
+			 */
+			const Atom* id32Atom() const;
+			
+			/**
+			 * @return The file position of the ID3v2 tag in the ID32 box, or 0 if
+			 *         there is no ID32 box.
+			 */
+			ulong id3Start() const;
+			
+			/**
+			 * Get the number of bytes an ID3v2 tag can take up without moving any
+			 * other box. This is the ID32 box's tag space plus a free box right
+			 * after it, or, if there's no ID32 box, the space left in the biggest
+			 * top-level free box after adding a meta box around the tag.
+			 * 
+			 * @return The space available for the tag, or 0 if there is none.
+			 */
+			ulong id3Space() const;
+			
+			/**
+			 * Create the bytes that replace the box header holding the tag: the
+			 * ID32 box header, or a meta box with a handler and ID32 box if a free
+			 * box is being converted. The tag is written at tagWriteStart().
+			 * 
+			 * NOTE: The tag must be exactly id3Space() bytes, so that the boxes
+			 *       after it don't move.
+			 * 
+			 * @param tagSize The size of the ID3v2 tag.
+			 * @return The bytes to write at tagBoxStart().
+			 */
+			ByteArray tagBoxHeader(const ulong tagSize) const;
+			
+			/**
+			 * @return The file position tagBoxHeader() is written to.
+			 */
+			ulong tagBoxStart() const;
+			
+			/**
+			 * @return The file position the tag is written to. This is after the
+			 *         ID32 box's language code.
+			 */
+			ulong tagWriteStart() const;
+		
+		private:
+			/**
+			 * Walk the boxes in a range of the file.
+			 * 
+			 * @param file   The file stream object.
+			 * @param start  The start of the range.
+			 * @param end    The end of the range.
+			 * @param parent The type of the box that holds the range, or "" for
+			 *               the top level.
+			 * @param depth  The nesting depth of the boxes in the range.
+			 */
+			void walk(std::istream&      file,
+			          const ulong        start,
+			          const ulong        end,
+			          const std::string& parent,
+			          const ushort       depth);
+			
+			/**
+			 * If the file is an MP4 file.
+			 */
+			bool isMP4;
+			
+			/**
+			 * The boxes that were walked.
+			 */
+			std::vector<Atom> atomList;
+			
+			/**
+			 * The position of the ID32 box in atomList plus one, or 0.
+			 */
+			size_t id32Index;
+			
+			/**
+			 * The position in atomList plus one of the free box after the ID32
+			 * box, or of the biggest top-level free box if there's no ID32 box.
+			 * 0 if there is none.
+			 */
+			size_t freeIndex;
+	};
+}
+
+#endif
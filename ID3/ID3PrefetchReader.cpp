@@ -0,0 +1,234 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm> //For std::min() and std::max()
+#include <cstring>   //For memcpy()
+
+#include "ID3PrefetchReader.hpp" //For the class definitions
+#include "ID3ByteSource.hpp"     //For ID3::FileByteSource and ID3::ByteSourceStream
+#include "ID3Constants.hpp"      //For HEADER_BYTE_SIZE
+#include "ID3Functions.hpp"      //For byteIntVal() and locateV2Tag()
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * A part of a file read into memory.
+	 */
+	struct Region {
+		ulong start;     //The file position of the first byte
+		ByteArray bytes; //The bytes
+	};
+	
+	/**
+	 * RegionByteSource is a file with some parts of it read into memory. Reads
+	 * of those parts are copied from memory, and reads of the rest of the
+	 * file are read from the file.
+	 * 
+	 * It either owns the parts in memory, or borrows them from a vector that
+	 * has to outlive it.
+	 */
+	class RegionByteSource : public ByteSource {
+		public:
+			RegionByteSource(const std::shared_ptr<const ByteSource>& file, std::vector<Region>&& regions) : file(file),
+			                                                                                                 ownedRegions(std::move(regions)),
+			                                                                                                 regions(&ownedRegions) {}
+			
+			RegionByteSource(const std::shared_ptr<const ByteSource>& file, const std::vector<Region>& regions) : file(file),
+			                                                                                                      regions(&regions) {}
+			
+			RegionByteSource(const RegionByteSource&) = delete;
+			RegionByteSource& operator=(const RegionByteSource&) = delete;
+			
+			virtual ulong size() const { return file->size(); }
+			
+			virtual size_t read(const ulong position, void* buffer, const size_t bytes) const {
+				if(position >= file->size()) return 0;
+				const size_t WANTED = std::min<ulong>(bytes, file->size() - position);
+				
+				//Copy the parts in memory, and read the parts between them
+				size_t done = 0;
+				while(done < WANTED) {
+					const ulong POSITION = position + done;
+					ulong fileEnd = position + WANTED;
+					size_t copied = 0;
+					for(const Region& region : *regions) {
+						if(POSITION >= region.start && POSITION < region.start + region.bytes.size()) {
+							copied = std::min<ulong>(WANTED - done, region.start + region.bytes.size() - POSITION);
+							memcpy(static_cast<char*>(buffer) + done, &region.bytes[POSITION - region.start], copied);
+							break;
+						}
+						if(region.start > POSITION) fileEnd = std::min(fileEnd, region.start);
+					}
+					if(copied == 0) copied = file->read(POSITION, static_cast<char*>(buffer) + done, fileEnd - POSITION);
+					if(copied == 0) break;
+					done += copied;
+				}
+				return done;
+			}
+		
+		private:
+			std::shared_ptr<const ByteSource> file; //The file
+			std::vector<Region> ownedRegions;       //The parts of the file in memory, if they're owned
+			const std::vector<Region>* regions;     //The parts of the file in memory
+	};
+	
+	/**
+	 * Read a part of a file into memory.
+	 * 
+	 * @param file  The file.
+	 * @param start The file position to start at.
+	 * @param end   The file position to end before.
+	 * @return The part of the file, which is shorter if the file ends first.
+	 */
+	Region readRegion(const ByteSource& file, const ulong start, const ulong end) {
+		Region region;
+		region.start = start;
+		region.bytes.resize(end > start ? end - start : 0);
+		if(!region.bytes.empty())
+			region.bytes.resize(file.read(start, &region.bytes.front(), region.bytes.size()));
+		return region;
+	}
+}
+
+///@pkg ID3PrefetchReader.h
+PrefetchOptions::PrefetchOptions() : depth(4),
+                                     threads(1),
+                                     headBytes(64 * 1024),
+                                     tailBytes(16 * 1024),
+                                     maxTagBytes(16 * 1024 * 1024) {}
+
+///@pkg ID3PrefetchReader.h
+PrefetchReader::Prefetched::Prefetched() : ready(false) {}
+
+///@pkg ID3PrefetchReader.h
+PrefetchReader::PrefetchReader(const std::vector<std::string>& files,
+                               const PrefetchOptions&          options) : fileList(files),
+                                                                          readerOptions(options),
+                                                                          slots(std::max(options.depth, 1U)),
+                                                                          nextPrefetch(0),
+                                                                          nextFile(0),
+                                                                          stopping(false) {
+	const size_t THREADS = std::min<size_t>(std::max(options.threads, 1U), std::max<size_t>(files.size(), 1));
+	for(size_t i = 0; i < THREADS; i++)
+		threads.emplace_back(&PrefetchReader::prefetchLoop, this);
+}
+
+///@pkg ID3PrefetchReader.h
+PrefetchReader::~PrefetchReader() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	slotFree.notify_all();
+	for(std::thread& thread : threads) thread.join();
+}
+
+///@pkg ID3PrefetchReader.h
+bool PrefetchReader::next(Tag& tag) {
+	if(nextFile >= fileList.size()) return false;
+	
+	//Wait for the file, then free its slot for the threads reading ahead
+	Prefetched prefetched;
+	const size_t FILE = nextFile;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		Prefetched& slot = slots[FILE % slots.size()];
+		fileReady.wait(lock, [&slot]() { return slot.ready; });
+		prefetched = std::move(slot);
+		slot = Prefetched();
+		nextFile++;
+	}
+	slotFree.notify_all();
+	
+	if(prefetched.error) std::rethrow_exception(prefetched.error);
+	tag = Tag(fileList[FILE], prefetched.source);
+	return true;
+}
+
+///@pkg ID3PrefetchReader.h
+size_t PrefetchReader::position() const { return nextFile > 0 ? nextFile - 1 : fileList.size(); }
+
+///@pkg ID3PrefetchReader.h
+const std::vector<std::string>& PrefetchReader::files() const { return fileList; }
+
+///@pkg ID3PrefetchReader.h
+void PrefetchReader::prefetchLoop() {
+	while(true) {
+		//Wait until there's a file to read and a free slot to read it into
+		size_t file;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			slotFree.wait(lock, [this]() {
+				return stopping || nextPrefetch >= fileList.size() || nextPrefetch < nextFile + slots.size();
+			});
+			if(stopping || nextPrefetch >= fileList.size()) return;
+			file = nextPrefetch++;
+		}
+		
+		Prefetched prefetched;
+		try {
+			prefetched.source = prefetch(fileList[file]);
+		} catch(...) {
+			prefetched.error = std::current_exception();
+		}
+		prefetched.ready = true;
+		
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			slots[file % slots.size()] = std::move(prefetched);
+		}
+		fileReady.notify_one();
+	}
+}
+
+///@pkg ID3PrefetchReader.h
+std::shared_ptr<const ByteSource> PrefetchReader::prefetch(const std::string& fileLoc) const {
+	const std::shared_ptr<const ByteSource> file = std::make_shared<FileByteSource>(fileLoc); //Throws FileNotFoundException
+	const ulong FILE_SIZE = file->size();
+	std::vector<Region> regions;
+	
+	//The start of the file has the ID3v2 tag of MP3 files, and the chunk and
+	//box headers of WAV, AIFF, and MP4 files
+	regions.push_back(readRegion(*file, 0, std::min(readerOptions.headBytes, FILE_SIZE)));
+	
+	//The end of the file has the tags after the audio data. If the head and
+	//the tail overlap, the tail starts where the head ends.
+	const ulong HEAD_END = regions.front().bytes.size(),
+	            TAIL_START = std::max(FILE_SIZE - std::min(readerOptions.tailBytes, FILE_SIZE), HEAD_END);
+	if(TAIL_START < FILE_SIZE)
+		regions.push_back(readRegion(*file, TAIL_START, FILE_SIZE));
+	
+	//Find the ID3v2 tag the same way ID3::Tag does, reading through the parts
+	//already in memory, and read the whole tag. The source used to find it
+	//borrows the regions, so it's gone before the tag is added to them.
+	Region tag;
+	{
+		const std::shared_ptr<const ByteSource> head = std::make_shared<RegionByteSource>(file, static_cast<const std::vector<Region>&>(regions));
+		ByteSourceStream stream(head);
+		ulong tagStart, tagLimit;
+		uint8_t header[HEADER_BYTE_SIZE];
+		if(locateV2Tag(stream, FILE_SIZE, tagStart, tagLimit) &&
+		   head->read(tagStart, header, HEADER_BYTE_SIZE) == HEADER_BYTE_SIZE &&
+		   header[0] == 'I' && header[1] == 'D' && header[2] == '3') {
+			//Add the footer if the footer flag is set
+			const ulong TAG_END = std::min(tagLimit, tagStart + HEADER_BYTE_SIZE * ((header[5] & 0x10) ? 2 : 1) +
+			                                         static_cast<ulong>(byteIntVal(&header[6], 4, true)));
+			if(TAG_END > HEAD_END && TAG_END - tagStart <= readerOptions.maxTagBytes)
+				tag = readRegion(*file, tagStart, TAG_END);
+		}
+	}
+	if(!tag.bytes.empty()) regions.push_back(std::move(tag));
+	
+	return std::make_shared<RegionByteSource>(file, std::move(regions));
+}
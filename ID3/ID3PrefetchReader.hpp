@@ -0,0 +1,178 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_PREFETCH_READER_HPP
+#define ID3_PREFETCH_READER_HPP
+
+#include <condition_variable> //For std::condition_variable
+#include <exception>          //For std::exception_ptr
+#include <memory>             //For std::shared_ptr
+#include <mutex>              //For std::mutex
+#include <string>             //For std::string
+#include <thread>             //For std::thread
+#include <vector>             //For std::vector
+
+#include "ID3.hpp" //For ID3::Tag
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * Options for an ID3::PrefetchReader.
+	 */
+	struct PrefetchOptions {
+		PrefetchOptions();
+		unsigned depth;    //The most files read ahead of the one being parsed (4)
+		unsigned threads;  //The number of threads reading ahead (1)
+		ulong headBytes;   //The bytes read from the start of each file, for the WAV, AIFF, and MP4 indexes (64 KiB)
+		ulong tailBytes;   //The bytes read from the end of each file, for the ID3v1, APE, and Lyrics3 tags (16 KiB)
+		ulong maxTagBytes; //The biggest ID3v2 tag read ahead. Bigger tags are read when they're parsed (16 MiB)
+	};
+	
+	/**
+	 * PrefetchReader reads the Tags of a list of files in order, one at a
+	 * time, while background threads read the next files into memory. This
+	 * lets a single-threaded program parse one file while the next ones are
+	 * being read, without running its own work on a thread pool.
+	 * 
+	 * The threads read the start and end of each file and the whole ID3v2
+	 * tag, wherever it is in the file. The Tag is then parsed from those
+	 * bytes on the thread that calls next(), and anything else the parser
+	 * needs is read from the file then.
+	 * 
+	 * NOTE: PrefetchReaders need to be compiled with -pthread. Files are read
+	 *       when they're prefetched, so a file that changes before next()
+	 *       returns it may give the old tag.
+	 * 
+	 * Defined in ID3PrefetchReader.cpp.
+	 */
+	class PrefetchReader {
+		public:
+			/**
+			 * Create a reader, and start reading the first files.
+			 * 
+			 * @param files   The file paths.
+			 * @param options The reader options.
+			 */
+			PrefetchReader(const std::vector<std::string>& files, const PrefetchOptions& options=PrefetchOptions());
+			
+			/**
+			 * Stops the threads reading ahead.
+			 */
+			~PrefetchReader();
+			
+			PrefetchReader(const PrefetchReader&) = delete;
+			PrefetchReader& operator=(const PrefetchReader&) = delete;
+			
+			/**
+			 * Read the Tag of the next file, waiting for the file to be read if
+			 * it hasn't been yet.
+			 * 
+			 * NOTE: If the file can't be read, the exception is thrown and the
+			 *       reader moves on, so the next call reads the file after it.
+			 * 
+			 * @param tag The Tag to set to the file's tags.
+			 * @return False if every file has been read, and true otherwise.
+			 * @throws The same exceptions as ID3::Tag::Tag(std::string&).
+			 */
+			bool next(Tag& tag);
+			
+			/**
+			 * @return The position in the file list of the file the last call of
+			 *         next() read, or the number of files if next() hasn't been
+			 *         called.
+			 */
+			size_t position() const;
+			
+			/**
+			 * @return The file paths.
+			 */
+			const std::vector<std::string>& files() const;
+		
+		private:
+			/**
+			 * A file read ahead.
+			 */
+			struct Prefetched {
+				Prefetched();
+				std::shared_ptr<const ByteSource> source; //The file, with the parts read ahead in memory
+				std::exception_ptr error;                 //The exception reading the file threw
+				bool ready;                               //If the file has been read
+			};
+			
+			/**
+			 * The loop each thread reading ahead runs, until every file has been
+			 * read or the reader is destroyed.
+			 */
+			void prefetchLoop();
+			
+			/**
+			 * Read the parts of a file the parser needs.
+			 * 
+			 * @param fileLoc The file path.
+			 * @return The file, with the parts read ahead in memory.
+			 */
+			std::shared_ptr<const ByteSource> prefetch(const std::string& fileLoc) const;
+			
+			/**
+			 * The file paths.
+			 */
+			std::vector<std::string> fileList;
+			
+			/**
+			 * The reader options.
+			 */
+			PrefetchOptions readerOptions;
+			
+			/**
+			 * The files read ahead, with file i in slot i % depth.
+			 */
+			std::vector<Prefetched> slots;
+			
+			/**
+			 * The position of the next file to read ahead, and the position of
+			 * the next file next() returns.
+			 */
+			size_t nextPrefetch, nextFile;
+			
+			/**
+			 * If the reader is being destroyed.
+			 */
+			bool stopping;
+			
+			/**
+			 * The lock on the slots, positions, and stopping.
+			 */
+			std::mutex mutex;
+			
+			/**
+			 * Signals the threads reading ahead that a slot is free, and next()
+			 * that a file has been read.
+			 */
+			std::condition_variable slotFree, fileReady;
+			
+			/**
+			 * The threads reading ahead.
+			 */
+			std::vector<std::thread> threads;
+	};
+}
+
+#endif
@@ -0,0 +1,306 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm> //For std::sort() and std::min()
+#include <atomic>    //For std::atomic
+#include <chrono>    //For std::chrono::steady_clock
+#include <cstring>   //For memcpy() and strsignal()
+#include <exception> //For std::exception
+#include <new>       //For placement new
+#include <thread>    //For std::thread and std::this_thread::sleep_for()
+
+#include <signal.h>   //For kill() and SIGKILL
+#include <sys/mman.h> //For mmap() and munmap()
+#include <sys/wait.h> //For waitpid()
+#include <unistd.h>   //For fork() and _exit()
+#ifdef __linux__
+#include <sys/prctl.h> //For prctl()
+#endif
+
+#include "ID3ProcessBatch.hpp" //For the class definition
+#include "ID3Exception.hpp"    //For Exception
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The result of a file in a worker's result buffer.
+	 */
+	struct ResultHeader {
+		uint64_t file;   //The position of the file in the batch
+		uint32_t failed; //1 if the result is an exception message, 0 otherwise
+		uint32_t size;   //The size of the result that follows
+	};
+	
+	/**
+	 * A worker's state in shared memory, followed by its result buffer.
+	 */
+	struct WorkerSlot {
+		std::atomic<uint64_t> current; //The position of the file the worker is on plus 1, or 0 between files
+		std::atomic<int64_t> started;  //When the worker started the current file, in steady clock nanoseconds
+		std::atomic<uint64_t> head;    //The total bytes written to the result buffer
+		std::atomic<uint64_t> tail;    //The total bytes read from the result buffer
+	};
+	
+	/**
+	 * The shared memory of a batch: the next file counter, then each
+	 * worker's slot and result buffer.
+	 */
+	struct SharedBatch {
+		std::atomic<uint64_t> nextFile; //The next file to take
+	};
+	
+	/**
+	 * How long the parent sleeps when there's nothing to do, and how long a
+	 * worker sleeps when its result buffer is full.
+	 */
+	const std::chrono::microseconds POLL_INTERVAL(200);
+	
+	/**
+	 * @return The steady clock time in nanoseconds, which is the same in every
+	 *         process on the system.
+	 */
+	int64_t now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+	
+	/**
+	 * Round a size up to a multiple of 64, so that every slot starts on its
+	 * own cache line.
+	 */
+	size_t cacheAligned(const size_t size) { return (size + 63) / 64 * 64; }
+	
+	/**
+	 * Copy bytes into a ring buffer, wrapping around the end.
+	 */
+	void ringWrite(uint8_t* ring, const size_t capacity, const uint64_t pos, const void* data, const size_t size) {
+		const size_t START = pos % capacity, FIRST = std::min(size, capacity - START);
+		memcpy(ring + START, data, FIRST);
+		memcpy(ring, static_cast<const uint8_t*>(data) + FIRST, size - FIRST);
+	}
+	
+	/**
+	 * Copy bytes out of a ring buffer, wrapping around the end.
+	 */
+	void ringRead(const uint8_t* ring, const size_t capacity, const uint64_t pos, void* data, const size_t size) {
+		const size_t START = pos % capacity, FIRST = std::min(size, capacity - START);
+		memcpy(data, ring + START, FIRST);
+		memcpy(static_cast<uint8_t*>(data) + FIRST, ring, size - FIRST);
+	}
+	
+	/**
+	 * Write a result to a worker's result buffer, waiting for the parent to
+	 * make room. Results too big for the buffer are replaced by an error.
+	 */
+	void sendResult(WorkerSlot* slot, uint8_t* ring, const size_t capacity,
+	                const size_t file, bool failed, std::string result) {
+		if(sizeof(ResultHeader) + result.size() > capacity) {
+			failed = true;
+			result = "The result is bigger than the result buffer!";
+		}
+		const ResultHeader header = {file, failed ? 1U : 0U, static_cast<uint32_t>(result.size())};
+		const size_t SIZE = sizeof(ResultHeader) + result.size();
+		
+		const uint64_t HEAD = slot->head.load(std::memory_order_relaxed);
+		while(capacity - (HEAD - slot->tail.load(std::memory_order_acquire)) < SIZE)
+			std::this_thread::sleep_for(POLL_INTERVAL);
+		ringWrite(ring, capacity, HEAD, &header, sizeof(ResultHeader));
+		ringWrite(ring, capacity, HEAD + sizeof(ResultHeader), result.data(), result.size());
+		slot->head.store(HEAD + SIZE, std::memory_order_release);
+	}
+	
+	/**
+	 * The loop a worker process runs until there are no files left.
+	 */
+	void workerLoop(SharedBatch* shared, WorkerSlot* slot, uint8_t* ring, const size_t capacity,
+	                const size_t files, const ProcessBatch::Task& task) {
+		for(uint64_t file = shared->nextFile++; file < files; file = shared->nextFile++) {
+			slot->started.store(now());
+			slot->current.store(file + 1);
+			try {
+				sendResult(slot, ring, capacity, file, false, task(file));
+			} catch(const std::exception& e) {
+				sendResult(slot, ring, capacity, file, true, e.what());
+			} catch(...) {
+				sendResult(slot, ring, capacity, file, true, "Unknown exception");
+			}
+			slot->current.store(0);
+		}
+	}
+}
+
+///@pkg ID3ProcessBatch.h
+ProcessBatchOptions::ProcessBatchOptions() : processes(0),
+                                             timeout(10000),
+                                             resultBufferSize(1024 * 1024) {}
+
+///@pkg ID3ProcessBatch.h
+ProcessBatch::ProcessBatch(const std::vector<std::string>& files,
+                           const ProcessBatchOptions&      options) : fileList(files),
+                                                                      batchOptions(options) {}
+
+///@pkg ID3ProcessBatch.h
+const std::vector<std::string>& ProcessBatch::files() const { return fileList; }
+
+///@pkg ID3ProcessBatch.h
+unsigned ProcessBatch::workers() const {
+	unsigned processes = batchOptions.processes != 0 ? batchOptions.processes : std::thread::hardware_concurrency();
+	if(processes > fileList.size()) processes = fileList.size();
+	return processes == 0 ? 1 : processes;
+}
+
+///@pkg ID3ProcessBatch.h
+std::vector<BatchError> ProcessBatch::run(const Task& task, const Collect& collect) const {
+	std::vector<BatchError> errors;
+	if(fileList.empty()) return errors;
+	
+	//Map the shared memory before forking, so every worker shares it
+	const unsigned WORKERS = workers();
+	const size_t CAPACITY = std::max<size_t>(batchOptions.resultBufferSize, sizeof(ResultHeader) + 64);
+	const size_t HEADER_SIZE = cacheAligned(sizeof(SharedBatch));
+	const size_t SLOT_SIZE = cacheAligned(sizeof(WorkerSlot) + CAPACITY);
+	const size_t MAP_SIZE = HEADER_SIZE + SLOT_SIZE * WORKERS;
+	void* const memory = mmap(nullptr, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if(memory == MAP_FAILED) throw Exception("Cannot map the shared memory for the worker processes!");
+	
+	uint8_t* const BASE = static_cast<uint8_t*>(memory);
+	SharedBatch* const shared = new(BASE) SharedBatch();
+	shared->nextFile.store(0);
+	std::vector<WorkerSlot*> slots(WORKERS);
+	std::vector<uint8_t*> rings(WORKERS);
+	std::vector<pid_t> pids(WORKERS, -1);
+	std::vector<uint64_t> lastResult(WORKERS, 0); //The last file each worker sent a result for, plus 1
+	for(unsigned worker = 0; worker < WORKERS; worker++) {
+		slots[worker] = new(BASE + HEADER_SIZE + SLOT_SIZE * worker) WorkerSlot();
+		rings[worker] = reinterpret_cast<uint8_t*>(slots[worker]) + sizeof(WorkerSlot);
+	}
+	
+	//Fork a worker into a slot
+	const auto startWorker = [&](const unsigned worker) {
+		WorkerSlot* const slot = slots[worker];
+		slot->current.store(0);
+		slot->head.store(0);
+		slot->tail.store(0);
+		const pid_t pid = fork();
+		if(pid == 0) {
+			#ifdef __linux__
+			//Don't outlive the parent
+			prctl(PR_SET_PDEATHSIG, SIGKILL);
+			#endif
+			workerLoop(shared, slot, rings[worker], CAPACITY, fileList.size(), task);
+			_exit(0);
+		}
+		pids[worker] = pid;
+		return pid > 0;
+	};
+	
+	//Read a worker's finished results
+	const auto drain = [&](const unsigned worker) {
+		WorkerSlot* const slot = slots[worker];
+		bool drained = false;
+		uint64_t tail = slot->tail.load(std::memory_order_relaxed);
+		while(tail < slot->head.load(std::memory_order_acquire)) {
+			ResultHeader header;
+			ringRead(rings[worker], CAPACITY, tail, &header, sizeof(ResultHeader));
+			std::string result(header.size, '\0');
+			if(header.size > 0) ringRead(rings[worker], CAPACITY, tail + sizeof(ResultHeader), &result[0], header.size);
+			tail += sizeof(ResultHeader) + header.size;
+			slot->tail.store(tail, std::memory_order_release);
+			
+			lastResult[worker] = header.file + 1;
+			drained = true;
+			if(header.failed) {
+				errors.emplace_back(header.file, result);
+			} else {
+				try {
+					collect(header.file, result);
+				} catch(const std::exception& e) {
+					errors.emplace_back(header.file, e.what());
+				} catch(...) {
+					errors.emplace_back(header.file, "Unknown exception");
+				}
+			}
+		}
+		return drained;
+	};
+	
+	//Report the file a dead worker was on, unless it sent its result first
+	const auto reportLostFile = [&](const unsigned worker, const std::string& message) {
+		const uint64_t CURRENT = slots[worker]->current.load();
+		if(CURRENT != 0 && CURRENT != lastResult[worker])
+			errors.emplace_back(CURRENT - 1, message);
+	};
+	
+	for(unsigned worker = 0; worker < WORKERS; worker++) {
+		if(!startWorker(worker)) {
+			for(const pid_t pid : pids) {
+				if(pid <= 0) continue;
+				kill(pid, SIGKILL);
+				waitpid(pid, nullptr, 0);
+			}
+			munmap(memory, MAP_SIZE);
+			throw Exception("Cannot fork the worker processes!");
+		}
+	}
+	
+	//Read results, and watch for workers that time out or die, until every
+	//worker has exited
+	const int64_t TIMEOUT = static_cast<int64_t>(batchOptions.timeout) * 1000000;
+	unsigned running = WORKERS;
+	while(running > 0) {
+		bool busy = false;
+		for(unsigned worker = 0; worker < WORKERS; worker++) {
+			if(pids[worker] <= 0) continue;
+			busy = drain(worker) || busy;
+			
+			//Kill the worker if it's been on the same file for too long
+			bool timedOut = false;
+			const uint64_t CURRENT = slots[worker]->current.load();
+			if(TIMEOUT > 0 && CURRENT != 0 && now() - slots[worker]->started.load() > TIMEOUT) {
+				kill(pids[worker], SIGKILL);
+				timedOut = true;
+			}
+			
+			int status;
+			if(waitpid(pids[worker], &status, timedOut ? 0 : WNOHANG) != pids[worker]) continue;
+			busy = true;
+			drain(worker);
+			if(timedOut) {
+				reportLostFile(worker, "Timed out after " + std::to_string(batchOptions.timeout) + " ms");
+			} else if(WIFSIGNALED(status)) {
+				reportLostFile(worker, std::string("Worker process killed by signal: ") + strsignal(WTERMSIG(status)));
+			} else {
+				reportLostFile(worker, "Worker process exited with status " + std::to_string(WEXITSTATUS(status)));
+			}
+			
+			//Replace the worker if there are files left
+			pids[worker] = -1;
+			running--;
+			if(shared->nextFile.load() < fileList.size()) {
+				if(startWorker(worker)) {
+					running++;
+				} else if(running == 0) {
+					for(size_t file = shared->nextFile.load(); file < fileList.size(); file++)
+						errors.emplace_back(file, "Cannot fork a worker process!");
+				}
+			}
+		}
+		if(!busy) std::this_thread::sleep_for(POLL_INTERVAL);
+	}
+	
+	munmap(memory, MAP_SIZE);
+	std::sort(errors.begin(), errors.end(), [](const BatchError& first, const BatchError& second) {
+		return first.file < second.file;
+	});
+	return errors;
+}
@@ -0,0 +1,128 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_PROCESS_BATCH_HPP
+#define ID3_PROCESS_BATCH_HPP
+
+#include <functional> //For std::function
+#include <string>     //For std::string
+#include <vector>     //For std::vector
+
+#include "ID3Batch.hpp" //For BatchError
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * Options for running a task over many files in worker processes.
+	 */
+	struct ProcessBatchOptions {
+		ProcessBatchOptions();
+		unsigned processes;      //The number of worker processes, or 0 for the number of hardware threads
+		unsigned timeout;        //The milliseconds a worker can spend on one file before it's killed, or 0 for no limit (10000)
+		size_t resultBufferSize; //The size of each worker's shared-memory result buffer, in bytes (1 MiB)
+	};
+	
+	/**
+	 * ProcessBatch runs a task over a list of files in a pool of forked worker
+	 * processes, so a file that crashes or hangs the task only costs itself.
+	 * 
+	 * Workers take the next file from a counter in shared memory as soon as
+	 * they finish one, the same way as ID3::Batch, and send each result back
+	 * through a ring buffer in shared memory that only they write to. The
+	 * parent process reads the buffers, and gives each result to the collect
+	 * function in the parent.
+	 * 
+	 * If a worker spends longer than the timeout on a file, it's killed. If a
+	 * worker dies, such as from a segmentation fault, the file it was on is
+	 * reported as an error, and a new worker is forked to take its place.
+	 * 
+	 * NOTE: The task runs in a copy of the process, so anything it changes
+	 *       other than its result is lost. Workers don't share an
+	 *       ID3::IOThrottle, since a throttle can't be shared between
+	 *       processes. This needs fork(), so it only works on POSIX systems.
+	 * 
+	 * Defined in ID3ProcessBatch.cpp.
+	 */
+	class ProcessBatch {
+		public:
+			/**
+			 * The task to run on each file in a worker process. Exceptions are
+			 * caught and reported as errors.
+			 * 
+			 * @param file The position of the file in the batch.
+			 * @return The result, as bytes for the collect function.
+			 */
+			typedef std::function<std::string(const size_t file)> Task;
+			
+			/**
+			 * The function given each result in the parent process. It's only
+			 * called from the thread that called run().
+			 * 
+			 * @param file   The position of the file in the batch.
+			 * @param result The result the task returned.
+			 */
+			typedef std::function<void(const size_t file, const std::string& result)> Collect;
+			
+			/**
+			 * Create a batch.
+			 * 
+			 * @param files   The file paths.
+			 * @param options The batch options.
+			 */
+			ProcessBatch(const std::vector<std::string>& files, const ProcessBatchOptions& options=ProcessBatchOptions());
+			
+			/**
+			 * @return The file paths.
+			 */
+			const std::vector<std::string>& files() const;
+			
+			/**
+			 * @return The number of workers run() will use. This is never more
+			 *         than the number of files, and at least 1.
+			 */
+			unsigned workers() const;
+			
+			/**
+			 * Run a task over every file, and wait for it to finish.
+			 * 
+			 * @param task    The task.
+			 * @param collect The function given each result.
+			 * @return The files the task threw an exception on, timed out on,
+			 *         or crashed on, in file order.
+			 * @throws ID3::Exception if the shared memory can't be mapped or a
+			 *         worker can't be forked.
+			 */
+			std::vector<BatchError> run(const Task& task, const Collect& collect) const;
+		
+		private:
+			/**
+			 * The file paths.
+			 */
+			std::vector<std::string> fileList;
+			
+			/**
+			 * The batch options.
+			 */
+			ProcessBatchOptions batchOptions;
+	};
+}
+
+#endif
@@ -0,0 +1,325 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <cstring>          //For memmem() and memcmp()
+#include <fstream>          //For std::ifstream
+#include <unicode/unistr.h> //For icu::UnicodeString
+
+#include "ID3Search.hpp"          //For the class definition
+#include "ID3Functions.hpp"       //For byteIntVal(), getUTF8String(), latin1toutf8(), and locateV2Tag()
+#include "ID3Constants.hpp"       //For HEADER_BYTE_SIZE, MAX_TAG_SIZE, and the ID3v1 sizes
+#include "ID3Exception.hpp"       //For FileNotFoundException
+#include "ID3IOThrottle.hpp"      //For IOThrottle::charge()
+#include "Frames/ID3Frame.hpp"    //For FrameEncoding and the frame flags
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * Change the ASCII letters of a byte range to lower case.
+	 * The loop has no branches, so that the compiler can vectorize it.
+	 * 
+	 * @param bytes The bytes to change.
+	 * @param size  The number of bytes.
+	 */
+	static void foldASCII(uint8_t* bytes, const ulong size) {
+		for(ulong i = 0; i < size; i++)
+			bytes[i] |= static_cast<uint8_t>(static_cast<uint8_t>(bytes[i] - 'A') < 26) << 5;
+	}
+	
+	/**
+	 * Remove unsynchronisation from a byte range by removing each 0x00 byte
+	 * after a 0xFF byte.
+	 * 
+	 * @param bytes The bytes to resynchronise.
+	 * @param size  The number of bytes.
+	 * @return The resynchronised bytes.
+	 */
+	static ByteArray resynchronise(const uint8_t* bytes, const ulong size) {
+		ByteArray resynced;
+		resynced.reserve(size);
+		for(ulong i = 0; i < size; i++) {
+			resynced.push_back(bytes[i]);
+			if(bytes[i] == 0xFF && i + 1 < size && bytes[i+1] == 0x00) i++;
+		}
+		return resynced;
+	}
+	
+	/**
+	 * Check if a frame holds text that should be searched.
+	 * 
+	 * @param id      The frame ID bytes.
+	 * @param version The ID3v2 major version.
+	 * @return The position of the text after the encoding byte in the frame
+	 *         body, or 0 if the frame isn't a text frame.
+	 */
+	static ulong textFrameStart(const char* id, const ushort version) {
+		if(id[0] == 'T') return 1;
+		if(version <= 2)
+			return memcmp(id, "COM", 3) == 0 || memcmp(id, "ULT", 3) == 0 ? 4 : 0;
+		return memcmp(id, "COMM", 4) == 0 || memcmp(id, "USLT", 4) == 0 ? 4 : 0;
+	}
+}
+
+///@pkg ID3Search.h
+SearchMatch::SearchMatch(const FrameID& frame, const std::string& text) : frame(frame), text(text) {}
+
+///@pkg ID3Search.h
+TagSearch::TagSearch(const std::string& query, const bool ignoreCase) : utf8Query(query), foldCase(ignoreCase) {
+	if(foldCase) foldASCII(reinterpret_cast<uint8_t*>(&utf8Query[0]), utf8Query.size());
+	
+	const icu::UnicodeString unicodeQuery = icu::UnicodeString::fromUTF8(utf8Query);
+	
+	//LATIN-1, only if every character fits in one byte
+	bool latin1 = true;
+	for(int32_t i = 0; i < unicodeQuery.length(); i++) {
+		const UChar character = unicodeQuery.charAt(i);
+		if(character > 0xFF) { latin1 = false; break; }
+		encodedQueries[ENCODING_LATIN1].push_back(static_cast<uint8_t>(character));
+	}
+	if(!latin1) encodedQueries[ENCODING_LATIN1].clear();
+	
+	//UTF-16 little endian (the usual byte order with a BOM) and big endian
+	for(int32_t i = 0; i < unicodeQuery.length(); i++) {
+		const UChar character = unicodeQuery.charAt(i);
+		encodedQueries[ENCODING_UTF16BOM].push_back(character & 0xFF);
+		encodedQueries[ENCODING_UTF16BOM].push_back(character >> 8);
+		encodedQueries[ENCODING_UTF16].push_back(character >> 8);
+		encodedQueries[ENCODING_UTF16].push_back(character & 0xFF);
+	}
+	
+	//UTF-8
+	encodedQueries[ENCODING_UTF8].assign(utf8Query.begin(), utf8Query.end());
+	
+	//The encoded queries go through the same folding as the frame bodies
+	if(foldCase) {
+		for(ByteArray& encodedQuery : encodedQueries)
+			if(!encodedQuery.empty()) foldASCII(&encodedQuery.front(), encodedQuery.size());
+	}
+}
+
+///@pkg ID3Search.h
+std::vector<SearchMatch> TagSearch::search(const std::string& fileLoc) const {
+	std::ifstream file(fileLoc, std::ios::in | std::ios::binary | std::ios::ate);
+	if(!file.is_open())
+		throw FileNotFoundException("File \"" + fileLoc + "\" cannot be opened!\n");
+	return search(file, file.tellg());
+}
+
+///@pkg ID3Search.h
+bool TagSearch::matches(const std::string& fileLoc) const {
+	std::ifstream file(fileLoc, std::ios::in | std::ios::binary | std::ios::ate);
+	if(!file.is_open())
+		throw FileNotFoundException("File \"" + fileLoc + "\" cannot be opened!\n");
+	return !search(file, file.tellg(), true).empty();
+}
+
+///@pkg ID3Search.h
+std::vector<SearchMatch> TagSearch::search(std::istream& file,
+                                           const ulong   fileSize,
+                                           const bool    firstOnly) const {
+	std::vector<SearchMatch> matches;
+	if(utf8Query.empty()) return matches;
+	
+	ulong tagStart, tagLimit;
+	ByteArray tag;
+	//The ID3v2 header: "ID3", the major and minor versions, the flags, and
+	//the synchsafe tag size
+	uint8_t tagHeader[10];
+	
+	//Read the whole ID3v2 tag with one read
+	if(locateV2Tag(file, fileSize, tagStart, tagLimit) && tagStart + HEADER_BYTE_SIZE <= tagLimit) {
+		file.clear();
+		file.seekg(tagStart, std::ios_base::beg);
+		IOThrottle::charge(HEADER_BYTE_SIZE);
+		file.read(reinterpret_cast<char*>(tagHeader), HEADER_BYTE_SIZE);
+		
+		const ulong TAG_SIZE = byteIntVal(tagHeader + 6, 4, true);
+		if(file && memcmp(tagHeader, "ID3", 3) == 0 &&
+		   tagHeader[3] >= MIN_SUPPORTED_VERSION && tagHeader[3] <= MAX_SUPPORTED_VERSION &&
+		   TAG_SIZE <= MAX_TAG_SIZE && tagStart + HEADER_BYTE_SIZE + TAG_SIZE <= tagLimit) {
+			tag.resize(TAG_SIZE);
+			IOThrottle::charge(TAG_SIZE);
+			if(TAG_SIZE > 0) file.read(reinterpret_cast<char*>(&tag.front()), TAG_SIZE);
+			if(!file) tag.clear();
+		}
+	}
+	
+	if(!tag.empty()) {
+		const ushort VERSION = tagHeader[3];
+		
+		//Unsynchronisation applies to the whole tag before ID3v2.4
+		if(VERSION <= 3 && (tagHeader[5] & FLAG_UNSYNCHRONISATION))
+			tag = resynchronise(&tag.front(), tag.size());
+		
+		const ulong TAG_END      = tag.size(),
+		            FRAME_HEADER = VERSION <= 2 ? 6 : HEADER_BYTE_SIZE;
+		ulong pos = 0;
+		
+		//Skip the extended header. Its size includes the size field in
+		//ID3v2.4, but not in ID3v2.3.
+		if(tagHeader[5] & FLAG_EXT_HEADER) {
+			if(VERSION <= 2 || TAG_END < 4) return matches;
+			pos = VERSION >= 4 ? byteIntVal(&tag[0], 4, true) : 4 + byteIntVal(&tag[0], 4);
+		}
+		
+		//Walk the frame headers
+		while(pos + FRAME_HEADER <= TAG_END && tag[pos] != '\0') {
+			const char* id = reinterpret_cast<const char*>(&tag[pos]);
+			const ulong size = VERSION <= 2 ? byteIntVal(&tag[pos + 3], 3) :
+			                                  byteIntVal(&tag[pos + 4], 4, VERSION >= 4);
+			if(size > TAG_END - pos - FRAME_HEADER) break;
+			
+			const uint8_t* body = &tag[pos + FRAME_HEADER];
+			ulong bodySize = size;
+			const ulong textStart = textFrameStart(id, VERSION);
+			pos += FRAME_HEADER + size;
+			
+			if(textStart == 0) continue;
+			
+			//Get past the frame flags' extra bytes, and skip compressed and
+			//encrypted frames
+			ByteArray resynced;
+			if(VERSION == 3) {
+				const uint8_t flags = reinterpret_cast<const uint8_t*>(id)[9];
+				if(flags & (Frame::FLAG2_COMPRESSED_V3 | Frame::FLAG2_ENCRYPTED_V3)) continue;
+				if(flags & Frame::FLAG2_GROUPING_IDENTITY_V3) {
+					if(bodySize < 1) continue;
+					body++, bodySize--;
+				}
+			} else if(VERSION >= 4) {
+				const uint8_t flags = reinterpret_cast<const uint8_t*>(id)[9];
+				if(flags & (Frame::FLAG2_COMPRESSED_V4 | Frame::FLAG2_ENCRYPTED_V4)) continue;
+				const ulong extraBytes = ((flags & Frame::FLAG2_GROUPING_IDENTITY_V4) ? 1 : 0) +
+				                         ((flags & Frame::FLAG2_DATA_LENGTH_INDICATOR_V4) ? 4 : 0);
+				if(bodySize < extraBytes) continue;
+				body += extraBytes, bodySize -= extraBytes;
+				if(flags & Frame::FLAG2_UNSYNCHRONISED_V4) {
+					resynced = resynchronise(body, bodySize);
+					body = resynced.empty() ? body : &resynced.front();
+					bodySize = resynced.size();
+				}
+			}
+			
+			const FrameID frameID = VERSION <= 2 ? FrameID(std::string(id, 3), VERSION) : FrameID(std::string(id, 4));
+			if(scanFrame(body, bodySize, textStart, frameID, matches) && firstOnly)
+				return matches;
+		}
+	}
+	
+	//Search the ID3v1 and ID3v1 Extended text fields, which are LATIN-1
+	const ushort V1_READ_SIZE = V1::BYTE_SIZE + V1::EXTENDED_BYTE_SIZE;
+	if(fileSize >= V1::BYTE_SIZE && !encodedQueries[ENCODING_LATIN1].empty()) {
+		const ulong readSize = fileSize >= V1_READ_SIZE ? V1_READ_SIZE : V1::BYTE_SIZE;
+		ByteArray tail(readSize, '\0');
+		file.clear();
+		file.seekg(fileSize - readSize, std::ios_base::beg);
+		IOThrottle::charge(readSize);
+		file.read(reinterpret_cast<char*>(&tail.front()), readSize);
+		
+		const uint8_t* v1 = &tail[readSize - V1::BYTE_SIZE];
+		if(file && memcmp(v1, "TAG", 3) == 0) {
+			//The fields are title, artist, album, and comment
+			struct V1Field { ulong start; ulong length; Frames frame; };
+			const V1Field fields[] = {{3, 30, FRAME_TITLE}, {33, 30, FRAME_ARTIST}, {63, 30, FRAME_ALBUM}, {97, 30, FRAME_COMMENT}};
+			const V1Field extFields[] = {{4, 60, FRAME_TITLE}, {64, 60, FRAME_ARTIST}, {124, 60, FRAME_ALBUM}};
+			
+			for(const V1Field& field : fields) {
+				//Search the field as a frame body, with a LATIN-1 encoding byte
+				ByteArray body(1, ENCODING_LATIN1);
+				body.insert(body.end(), v1 + field.start, v1 + field.start + field.length);
+				if(scanFrame(&body.front(), body.size(), 1, FrameID(field.frame), matches) && firstOnly)
+					return matches;
+			}
+			
+			if(readSize == V1_READ_SIZE && memcmp(&tail.front(), "TAG+", 4) == 0) {
+				for(const V1Field& field : extFields) {
+					ByteArray body(1, ENCODING_LATIN1);
+					body.insert(body.end(), tail.begin() + field.start, tail.begin() + field.start + field.length);
+					if(scanFrame(&body.front(), body.size(), 1, FrameID(field.frame), matches) && firstOnly)
+						return matches;
+				}
+			}
+		}
+	}
+	
+	return matches;
+}
+
+///@pkg ID3Search.h
+bool TagSearch::scanFrame(const uint8_t*            body,
+                          const ulong               size,
+                          const ulong               textStart,
+                          const FrameID&            frame,
+                          std::vector<SearchMatch>& matches) const {
+	if(size <= textStart) return false;
+	
+	const uint8_t encoding = body[0] <= ENCODING_UTF8 ? body[0] : static_cast<uint8_t>(ENCODING_LATIN1);
+	const uint8_t* text = body + textStart;
+	const ulong textSize = size - textStart;
+	
+	//Fold a copy of the text if the search ignores case
+	ByteArray folded;
+	if(foldCase) {
+		folded.assign(text, text + textSize);
+		foldASCII(&folded.front(), textSize);
+		text = &folded.front();
+	}
+	
+	//Look for the query in the frame's encoding. UTF-16 with a BOM can be in
+	//either byte order.
+	const ByteArray& query = encodedQueries[encoding];
+	bool candidate = !query.empty() && memmem(text, textSize, &query.front(), query.size()) != nullptr;
+	if(!candidate && encoding == ENCODING_UTF16BOM) {
+		const ByteArray& bigEndianQuery = encodedQueries[ENCODING_UTF16];
+		candidate = memmem(text, textSize, &bigEndianQuery.front(), bigEndianQuery.size()) != nullptr;
+	}
+	if(!candidate) return false;
+	
+	//Convert the frame text to confirm the match
+	const ByteArray bodyBytes(body, body + size);
+	std::string utf8Text;
+	if(encoding == ENCODING_LATIN1) {
+		utf8Text = latin1toutf8(bodyBytes, textStart, size);
+	} else if(encoding == ENCODING_UTF8) {
+		utf8Text.assign(reinterpret_cast<const char*>(body) + textStart, size - textStart);
+	} else {
+		//Convert each null-separated UTF-16 string on its own, so that each
+		//string's BOM is used
+		const ulong TEXT_END = textStart + (textSize & ~1UL);
+		ulong start = textStart;
+		for(ulong i = textStart; i < TEXT_END; i += 2) {
+			if(body[i] == '\0' && body[i+1] == '\0') {
+				utf8Text += getUTF8String(encoding, bodyBytes, start, i);
+				utf8Text += '\0';
+				start = i + 2;
+			}
+		}
+		if(start < TEXT_END) utf8Text += getUTF8String(encoding, bodyBytes, start, TEXT_END);
+	}
+	
+	//Remove the terminating characters of each string
+	for(char& character : utf8Text) if(character == '\0') character = '\n';
+	while(!utf8Text.empty() && utf8Text.back() == '\n') utf8Text.pop_back();
+	
+	if(!confirm(utf8Text)) return false;
+	
+	matches.emplace_back(frame, utf8Text);
+	return true;
+}
+
+///@pkg ID3Search.h
+bool TagSearch::confirm(std::string text) const {
+	if(foldCase && !text.empty()) foldASCII(reinterpret_cast<uint8_t*>(&text[0]), text.size());
+	return text.find(utf8Query) != std::string::npos;
+}
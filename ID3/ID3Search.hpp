@@ -0,0 +1,152 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_SEARCH_HPP
+#define ID3_SEARCH_HPP
+
+#include <istream> //For std::istream
+#include <string>  //For std::string
+#include <vector>  //For std::vector
+
+#include "ID3FrameID.hpp" //For FrameID
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * @see ID3.h
+	 */
+	typedef std::vector<uint8_t> ByteArray;
+	
+	/**
+	 * A text frame that contains the searched text.
+	 */
+	struct SearchMatch {
+		SearchMatch(const FrameID& frame, const std::string& text);
+		FrameID frame;    //The frame ID, converted to ID3v2.4 for ID3v2.2 frames
+		std::string text; //The frame's text, in UTF-8
+	};
+	
+	/**
+	 * TagSearch looks for text in the text frames (T***, COMM, and USLT) of
+	 * files without creating a Tag. The query is encoded once in each ID3v2
+	 * text encoding (LATIN-1, UTF-16 big and little endian, and UTF-8), and
+	 * the raw frame bodies are scanned with memmem(). Only frames with a
+	 * possible match are converted to UTF-8 to confirm it.
+	 * 
+	 * The ID3v2 tag is found the same way as ID3::Tag does, including ID3
+	 * chunks in WAV and AIFF files and ID32 boxes in MP4 files. The ID3v1 and
+	 * ID3v1 Extended title, artist, album, and comment fields are also searched.
+	 * 
+	 * NOTE: Compressed and encrypted frames are skipped.
+	 * NOTE: Case-insensitive searches only fold ASCII letters.
+	 * 
+	 * Defined in ID3Search.cpp.
+	 */
+	class TagSearch {
+		public:
+			/**
+			 * Create a search.
+			 * 
+			 * @param query      The UTF-8 text to search for.
+			 * @param ignoreCase If true, ASCII letters are matched regardless
+			 *                   of case.
+			 */
+			explicit TagSearch(const std::string& query, const bool ignoreCase=false);
+			
+			/**
+			 * Find the text frames of a file that contain the query.
+			 * 
+			 * @param fileLoc The file path.
+			 * @return The matching frames, in the order they are on file.
+			 * @throws ID3::FileNotFoundException if the file cannot be opened.
+			 */
+			std::vector<SearchMatch> search(const std::string& fileLoc) const;
+			
+			/**
+			 * Find the text frames of a file that contain the query.
+			 * 
+			 * @param file     The file stream object.
+			 * @param fileSize The size of the file.
+			 * @param firstOnly Stop after the first match.
+			 * @return The matching frames, in the order they are on file.
+			 */
+			std::vector<SearchMatch> search(std::istream& file,
+			                                const ulong   fileSize,
+			                                const bool    firstOnly=false) const;
+			
+			/**
+			 * Check if any text frame of a file contains the query. This stops
+			 * at the first match.
+			 * 
+			 * @param fileLoc The file path.
+			 * @return If the file matches.
+			 * @throws ID3::FileNotFoundException if the file cannot be opened.
+			 */
+			bool matches(const std::string& fileLoc) const;
+		
+		private:
+			/**
+			 * Scan a text frame body, and confirm any candidate by converting
+			 * it to UTF-8.
+			 * 
+			 * @param body      The start of the frame body.
+			 * @param size      The size of the frame body.
+			 * @param textStart The position of the text in the body, after the
+			 *                  encoding byte and the language (if any).
+			 * @param frame     The frame ID.
+			 * @param matches   The vector to add a match to.
+			 * @return If the frame matches.
+			 */
+			bool scanFrame(const uint8_t*            body,
+			               const ulong               size,
+			               const ulong               textStart,
+			               const FrameID&            frame,
+			               std::vector<SearchMatch>& matches) const;
+			
+			/**
+			 * Check if decoded UTF-8 text contains the query.
+			 * 
+			 * @param text The UTF-8 text.
+			 * @return If the text contains the query.
+			 */
+			bool confirm(std::string text) const;
+			
+			/**
+			 * The query in UTF-8, case-folded if ignoreCase is true.
+			 */
+			std::string utf8Query;
+			
+			/**
+			 * The query in each ID3v2 text encoding, indexed by the encoding
+			 * byte. Empty if the query can't be encoded (such as non-LATIN-1
+			 * characters in LATIN-1). Index 1 (UTF-16 with a BOM) holds the
+			 * little endian form, and index 2 the big endian form.
+			 */
+			ByteArray encodedQueries[4];
+			
+			/**
+			 * If ASCII letters are case-folded.
+			 */
+			bool foldCase;
+	};
+}
+
+#endif
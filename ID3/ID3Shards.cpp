@@ -0,0 +1,142 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm> //For std::sort()
+#include <cstdio>    //For std::rename() and std::remove()
+#include <fstream>   //For std::ifstream and std::ofstream
+#include <map>       //For std::map
+#include <sstream>   //For std::istringstream
+
+#include "ID3Shards.hpp"    //For the function definitions
+#include "ID3Exception.hpp" //For exceptions
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The first word of shard result files.
+	 */
+	static const std::string SHARD_FORMAT = "ID3-Tagging-Library shard";
+	
+	/**
+	 * The FNV-1a offset basis and prime for 64-bit hashes.
+	 */
+	static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+	static const uint64_t FNV_PRIME = 1099511628211ULL;
+}
+
+///@pkg ID3Shards.h
+Shard::Shard(const unsigned index, const unsigned count, const ShardMethod method) : index(index),
+                                                                                     count(count),
+                                                                                     method(method) {}
+
+///@pkg ID3Shards.h
+std::vector<std::string> Shard::select(const std::vector<std::string>& files) const {
+	std::vector<std::string> selected;
+	if(count == 0 || index >= count) return selected;
+	
+	if(method == ShardMethod::HASH) {
+		for(const std::string& file : files)
+			if(hash(file) % count == index) selected.push_back(file);
+		return selected;
+	}
+	
+	//Range shards split the sorted list into count parts, with sizes that
+	//differ by at most one
+	std::vector<std::string> sorted(files);
+	std::sort(sorted.begin(), sorted.end());
+	const size_t FIRST = sorted.size() * index / count,
+	             LAST  = sorted.size() * (index + 1) / count;
+	selected.assign(sorted.begin() + FIRST, sorted.begin() + LAST);
+	return selected;
+}
+
+///@pkg ID3Shards.h
+uint64_t Shard::hash(const std::string& file) {
+	uint64_t hash = FNV_OFFSET_BASIS;
+	for(const char character : file) {
+		hash ^= static_cast<uint8_t>(character);
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+///@pkg ID3Shards.h
+void ID3::writeShardStatistics(std::ostream& os, const Shard& shard, const TagStatistics& statistics) {
+	os << SHARD_FORMAT << ' ' << shard.index << ' ' << shard.count << ' '
+	   << (shard.method == ShardMethod::HASH ? "hash" : "range") << '\n';
+	statistics.write(os);
+}
+
+///@pkg ID3Shards.h
+void ID3::saveShardStatistics(const std::string& fileLoc, const Shard& shard, const TagStatistics& statistics) {
+	const std::string TEMP_FILE = fileLoc + ".tmp";
+	std::ofstream file(TEMP_FILE, std::ios::out | std::ios::trunc | std::ios::binary);
+	if(!file.is_open())
+		throw WriteException("Cannot write shard statistics to file \"" + fileLoc + "\", unable to open file in write mode.");
+	writeShardStatistics(file, shard, statistics);
+	file.close();
+	if(!file || std::rename(TEMP_FILE.c_str(), fileLoc.c_str()) != 0) {
+		std::remove(TEMP_FILE.c_str());
+		throw WriteException("Cannot write shard statistics to file \"" + fileLoc + "\".");
+	}
+}
+
+///@pkg ID3Shards.h
+TagStatistics ID3::readShardStatistics(std::istream& is, Shard& shard) {
+	std::string format, method;
+	std::getline(is, format);
+	if(format.compare(0, SHARD_FORMAT.size() + 1, SHARD_FORMAT + ' ') != 0)
+		throw FileFormatException("Not a shard statistics file!");
+	
+	std::istringstream fields(format.substr(SHARD_FORMAT.size()));
+	if(!(fields >> shard.index >> shard.count >> method) || shard.index >= shard.count ||
+	   (method != "hash" && method != "range"))
+		throw FileFormatException("Malformed shard line \"" + format + "\"!");
+	shard.method = method == "hash" ? ShardMethod::HASH : ShardMethod::RANGE;
+	
+	return TagStatistics::read(is);
+}
+
+///@pkg ID3Shards.h
+TagStatistics ID3::mergeShardStatistics(const std::vector<std::string>& fileLocs) {
+	//Read every shard, keyed by shard number so they're merged in order
+	std::map<unsigned, TagStatistics> shards;
+	Shard first;
+	for(const std::string& fileLoc : fileLocs) {
+		std::ifstream file(fileLoc, std::ios::in | std::ios::binary);
+		if(!file.is_open())
+			throw FileNotFoundException("File \"" + fileLoc + "\" cannot be opened!\n");
+		
+		Shard shard;
+		TagStatistics statistics = readShardStatistics(file, shard);
+		if(shards.empty()) {
+			first = shard;
+		} else if(shard.count != first.count || shard.method != first.method) {
+			throw FileFormatException("Shard file \"" + fileLoc + "\" is from a scan with a different shard count or method!");
+		}
+		if(!shards.emplace(shard.index, std::move(statistics)).second)
+			throw FileFormatException("Shard " + std::to_string(shard.index) + " is given twice!");
+	}
+	
+	if(!shards.empty() && shards.size() != first.count) {
+		std::string missing;
+		for(unsigned index = 0; index < first.count; index++)
+			if(shards.count(index) == 0) missing += (missing.empty() ? "" : ", ") + std::to_string(index);
+		throw FileFormatException("Shard statistics are missing for shards " + missing + "!");
+	}
+	
+	TagStatistics merged;
+	for(const auto& shard : shards) merged.merge(shard.second);
+	return merged;
+}
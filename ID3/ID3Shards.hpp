@@ -0,0 +1,136 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_SHARDS_HPP
+#define ID3_SHARDS_HPP
+
+#include <cstdint> //For uint8_t and uint64_t
+#include <istream> //For std::istream
+#include <ostream> //For std::ostream
+#include <string>  //For std::string
+#include <vector>  //For std::vector
+
+#include "ID3Statistics.hpp" //For TagStatistics
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * How a file list is split into shards.
+	 */
+	enum class ShardMethod : uint8_t {
+		HASH,  //By a hash of the path, so a file stays in the same shard when others are added
+		RANGE  //By sorted path, so each shard is a contiguous range of paths
+	};
+	
+	/**
+	 * One shard of a file list, so that a library can be scanned by several
+	 * processes or machines, each writing a result file that is merged
+	 * afterwards.
+	 * 
+	 * Shards only depend on the paths and the shard count, so every process
+	 * given the same list picks the same files, without talking to the
+	 * others. The path hash is FNV-1a, which is the same on every platform,
+	 * unlike std::hash.
+	 * 
+	 * If each node already holds a separate part of the library, each node
+	 * can scan all of its own files and save them as its own shard without
+	 * calling select().
+	 * 
+	 * Defined in ID3Shards.cpp.
+	 */
+	struct Shard {
+		/**
+		 * @param index  The shard number, from 0 to count - 1.
+		 * @param count  The number of shards.
+		 * @param method How the files are split.
+		 */
+		Shard(const unsigned index=0, const unsigned count=1, const ShardMethod method=ShardMethod::HASH);
+		
+		unsigned index;     //The shard number
+		unsigned count;     //The number of shards
+		ShardMethod method; //How the files are split
+		
+		/**
+		 * Pick the files in this shard.
+		 * 
+		 * @param files The whole file list.
+		 * @return The files in the shard. They are in list order for hash
+		 *         shards, and in sorted order for range shards.
+		 */
+		std::vector<std::string> select(const std::vector<std::string>& files) const;
+		
+		/**
+		 * @param file The file path.
+		 * @return The 64-bit FNV-1a hash of the path.
+		 */
+		static uint64_t hash(const std::string& file);
+	};
+	
+	/**
+	 * Write the statistics of a shard. The first line is
+	 * "ID3-Tagging-Library shard" followed by the shard number, the shard
+	 * count, and "hash" or "range", and the statistics follow in the format
+	 * of ID3::TagStatistics::write().
+	 * 
+	 * @param os         The output stream.
+	 * @param shard      The shard.
+	 * @param statistics The statistics of the files in the shard.
+	 */
+	void writeShardStatistics(std::ostream& os, const Shard& shard, const TagStatistics& statistics);
+	
+	/**
+	 * Save the statistics of a shard to a file. The file is written under a
+	 * temporary name and renamed once it's complete, so a merge never reads a
+	 * half-written file.
+	 * 
+	 * @param fileLoc    The result file path.
+	 * @param shard      The shard.
+	 * @param statistics The statistics of the files in the shard.
+	 * @throws ID3::WriteException if the file can't be written.
+	 * @see ID3::writeShardStatistics(std::ostream&, Shard&, TagStatistics&)
+	 */
+	void saveShardStatistics(const std::string& fileLoc, const Shard& shard, const TagStatistics& statistics);
+	
+	/**
+	 * Read the statistics of a shard.
+	 * 
+	 * @param is    The input stream.
+	 * @param shard Set to the shard the statistics are for.
+	 * @return The statistics.
+	 * @throws ID3::FileFormatException if the input isn't shard statistics.
+	 */
+	TagStatistics readShardStatistics(std::istream& is, Shard& shard);
+	
+	/**
+	 * Merge the result files of every shard of a scan. The merge is exact,
+	 * and doesn't depend on the order of the files.
+	 * 
+	 * @param fileLocs The result file paths.
+	 * @return The statistics of the whole file list.
+	 * @throws ID3::FileNotFoundException if a file can't be opened.
+	 * @throws ID3::FileFormatException if a file is malformed, the files are
+	 *         from scans with different shard counts or methods, or a shard is
+	 *         missing or given twice.
+	 */
+	TagStatistics mergeShardStatistics(const std::vector<std::string>& fileLocs);
+}
+
+#endif
@@ -0,0 +1,99 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <memory> //For std::unique_ptr
+
+#include "ID3SharedFrames.hpp"         //For the class definition
+#include "ID3Constants.hpp"            //For HEADER_BYTE_SIZE
+#include "Frames/ID3TextFrame.hpp"     //For DescriptiveTextFrame
+#include "Frames/ID3PictureFrame.hpp"  //For PictureFrame
+
+using namespace ID3;
+
+///@pkg ID3SharedFrames.h
+SharedFrames::SharedFrames(const Tag& tag) : totalBytes(0) {
+	for(const auto& framePair : tag.frames) {
+		const Frame* const frame = framePair.second.get();
+		if(frame == nullptr || frame->null() || frame->empty()) continue;
+		
+		Block block;
+		block.frameID = frame->frame();
+		block.pictureType = PictureType::NULL_PICTURE;
+		if(const PictureFrame* const picture = dynamic_cast<const PictureFrame*>(frame)) {
+			block.description = picture->description();
+			block.pictureType = picture->pictureType();
+		} else if(const DescriptiveTextFrame* const text = dynamic_cast<const DescriptiveTextFrame*>(frame)) {
+			block.description = text->description();
+		}
+		
+		//Writing a frame updates it, so write a copy to leave the Tag unchanged
+		const std::unique_ptr<Frame> frameCopy(frame->clone());
+		ByteArray bytes = frameCopy->write();
+		if(bytes.size() <= HEADER_BYTE_SIZE) continue;
+		totalBytes += bytes.size();
+		block.bytes = std::make_shared<const ByteArray>(std::move(bytes));
+		blocks.push_back(std::move(block));
+	}
+}
+
+///@pkg ID3SharedFrames.h
+size_t SharedFrames::size() const { return blocks.size(); }
+
+///@pkg ID3SharedFrames.h
+ulong SharedFrames::bytes() const { return totalBytes; }
+
+///@pkg ID3SharedFrames.h
+bool SharedFrames::replaces(const Frame& frame) const {
+	for(const Block& block : blocks) {
+		if(block.frameID != frame.frame()) continue;
+		
+		if(const PictureFrame* const picture = dynamic_cast<const PictureFrame*>(&frame)) {
+			if(picture->description() == block.description || picture->pictureType() == block.pictureType)
+				return true;
+		} else if(const DescriptiveTextFrame* const text = dynamic_cast<const DescriptiveTextFrame*>(&frame)) {
+			if(text->description() == block.description)
+				return true;
+		} else {
+			return true;
+		}
+	}
+	return false;
+}
+
+///@pkg ID3SharedFrames.h
+void SharedFrames::write(std::ostream& os) const {
+	for(const Block& block : blocks)
+		os.write(reinterpret_cast<const char*>(&block.bytes->front()), block.bytes->size());
+}
+
+///@pkg ID3SharedFrames.h
+void SharedFrames::append(ByteArray& bytes) const {
+	bytes.reserve(bytes.size() + totalBytes);
+	for(const Block& block : blocks)
+		bytes.insert(bytes.end(), block.bytes->begin(), block.bytes->end());
+}
+
+///@pkg ID3SharedFrames.h
+std::vector<BatchError> SharedFrames::write(const std::vector<std::string>& files,
+                                            const Edit&                     edit,
+                                            const WriteOptions&             options,
+                                            const BatchOptions&             batchOptions) const {
+	WriteOptions sharedOptions = options;
+	sharedOptions.sharedFrames = this;
+	
+	const Batch batch(files, batchOptions);
+	return batch.run([&](const size_t file, const unsigned) {
+		Tag tag(files[file]);
+		if(edit) edit(tag, file);
+		tag.write(files[file], sharedOptions);
+	});
+}
@@ -0,0 +1,159 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_SHARED_FRAMES_HPP
+#define ID3_SHARED_FRAMES_HPP
+
+#include <functional> //For std::function
+#include <memory>     //For std::shared_ptr
+#include <ostream>    //For std::ostream
+#include <string>     //For std::string
+#include <vector>     //For std::vector
+
+#include "ID3.hpp"      //For Tag, WriteOptions, and ByteArray
+#include "ID3Batch.hpp" //For BatchOptions and BatchError
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * SharedFrames holds frames that are written to many files, such as the
+	 * album, album artist, genre, year, and cover picture of an album. The
+	 * frames are written to bytes once when the SharedFrames object is created,
+	 * and every file written with it writes those same bytes after its own
+	 * frames, so writing a big picture to every track of an album doesn't
+	 * write the picture frame again for each track.
+	 * 
+	 * The bytes are held in immutable blocks that are shared between copies of
+	 * a SharedFrames object, so it's cheap to copy and safe to use on many
+	 * threads at once.
+	 * 
+	 * A frame in a file's tag is replaced by a shared frame if:
+	 *   - It is a picture frame with the same description or picture type.
+	 *   - It is a text frame with a description (such as a comment) with the
+	 *     same description.
+	 *   - It is any other frame with the same frame ID.
+	 * 
+	 * @see ID3::WriteOptions::sharedFrames
+	 * 
+	 * Defined in ID3SharedFrames.cpp.
+	 */
+	class SharedFrames {
+		public:
+			/**
+			 * The task to run on each file's tag before writing it, to set the
+			 * frames that are different for each file, such as the title and
+			 * track number.
+			 * 
+			 * @param tag  The file's tag.
+			 * @param file The position of the file in the batch.
+			 */
+			typedef std::function<void(Tag& tag, const size_t file)> Edit;
+			
+			/**
+			 * Write the frames of a tag to bytes. Null and empty frames are
+			 * skipped.
+			 * 
+			 * NOTE: The frames are written the same way as ID3::Tag::write()
+			 *       writes them, so they are converted to ID3v2.4. Copies of the
+			 *       frames are written, so the tag isn't changed.
+			 * 
+			 * @param tag The tag holding the shared frames, which is usually
+			 *            created with the empty constructor.
+			 * @throws ID3::FrameSizeException if a frame is bigger than the
+			 *         maximum frame size.
+			 */
+			explicit SharedFrames(const Tag& tag);
+			
+			/**
+			 * @return The number of shared frames.
+			 */
+			size_t size() const;
+			
+			/**
+			 * @return The number of bytes the shared frames take up in a tag.
+			 */
+			ulong bytes() const;
+			
+			/**
+			 * Check if a frame in a file's tag is replaced by a shared frame.
+			 * 
+			 * @param frame The frame.
+			 * @return If the frame is replaced.
+			 */
+			bool replaces(const Frame& frame) const;
+			
+			/**
+			 * Write the bytes of every shared frame to a stream, without copying
+			 * them.
+			 * 
+			 * @param os The output stream.
+			 */
+			void write(std::ostream& os) const;
+			
+			/**
+			 * Append the bytes of every shared frame to a ByteArray.
+			 * 
+			 * @param bytes The ByteArray to append to.
+			 */
+			void append(ByteArray& bytes) const;
+			
+			/**
+			 * Write the shared frames to many files in parallel. Each file's tag
+			 * is read, edited with the given edit function, then written with the
+			 * shared frames.
+			 * 
+			 * @param files        The file paths.
+			 * @param edit         The function to set each file's own frames
+			 *                     (optional).
+			 * @param options      The write options. The sharedFrames option is
+			 *                     set to this object.
+			 * @param batchOptions The batch options.
+			 * @return The files that couldn't be written, in file order.
+			 */
+			std::vector<BatchError> write(const std::vector<std::string>& files,
+			                              const Edit&                     edit=Edit(),
+			                              const WriteOptions&             options=WriteOptions(),
+			                              const BatchOptions&             batchOptions=BatchOptions()) const;
+		
+		private:
+			/**
+			 * A shared frame.
+			 */
+			struct Block {
+				FrameID frameID;                        //The frame ID
+				std::string description;                //The description of pictures and descriptive text frames
+				PictureType pictureType;                //The picture type of pictures
+				std::shared_ptr<const ByteArray> bytes; //The frame bytes
+			};
+			
+			/**
+			 * The shared frames, in the order they're written.
+			 */
+			std::vector<Block> blocks;
+			
+			/**
+			 * The total size of the blocks.
+			 */
+			ulong totalBytes;
+	};
+}
+
+#endif
@@ -0,0 +1,104 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm> //For std::max()
+#include <cstring>   //For memcpy() and memset()
+
+#include "ID3SmallByteArray.hpp" //For the class definitions
+
+using namespace ID3;
+
+///@pkg ID3SmallByteArray.h
+SmallByteArray::SmallByteArray() noexcept : length(0),
+                                            heapCapacity(0),
+                                            heap(nullptr) {}
+
+///@pkg ID3SmallByteArray.h
+SmallByteArray::SmallByteArray(const size_t count, const uint8_t value) : SmallByteArray() {
+	reserve(count);
+	memset(data(), value, count);
+	length = count;
+}
+
+///@pkg ID3SmallByteArray.h
+SmallByteArray::SmallByteArray(const uint8_t* first, const uint8_t* last) : SmallByteArray() {
+	const size_t COUNT = last - first;
+	reserve(COUNT);
+	if(COUNT > 0) memcpy(data(), first, COUNT);
+	length = COUNT;
+}
+
+///@pkg ID3SmallByteArray.h
+SmallByteArray::SmallByteArray(const ByteArray& bytes) : SmallByteArray(bytes.data(), bytes.data() + bytes.size()) {}
+
+///@pkg ID3SmallByteArray.h
+SmallByteArray::SmallByteArray(const SmallByteArray& other) : SmallByteArray(other.begin(), other.end()) {}
+
+///@pkg ID3SmallByteArray.h
+SmallByteArray::SmallByteArray(SmallByteArray&& other) noexcept : length(other.length),
+                                                                  heapCapacity(other.heapCapacity),
+                                                                  heap(other.heap) {
+	if(heap == nullptr) memcpy(buffer, other.buffer, length);
+	other.length = 0;
+	other.heapCapacity = 0;
+	other.heap = nullptr;
+}
+
+///@pkg ID3SmallByteArray.h
+SmallByteArray& SmallByteArray::operator=(const SmallByteArray& other) {
+	if(this == &other) return *this;
+	length = 0;
+	reserve(other.length);
+	if(other.length > 0) memcpy(data(), other.data(), other.length);
+	length = other.length;
+	return *this;
+}
+
+///@pkg ID3SmallByteArray.h
+SmallByteArray& SmallByteArray::operator=(SmallByteArray&& other) noexcept {
+	if(this == &other) return *this;
+	delete[] heap;
+	length = other.length;
+	heapCapacity = other.heapCapacity;
+	heap = other.heap;
+	if(heap == nullptr) memcpy(buffer, other.buffer, length);
+	other.length = 0;
+	other.heapCapacity = 0;
+	other.heap = nullptr;
+	return *this;
+}
+
+///@pkg ID3SmallByteArray.h
+SmallByteArray::~SmallByteArray() { delete[] heap; }
+
+///@pkg ID3SmallByteArray.h
+SmallByteArray::operator ByteArray() const { return ByteArray(begin(), end()); }
+
+///@pkg ID3SmallByteArray.h
+bool SmallByteArray::operator==(const ByteArray& bytes) const {
+	return length == bytes.size() && (length == 0 || memcmp(data(), bytes.data(), length) == 0);
+}
+
+///@pkg ID3SmallByteArray.h
+void SmallByteArray::reserve(const size_t bytes) {
+	if(bytes > capacity()) grow(bytes);
+}
+
+///@pkg ID3SmallByteArray.h
+void SmallByteArray::grow(const size_t bytes) {
+	const size_t NEW_CAPACITY = std::max(bytes, capacity() + capacity() / 2);
+	uint8_t* const NEW_HEAP = new uint8_t[NEW_CAPACITY];
+	if(length > 0) memcpy(NEW_HEAP, data(), length);
+	delete[] heap;
+	heap = NEW_HEAP;
+	heapCapacity = NEW_CAPACITY;
+}
@@ -0,0 +1,194 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_SMALL_BYTE_ARRAY_HPP
+#define ID3_SMALL_BYTE_ARRAY_HPP
+
+#include <cstring>  //For memmove()
+#include <iterator> //For std::distance()
+#include <vector>   //For std::vector
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * @see ID3.h
+	 */
+	typedef std::vector<uint8_t> ByteArray;
+	
+	/**
+	 * SmallByteArray is a byte vector that stores up to INLINE_CAPACITY bytes
+	 * inside the object, and only allocates memory once it grows past that.
+	 * Most frames are small text frames, so storing their bytes this way means
+	 * reading them doesn't allocate memory.
+	 * 
+	 * It has the parts of the std::vector interface the Frame classes use, and
+	 * its iterators are pointers.
+	 * 
+	 * Defined in ID3SmallByteArray.cpp.
+	 */
+	class SmallByteArray {
+		public:
+			/**
+			 * The most bytes stored without allocating memory.
+			 */
+			static const size_t INLINE_CAPACITY = 64;
+			
+			typedef uint8_t        value_type;
+			typedef uint8_t*       iterator;
+			typedef const uint8_t* const_iterator;
+			
+			/**
+			 * Create an empty SmallByteArray.
+			 */
+			SmallByteArray() noexcept;
+			
+			/**
+			 * Create a SmallByteArray of a byte repeated.
+			 * 
+			 * @param count The number of bytes.
+			 * @param value The byte.
+			 */
+			SmallByteArray(const size_t count, const uint8_t value);
+			
+			/**
+			 * Copy a range of bytes.
+			 * 
+			 * @param first The first byte.
+			 * @param last  The position after the last byte.
+			 */
+			SmallByteArray(const uint8_t* first, const uint8_t* last);
+			
+			/**
+			 * Copy a ByteArray. This is implicit so that ByteArrays can be passed
+			 * wherever a SmallByteArray is.
+			 * 
+			 * @param bytes The ByteArray.
+			 */
+			SmallByteArray(const ByteArray& bytes);
+			
+			SmallByteArray(const SmallByteArray& other);
+			SmallByteArray(SmallByteArray&& other) noexcept;
+			SmallByteArray& operator=(const SmallByteArray& other);
+			SmallByteArray& operator=(SmallByteArray&& other) noexcept;
+			~SmallByteArray();
+			
+			/**
+			 * @return The bytes as a ByteArray. This is explicit so that the bytes
+			 *         aren't copied without it being clear.
+			 */
+			explicit operator ByteArray() const;
+			
+			/**
+			 * @return If the bytes are the same as the ByteArray's.
+			 */
+			bool operator==(const ByteArray& bytes) const;
+			
+			inline size_t size() const noexcept { return length; }
+			inline bool empty() const noexcept { return length == 0; }
+			inline size_t capacity() const noexcept { return heap != nullptr ? heapCapacity : INLINE_CAPACITY; }
+			
+			inline uint8_t* data() noexcept { return heap != nullptr ? heap : buffer; }
+			inline const uint8_t* data() const noexcept { return heap != nullptr ? heap : buffer; }
+			inline iterator begin() noexcept { return data(); }
+			inline const_iterator begin() const noexcept { return data(); }
+			inline iterator end() noexcept { return data() + length; }
+			inline const_iterator end() const noexcept { return data() + length; }
+			inline uint8_t& front() { return data()[0]; }
+			inline const uint8_t& front() const { return data()[0]; }
+			inline uint8_t& operator[](const size_t i) { return data()[i]; }
+			inline const uint8_t& operator[](const size_t i) const { return data()[i]; }
+			
+			/**
+			 * Make room for a number of bytes, so that adding bytes up to it
+			 * doesn't allocate memory again.
+			 * 
+			 * @param bytes The number of bytes.
+			 */
+			void reserve(const size_t bytes);
+			
+			/**
+			 * Remove every byte. Memory that's been allocated is kept.
+			 */
+			inline void clear() noexcept { length = 0; }
+			
+			/**
+			 * Add a byte to the end.
+			 * 
+			 * @param byte The byte.
+			 */
+			inline void push_back(const uint8_t byte) {
+				if(length == capacity()) grow(length + 1);
+				data()[length++] = byte;
+			}
+			
+			/**
+			 * Insert a range of bytes. The range can't be part of this
+			 * SmallByteArray.
+			 * 
+			 * @param position Where to insert the bytes.
+			 * @param first    The first byte.
+			 * @param last     The position after the last byte.
+			 * @return The position of the first byte inserted.
+			 */
+			template<class InputIterator>
+			iterator insert(const_iterator position, InputIterator first, InputIterator last) {
+				const size_t OFFSET = position - begin();
+				const size_t COUNT = std::distance(first, last);
+				if(length + COUNT > capacity()) grow(length + COUNT);
+				uint8_t* const BYTES = data();
+				if(OFFSET < length) memmove(BYTES + OFFSET + COUNT, BYTES + OFFSET, length - OFFSET);
+				for(size_t i = OFFSET; first != last; ++first, i++) BYTES[i] = static_cast<uint8_t>(*first);
+				length += COUNT;
+				return BYTES + OFFSET;
+			}
+		
+		private:
+			/**
+			 * Move the bytes to allocated memory with room for at least a number
+			 * of bytes, growing by at least half the capacity.
+			 * 
+			 * @param bytes The number of bytes.
+			 */
+			void grow(const size_t bytes);
+			
+			/**
+			 * The number of bytes.
+			 */
+			size_t length;
+			
+			/**
+			 * The size of the allocated memory, if the bytes have been moved to it.
+			 */
+			size_t heapCapacity;
+			
+			/**
+			 * The allocated memory, or nullptr if the bytes are in buffer.
+			 */
+			uint8_t* heap;
+			
+			/**
+			 * The bytes, until there are more than INLINE_CAPACITY of them.
+			 */
+			uint8_t buffer[INLINE_CAPACITY];
+	};
+}
+
+#endif
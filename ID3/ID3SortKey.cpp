@@ -0,0 +1,221 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm>         //For std::sort() and std::inplace_merge()
+#include <cstring>           //For memcmp()
+#include <numeric>           //For std::iota()
+#include <thread>            //For std::thread
+#include <unicode/locid.h>   //For icu::Locale
+#include <unicode/unistr.h>  //For icu::UnicodeString
+
+#include "ID3SortKey.hpp"    //For the class definition
+#include "ID3.hpp"           //For ID3::Tag
+#include "ID3Exception.hpp"  //For ID3::Exception
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The fewest entries to give each sorting thread. Smaller indexes use
+	 * fewer threads, since starting a thread costs more than sorting a few
+	 * thousand keys.
+	 */
+	static const size_t MIN_ENTRIES_PER_THREAD = 16384;
+	
+	/**
+	 * An entry being sorted. The first 8 bytes of the key are copied next to
+	 * the entry position, so most comparisons don't have to read the key
+	 * buffer.
+	 */
+	struct SortItem {
+		uint64_t prefix; //The first 8 bytes of the key, as a big-endian integer
+		size_t entry;    //The entry position
+	};
+	
+	/**
+	 * Get the text of a sort-order frame, or the frame it sorts if it's not set.
+	 * 
+	 * @param tag       The tag.
+	 * @param sortFrame The sort-order frame.
+	 * @param frame     The frame it sorts.
+	 * @return The text to sort by.
+	 */
+	static std::string sortText(const Tag& tag, const Frames sortFrame, const Frames frame) {
+		const std::string sortOrder = tag.textString(sortFrame);
+		return sortOrder.empty() ? tag.textString(frame) : sortOrder;
+	}
+}
+
+///@pkg ID3SortKey.h
+SortIndex::SortIndex(const std::string& locale) : offsets(1, 0) {
+	UErrorCode status = U_ZERO_ERROR;
+	collator.reset(icu::Collator::createInstance(locale.empty() ? icu::Locale::getDefault() :
+	                                                              icu::Locale(locale.c_str()),
+	                                             status));
+	if(U_FAILURE(status) || collator == nullptr)
+		throw Exception("Cannot create a collator for the locale \"" + locale + "\": " + u_errorName(status) + "\n");
+}
+
+///@pkg ID3SortKey.h
+SortIndex::~SortIndex() {}
+
+///@pkg ID3SortKey.h
+size_t SortIndex::add(const Tag& tag) {
+	return add(sortText(tag, FRAME_ARTIST_SORT_ORDER, FRAME_ARTIST),
+	           sortText(tag, FRAME_ALBUM_SORT_ORDER, FRAME_ALBUM),
+	           tag.discNumbers().number,
+	           tag.trackNumbers().number,
+	           sortText(tag, FRAME_TITLE_SORT_ORDER, FRAME_TITLE));
+}
+
+///@pkg ID3SortKey.h
+size_t SortIndex::add(const std::string& artist,
+                      const std::string& album,
+                      const ulong        disc,
+                      const ulong        track,
+                      const std::string& title) {
+	appendKey(artist);
+	appendKey(album);
+	
+	//The disc and track as 4-byte big-endian integers, which sort the same
+	//byte-wise as they do numerically
+	for(const ulong number : {disc, track}) {
+		const ulong capped = number > 0xFFFFFFFFUL ? 0xFFFFFFFFUL : number;
+		for(int shift = 24; shift >= 0; shift -= 8)
+			keys.push_back(static_cast<uint8_t>(capped >> shift));
+	}
+	
+	appendKey(title);
+	
+	offsets.push_back(keys.size());
+	return offsets.size() - 2;
+}
+
+///@pkg ID3SortKey.h
+void SortIndex::appendKey(const std::string& text) {
+	const icu::UnicodeString unicodeText = icu::UnicodeString::fromUTF8(text);
+	const ulong keyStart = keys.size();
+	
+	//Guess the key size, and get the key again if the guess was too small
+	keys.resize(keyStart + text.size() * 2 + 16);
+	int32_t keySize = collator->getSortKey(unicodeText, &keys[keyStart], keys.size() - keyStart);
+	if(static_cast<ulong>(keySize) > keys.size() - keyStart) {
+		keys.resize(keyStart + keySize);
+		keySize = collator->getSortKey(unicodeText, &keys[keyStart], keySize);
+	}
+	
+	keys.resize(keyStart + keySize);
+}
+
+///@pkg ID3SortKey.h
+void SortIndex::reserve(const size_t entries, const ulong keyBytes) {
+	offsets.reserve(entries + 1);
+	if(keyBytes > 0) keys.reserve(keyBytes);
+}
+
+///@pkg ID3SortKey.h
+size_t SortIndex::size() const { return offsets.size() - 1; }
+
+///@pkg ID3SortKey.h
+ulong SortIndex::keyBytes() const { return keys.size(); }
+
+///@pkg ID3SortKey.h
+int SortIndex::compare(const size_t first, const size_t second) const {
+	const ulong firstSize  = offsets[first + 1] - offsets[first],
+	            secondSize = offsets[second + 1] - offsets[second];
+	const int cmp = memcmp(&keys[offsets[first]], &keys[offsets[second]], std::min(firstSize, secondSize));
+	if(cmp != 0) return cmp;
+	return firstSize < secondSize ? -1 : (firstSize > secondSize ? 1 : 0);
+}
+
+///@pkg ID3SortKey.h
+std::vector<size_t> SortIndex::sort(unsigned threads) const {
+	if(size() < 2) {
+		std::vector<size_t> order(size());
+		std::iota(order.begin(), order.end(), 0);
+		return order;
+	}
+	
+	//Copy the key prefixes. Keys shorter than 8 bytes are padded with 0s,
+	//which sorts them first like memcmp() does.
+	std::vector<SortItem> order(size());
+	for(size_t i = 0; i < order.size(); i++) {
+		uint64_t prefix = 0;
+		for(ulong pos = offsets[i]; pos < offsets[i] + 8; pos++)
+			prefix = (prefix << 8) | (pos < offsets[i + 1] ? keys[pos] : 0);
+		order[i] = {prefix, i};
+	}
+	
+	//Break ties by the order the entries were added in, so that the
+	//parallel sort gives the same result as a stable sort
+	auto lessThan = [this](const SortItem& first, const SortItem& second) {
+		if(first.prefix != second.prefix) return first.prefix < second.prefix;
+		const int cmp = compare(first.entry, second.entry);
+		return cmp < 0 || (cmp == 0 && first.entry < second.entry);
+	};
+	
+	//Get the entry positions out of the sorted items
+	auto entries = [&order]() {
+		std::vector<size_t> sorted;
+		sorted.reserve(order.size());
+		for(const SortItem& item : order) sorted.push_back(item.entry);
+		return sorted;
+	};
+	
+	//Choose the number of runs
+	if(threads == 0) threads = std::thread::hardware_concurrency();
+	const size_t maxThreads = (order.size() + MIN_ENTRIES_PER_THREAD - 1) / MIN_ENTRIES_PER_THREAD;
+	if(threads == 0) threads = 1;
+	if(threads > maxThreads) threads = maxThreads;
+	
+	if(threads == 1) {
+		std::sort(order.begin(), order.end(), lessThan);
+		return entries();
+	}
+	
+	//The boundaries of each run
+	std::vector<size_t> bounds;
+	for(unsigned i = 0; i <= threads; i++)
+		bounds.push_back(order.size() * i / threads);
+	
+	//Sort each run on its own thread
+	std::vector<std::thread> workers;
+	for(unsigned i = 0; i < threads; i++) {
+		workers.emplace_back([&order, &bounds, &lessThan, i]() {
+			std::sort(order.begin() + bounds[i], order.begin() + bounds[i + 1], lessThan);
+		});
+	}
+	for(std::thread& worker : workers) worker.join();
+	
+	//Merge the runs in pairs until there is one run left
+	while(bounds.size() > 2) {
+		std::vector<size_t> merged;
+		workers.clear();
+		for(size_t i = 0; i + 1 < bounds.size(); i += 2) {
+			merged.push_back(bounds[i]);
+			if(i + 2 < bounds.size()) {
+				workers.emplace_back([&order, &bounds, &lessThan, i]() {
+					std::inplace_merge(order.begin() + bounds[i],
+					                   order.begin() + bounds[i + 1],
+					                   order.begin() + bounds[i + 2],
+					                   lessThan);
+				});
+			}
+		}
+		for(std::thread& worker : workers) worker.join();
+		merged.push_back(bounds.back());
+		bounds = merged;
+	}
+	
+	return entries();
+}
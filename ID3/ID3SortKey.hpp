@@ -0,0 +1,171 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_SORT_KEY_HPP
+#define ID3_SORT_KEY_HPP
+
+#include <memory>          //For std::unique_ptr
+#include <string>          //For std::string
+#include <vector>          //For std::vector
+#include <unicode/coll.h>  //For icu::Collator
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * @see ID3.h
+	 */
+	typedef std::vector<uint8_t> ByteArray;
+	
+	class Tag;
+	
+	/**
+	 * SortIndex sorts a catalog of tags by artist, album, disc, track, and
+	 * title. Each entry's ICU collation sort keys are computed once when it's
+	 * added, and stored back to back in one buffer, so sorting only compares
+	 * bytes with memcmp() instead of collating strings on every comparison.
+	 * 
+	 * The sort-order frames are used instead of the displayed text when they
+	 * are set: TSOP for the artist, TSOA for the album, and TSOT for the title.
+	 * 
+	 * An ICU sort key never contains a null byte before its terminating null
+	 * byte, so an entry's key is each field's sort key (with its null byte)
+	 * followed by the next field's key. Comparing the whole key compares the
+	 * fields in order. The disc and track numbers are stored as 4-byte
+	 * big-endian integers.
+	 * 
+	 * NOTE: This uses the ICU i18n library (icu-i18n) for the collator.
+	 * NOTE: Adding entries is not thread-safe. Sorting uses its own threads.
+	 * 
+	 * Defined in ID3SortKey.cpp.
+	 */
+	class SortIndex {
+		public:
+			/**
+			 * Create an empty index.
+			 * 
+			 * @param locale The ICU locale ID to collate with, such as "en_US"
+			 *               or "de@collation=phonebook". If empty, the default
+			 *               locale is used.
+			 * @throws ID3::Exception if ICU can't create a collator.
+			 */
+			explicit SortIndex(const std::string& locale="");
+			
+			/**
+			 * The destructor.
+			 */
+			~SortIndex();
+			
+			/**
+			 * Add a tag to the index.
+			 * 
+			 * @param tag The tag.
+			 * @return The position of the entry, used in the sort() results.
+			 */
+			size_t add(const Tag& tag);
+			
+			/**
+			 * Add an entry to the index from text that has already been read.
+			 * 
+			 * @param artist The artist, or the artist sort order.
+			 * @param album  The album, or the album sort order.
+			 * @param disc   The disc number, or 0 if there is none.
+			 * @param track  The track number, or 0 if there is none.
+			 * @param title  The title, or the title sort order.
+			 * @return The position of the entry, used in the sort() results.
+			 */
+			size_t add(const std::string& artist,
+			           const std::string& album,
+			           const ulong        disc,
+			           const ulong        track,
+			           const std::string& title);
+			
+			/**
+			 * Reserve space ahead of adding many entries.
+			 * 
+			 * @param entries  The number of entries.
+			 * @param keyBytes The total size of the keys, if known. Sort keys
+			 *                 are usually a little longer than the text.
+			 */
+			void reserve(const size_t entries, const ulong keyBytes=0);
+			
+			/**
+			 * @return The number of entries.
+			 */
+			size_t size() const;
+			
+			/**
+			 * @return The total size of the stored sort keys.
+			 */
+			ulong keyBytes() const;
+			
+			/**
+			 * Compare two entries.
+			 * 
+			 * @param first  The position of the first entry.
+			 * @param second The position of the second entry.
+			 * @return A negative number if the first entry sorts first, a
+			 *         positive number if the second entry sorts first, or 0 if
+			 *         they are equal.
+			 */
+			int compare(const size_t first, const size_t second) const;
+			
+			/**
+			 * Sort the entries. The sort is stable: equal entries keep the
+			 * order they were added in.
+			 * 
+			 * The entries are split into one run per thread, each run is sorted
+			 * on its own thread, and then the runs are merged in pairs, also in
+			 * parallel.
+			 * 
+			 * @param threads The number of threads to use. If 0, the number of
+			 *                hardware threads is used. Small indexes are sorted
+			 *                on fewer threads.
+			 * @return The entry positions in sorted order.
+			 */
+			std::vector<size_t> sort(unsigned threads=0) const;
+		
+		private:
+			/**
+			 * Append the sort key of a string to the key buffer.
+			 * 
+			 * @param text The UTF-8 text.
+			 */
+			void appendKey(const std::string& text);
+			
+			/**
+			 * The collator used to create the sort keys.
+			 */
+			std::unique_ptr<icu::Collator> collator;
+			
+			/**
+			 * The sort keys of every entry, back to back.
+			 */
+			ByteArray keys;
+			
+			/**
+			 * The start of each entry's key in keys. An entry ends where the
+			 * next one starts, so there's one more offset than entries.
+			 */
+			std::vector<ulong> offsets;
+	};
+}
+
+#endif
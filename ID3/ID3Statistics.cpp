@@ -0,0 +1,558 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm> //For std::min()
+#include <cctype>    //For tolower() and isxdigit()
+#include <cstring>   //For memcmp() and memchr()
+#include <fstream>   //For std::ifstream
+#include <sstream>   //For std::istringstream and std::ostringstream
+#include <stdexcept> //For std::out_of_range
+#include <utility>   //For std::pair
+
+#include "ID3Statistics.hpp"   //For the class definitions
+#include "ID3Functions.hpp"    //For byteIntVal(), locateV2Tag(), and numericalString()
+#include "ID3Constants.hpp"    //For HEADER_BYTE_SIZE and the ID3v1 sizes
+#include "ID3IOThrottle.hpp"   //For IOThrottle::charge()
+#include "ID3Exception.hpp"    //For FileFormatException
+#include "Frames/ID3Frame.hpp" //For the frame flags
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The number of frame body bytes read with each frame header. This is
+	 * enough for the encoding byte and the MIME type of picture frames.
+	 */
+	static const ushort FRAME_PEEK_SIZE = 64;
+	
+	/**
+	 * The first line of statistics written with ID3::TagStatistics::write(),
+	 * and the version of the format.
+	 */
+	static const std::string STATISTICS_FORMAT = "ID3-Tagging-Library statistics";
+	static const ushort STATISTICS_FORMAT_VERSION = 1;
+	
+	/**
+	 * Add a count to a map.
+	 */
+	template <typename Key>
+	static void mergeCounts(std::map<Key, ulong>& counts, const std::map<Key, ulong>& other) {
+		for(const auto& count : other) counts[count.first] += count.second;
+	}
+	
+	/**
+	 * Check if a byte can be in a frame ID.
+	 */
+	static bool frameIDByte(const uint8_t byte) { return (byte >= 'A' && byte <= 'Z') || (byte >= '0' && byte <= '9'); }
+	
+	/**
+	 * Print a histogram's non-empty buckets.
+	 */
+	static void printHistogram(std::ostream& os, const std::string& name, const Histogram& histogram) {
+		os << name << ": " << histogram.count() << " values, total " << histogram.total()
+		   << ", min " << histogram.min() << ", max " << histogram.max() << std::endl;
+		for(ushort bucket = 0; bucket < Histogram::BUCKETS; bucket++) {
+			if(histogram.bucket(bucket) == 0) continue;
+			os << "\t>= " << Histogram::bucketStart(bucket) << ": " << histogram.bucket(bucket) << std::endl;
+		}
+	}
+	
+	/**
+	 * The count fields of ID3::TagStatistics and their names in the statistics
+	 * format.
+	 */
+	static const std::pair<const char*, ulong TagStatistics::*> COUNTS[] = {
+		{"files", &TagStatistics::files},
+		{"unreadableFiles", &TagStatistics::unreadableFiles},
+		{"v1Tags", &TagStatistics::v1Tags},
+		{"v1ExtendedTags", &TagStatistics::v1ExtendedTags},
+		{"v2Tags", &TagStatistics::v2Tags},
+		{"malformedTags", &TagStatistics::malformedTags},
+		{"unsynchronisedTags", &TagStatistics::unsynchronisedTags},
+		{"extendedHeaders", &TagStatistics::extendedHeaders},
+		{"footers", &TagStatistics::footers},
+		{"unsynchronisedFrames", &TagStatistics::unsynchronisedFrames},
+		{"compressedFrames", &TagStatistics::compressedFrames},
+		{"encryptedFrames", &TagStatistics::encryptedFrames},
+		{"groupedFrames", &TagStatistics::groupedFrames}
+	};
+	
+	/**
+	 * The histogram fields of ID3::TagStatistics and their names in the
+	 * statistics format.
+	 */
+	static const std::pair<const char*, Histogram TagStatistics::*> HISTOGRAMS[] = {
+		{"tagSizes", &TagStatistics::tagSizes},
+		{"paddingSizes", &TagStatistics::paddingSizes},
+		{"frameSizes", &TagStatistics::frameSizes},
+		{"pictureSizes", &TagStatistics::pictureSizes}
+	};
+	
+	/**
+	 * Escape a map key so it has no spaces or unprintable bytes.
+	 */
+	static std::string escapeKey(const std::string& key) {
+		static const char HEX[] = "0123456789ABCDEF";
+		std::string escaped;
+		for(const char character : key) {
+			const uint8_t byte = character;
+			if(byte <= ' ' || byte >= 0x7F || byte == '%') {
+				escaped += '%';
+				escaped += HEX[byte >> 4];
+				escaped += HEX[byte & 0x0F];
+			} else {
+				escaped += character;
+			}
+		}
+		return escaped;
+	}
+	
+	/**
+	 * Undo escapeKey().
+	 * 
+	 * @throws ID3::FileFormatException if an escape is malformed.
+	 */
+	static std::string unescapeKey(const std::string& escaped) {
+		std::string key;
+		for(size_t i = 0; i < escaped.size(); i++) {
+			if(escaped[i] != '%') {
+				key += escaped[i];
+				continue;
+			}
+			if(i + 2 >= escaped.size() || !isxdigit(escaped[i+1]) || !isxdigit(escaped[i+2]))
+				throw FileFormatException("Malformed statistics key \"" + escaped + "\"!");
+			key += static_cast<char>(std::stoi(escaped.substr(i + 1, 2), nullptr, 16));
+			i += 2;
+		}
+		return key;
+	}
+	
+	/**
+	 * Read an unsigned number, throwing a FileFormatException if there isn't one.
+	 */
+	static ulong readNumber(std::istream& is) {
+		std::string number;
+		is >> number;
+		try {
+			if(!number.empty() && numericalString(number)) return std::stoul(number);
+		} catch(const std::out_of_range&) {}
+		throw FileFormatException("Malformed statistics number \"" + number + "\"!");
+	}
+}
+
+///@pkg ID3Statistics.h
+Histogram::Histogram() : buckets(), valueCount(0), valueTotal(0), minValue(0), maxValue(0) {}
+
+///@pkg ID3Statistics.h
+void Histogram::add(const ulong value) {
+	ushort bucket = 0;
+	for(ulong remaining = value; remaining != 0; remaining >>= 1) bucket++;
+	buckets[bucket]++;
+	
+	minValue = valueCount == 0 || value < minValue ? value : minValue;
+	maxValue = value > maxValue ? value : maxValue;
+	valueCount++;
+	valueTotal += value;
+}
+
+///@pkg ID3Statistics.h
+void Histogram::merge(const Histogram& other) {
+	if(other.valueCount == 0) return;
+	for(ushort bucket = 0; bucket < BUCKETS; bucket++) buckets[bucket] += other.buckets[bucket];
+	
+	minValue = valueCount == 0 || other.minValue < minValue ? other.minValue : minValue;
+	maxValue = other.maxValue > maxValue ? other.maxValue : maxValue;
+	valueCount += other.valueCount;
+	valueTotal += other.valueTotal;
+}
+
+///@pkg ID3Statistics.h
+ulong Histogram::count() const { return valueCount; }
+
+///@pkg ID3Statistics.h
+ulong Histogram::total() const { return valueTotal; }
+
+///@pkg ID3Statistics.h
+ulong Histogram::min() const { return minValue; }
+
+///@pkg ID3Statistics.h
+ulong Histogram::max() const { return maxValue; }
+
+///@pkg ID3Statistics.h
+ulong Histogram::bucket(const ushort bucket) const { return bucket < BUCKETS ? buckets[bucket] : 0; }
+
+///@pkg ID3Statistics.h
+ulong Histogram::bucketStart(const ushort bucket) { return bucket == 0 ? 0 : 1UL << (bucket - 1); }
+
+///@pkg ID3Statistics.h
+bool Histogram::operator==(const Histogram& other) const {
+	return memcmp(buckets, other.buckets, sizeof(buckets)) == 0 && valueCount == other.valueCount &&
+	       valueTotal == other.valueTotal && minValue == other.minValue && maxValue == other.maxValue;
+}
+
+///@pkg ID3Statistics.h
+void Histogram::write(std::ostream& os) const {
+	os << valueCount << ' ' << valueTotal << ' ' << minValue << ' ' << maxValue;
+	for(ushort bucket = 0; bucket < BUCKETS; bucket++)
+		if(buckets[bucket] != 0) os << ' ' << bucket << ':' << buckets[bucket];
+}
+
+///@pkg ID3Statistics.h
+void Histogram::read(std::istream& is) {
+	*this = Histogram();
+	valueCount = readNumber(is);
+	valueTotal = readNumber(is);
+	minValue = readNumber(is);
+	maxValue = readNumber(is);
+	
+	ulong bucketTotal = 0;
+	std::string bucket;
+	while(is >> bucket) {
+		const size_t colon = bucket.find(':');
+		std::istringstream number(colon == std::string::npos ? bucket : bucket.substr(0, colon) + ' ' + bucket.substr(colon + 1));
+		const ulong position = readNumber(number);
+		if(colon == std::string::npos || position >= BUCKETS)
+			throw FileFormatException("Malformed histogram bucket \"" + bucket + "\"!");
+		buckets[position] = readNumber(number);
+		bucketTotal += buckets[position];
+	}
+	if(bucketTotal != valueCount)
+		throw FileFormatException("Histogram buckets don't add up to its count!");
+}
+
+///@pkg ID3Statistics.h
+TagStatistics::TagStatistics() : files(0),
+                                 unreadableFiles(0),
+                                 v1Tags(0),
+                                 v1ExtendedTags(0),
+                                 v2Tags(0),
+                                 malformedTags(0),
+                                 unsynchronisedTags(0),
+                                 extendedHeaders(0),
+                                 footers(0),
+                                 unsynchronisedFrames(0),
+                                 compressedFrames(0),
+                                 encryptedFrames(0),
+                                 groupedFrames(0) {}
+
+///@pkg ID3Statistics.h
+void TagStatistics::add(const std::string& fileLoc) {
+	std::ifstream file(fileLoc, std::ios::in | std::ios::binary | std::ios::ate);
+	if(!file.is_open()) {
+		unreadableFiles++;
+		return;
+	}
+	add(file, file.tellg());
+}
+
+///@pkg ID3Statistics.h
+void TagStatistics::add(std::istream& file, const ulong fileSize) {
+	files++;
+	
+	//Look for ID3v1 and ID3v1 Extended tags with one read
+	const ulong V1_READ_SIZE = V1::BYTE_SIZE + V1::EXTENDED_BYTE_SIZE;
+	if(fileSize >= V1::BYTE_SIZE) {
+		const ulong readSize = fileSize >= V1_READ_SIZE ? V1_READ_SIZE : V1::BYTE_SIZE;
+		char tail[V1::BYTE_SIZE + V1::EXTENDED_BYTE_SIZE];
+		file.clear();
+		file.seekg(fileSize - readSize, std::ios_base::beg);
+		IOThrottle::charge(readSize);
+		file.read(tail, readSize);
+		if(file && memcmp(tail + readSize - V1::BYTE_SIZE, "TAG", 3) == 0) {
+			v1Tags++;
+			if(readSize == V1_READ_SIZE && memcmp(tail, "TAG+", 4) == 0) v1ExtendedTags++;
+		}
+	}
+	
+	//Read the ID3v2 header
+	ulong tagStart, tagLimit;
+	if(!locateV2Tag(file, fileSize, tagStart, tagLimit) || tagStart + HEADER_BYTE_SIZE > tagLimit) return;
+	uint8_t header[10];
+	file.clear();
+	file.seekg(tagStart, std::ios_base::beg);
+	IOThrottle::charge(HEADER_BYTE_SIZE);
+	file.read(reinterpret_cast<char*>(header), HEADER_BYTE_SIZE);
+	if(!file || memcmp(header, "ID3", 3) != 0) return;
+	
+	const ushort VERSION = header[3];
+	const uint8_t FLAGS = header[5];
+	const ulong TAG_SIZE = byteIntVal(header + 6, 4, true);
+	versions[VERSION]++;
+	if(VERSION < 2 || VERSION > 4) return;
+	
+	v2Tags++;
+	tagSizes.add(HEADER_BYTE_SIZE + TAG_SIZE);
+	if(FLAGS & FLAG_UNSYNCHRONISATION) unsynchronisedTags++;
+	if(FLAGS & FLAG_EXT_HEADER) extendedHeaders++;
+	if(VERSION >= 4 && (FLAGS & FLAG_FOOTER)) footers++;
+	
+	//The frames of unsynchronised ID3v2.3 and earlier tags can't be walked
+	//without reading the whole tag, and ID3::Tag doesn't read them either
+	if(VERSION <= 3 && (FLAGS & FLAG_UNSYNCHRONISATION)) return;
+	
+	const ulong TAG_END = tagStart + HEADER_BYTE_SIZE + TAG_SIZE;
+	if(TAG_END > tagLimit) {
+		malformedTags++;
+		return;
+	}
+	
+	//Skip the extended header. Its size includes the size field in ID3v2.4,
+	//but not in ID3v2.3. ID3v2.2 uses the flag for compression instead.
+	ulong pos = tagStart + HEADER_BYTE_SIZE;
+	if(FLAGS & FLAG_EXT_HEADER) {
+		uint8_t extSize[4];
+		if(VERSION <= 2 || pos + 4 > TAG_END) return;
+		IOThrottle::charge(4);
+		file.read(reinterpret_cast<char*>(extSize), 4);
+		if(!file) return;
+		pos += VERSION >= 4 ? byteIntVal(extSize, 4, true) : 4 + byteIntVal(extSize, 4);
+	}
+	
+	//Walk the frame headers, the same way ID3::Tag::readFileV2() does
+	const ushort FRAME_HEADER = VERSION <= 2 ? 6 : HEADER_BYTE_SIZE;
+	uint8_t frame[10 + FRAME_PEEK_SIZE];
+	while(pos + FRAME_HEADER <= TAG_END) {
+		const ulong readSize = std::min<ulong>(sizeof(frame), TAG_END - pos);
+		file.seekg(pos, std::ios_base::beg);
+		IOThrottle::charge(readSize);
+		file.read(reinterpret_cast<char*>(frame), readSize);
+		if(!file) {
+			malformedTags++;
+			return;
+		}
+		
+		//The padding starts at the first null byte
+		if(frame[0] == '\0') break;
+		
+		const ushort idSize = VERSION <= 2 ? 3 : 4;
+		bool validID = true;
+		for(ushort i = 0; i < idSize; i++) validID = validID && frameIDByte(frame[i]);
+		const ulong size = VERSION <= 2 ? byteIntVal(frame + 3, 3) : byteIntVal(frame + 4, 4, VERSION >= 4);
+		if(!validID || size > TAG_END - pos - FRAME_HEADER) {
+			malformedTags++;
+			return;
+		}
+		
+		const std::string id(reinterpret_cast<char*>(frame), idSize);
+		frames[id]++;
+		frameSizes.add(FRAME_HEADER + size);
+		
+		//Count the flags, and find where the frame body starts
+		ulong bodyStart = FRAME_HEADER;
+		bool readable = true;
+		if(VERSION == 3) {
+			readable = (frame[9] & (Frame::FLAG2_COMPRESSED_V3 | Frame::FLAG2_ENCRYPTED_V3)) == 0;
+			if(frame[9] & Frame::FLAG2_COMPRESSED_V3) compressedFrames++, bodyStart += 4;
+			if(frame[9] & Frame::FLAG2_ENCRYPTED_V3) encryptedFrames++, bodyStart++;
+			if(frame[9] & Frame::FLAG2_GROUPING_IDENTITY_V3) groupedFrames++, bodyStart++;
+		} else if(VERSION >= 4) {
+			readable = (frame[9] & (Frame::FLAG2_COMPRESSED_V4 | Frame::FLAG2_ENCRYPTED_V4 |
+			                        Frame::FLAG2_UNSYNCHRONISED_V4)) == 0;
+			if(frame[9] & Frame::FLAG2_GROUPING_IDENTITY_V4) groupedFrames++, bodyStart++;
+			if(frame[9] & Frame::FLAG2_COMPRESSED_V4) compressedFrames++;
+			if(frame[9] & Frame::FLAG2_ENCRYPTED_V4) encryptedFrames++, bodyStart++;
+			if(frame[9] & Frame::FLAG2_UNSYNCHRONISED_V4) unsynchronisedFrames++;
+			if(frame[9] & Frame::FLAG2_DATA_LENGTH_INDICATOR_V4) bodyStart += 4;
+		}
+		
+		//Peek at the start of readable text and picture frame bodies
+		const ulong peekEnd = std::min<ulong>(readSize, FRAME_HEADER + size);
+		if(readable && bodyStart < peekEnd) {
+			const bool text = id[0] == 'T' || id == "COMM" || id == "USLT" || id == "COM" || id == "ULT";
+			const bool picture = id == "APIC" || id == "PIC";
+			if(text || picture) encodings[frame[bodyStart]]++;
+			if(picture) {
+				pictureSizes.add(FRAME_HEADER + size - bodyStart);
+				
+				//The MIME type is null-terminated, or a 3-character image
+				//format in ID3v2.2
+				const char* mime = reinterpret_cast<char*>(frame) + bodyStart + 1;
+				const ulong mimeSpace = peekEnd > bodyStart + 1 ? peekEnd - bodyStart - 1 : 0;
+				ulong mimeSize = VERSION <= 2 ? std::min<ulong>(3, mimeSpace) : mimeSpace;
+				const void* terminator = memchr(mime, '\0', mimeSize);
+				if(terminator != nullptr) mimeSize = static_cast<const char*>(terminator) - mime;
+				std::string mimeType(mime, mimeSize);
+				for(char& character : mimeType) character = tolower(character);
+				mimeTypes[mimeType]++;
+			}
+		}
+		
+		pos += FRAME_HEADER + size;
+	}
+	
+	paddingSizes.add(TAG_END - pos);
+}
+
+///@pkg ID3Statistics.h
+void TagStatistics::merge(const TagStatistics& other) {
+	files += other.files;
+	unreadableFiles += other.unreadableFiles;
+	v1Tags += other.v1Tags;
+	v1ExtendedTags += other.v1ExtendedTags;
+	v2Tags += other.v2Tags;
+	malformedTags += other.malformedTags;
+	mergeCounts(versions, other.versions);
+	unsynchronisedTags += other.unsynchronisedTags;
+	extendedHeaders += other.extendedHeaders;
+	footers += other.footers;
+	unsynchronisedFrames += other.unsynchronisedFrames;
+	compressedFrames += other.compressedFrames;
+	encryptedFrames += other.encryptedFrames;
+	groupedFrames += other.groupedFrames;
+	tagSizes.merge(other.tagSizes);
+	paddingSizes.merge(other.paddingSizes);
+	frameSizes.merge(other.frameSizes);
+	mergeCounts(frames, other.frames);
+	mergeCounts(encodings, other.encodings);
+	pictureSizes.merge(other.pictureSizes);
+	mergeCounts(mimeTypes, other.mimeTypes);
+}
+
+///@pkg ID3Statistics.h
+void TagStatistics::print(std::ostream& os) const {
+	os << "Files: " << files << " read, " << unreadableFiles << " unreadable" << std::endl
+	   << "ID3v1 tags: " << v1Tags << " (" << v1ExtendedTags << " with ID3v1 Extended)" << std::endl
+	   << "ID3v2 tags: " << v2Tags << " (" << malformedTags << " malformed)" << std::endl;
+	for(const auto& version : versions)
+		os << "\tID3v2." << version.first << ": " << version.second << std::endl;
+	os << "Unsynchronised tags: " << unsynchronisedTags << std::endl
+	   << "Extended headers: " << extendedHeaders << std::endl
+	   << "Footers: " << footers << std::endl
+	   << "Unsynchronised frames: " << unsynchronisedFrames << std::endl
+	   << "Compressed frames: " << compressedFrames << std::endl
+	   << "Encrypted frames: " << encryptedFrames << std::endl
+	   << "Grouped frames: " << groupedFrames << std::endl;
+	printHistogram(os, "Tag sizes", tagSizes);
+	printHistogram(os, "Padding sizes", paddingSizes);
+	printHistogram(os, "Frame sizes", frameSizes);
+	os << "Frames:" << std::endl;
+	for(const auto& frame : frames) os << "\t" << frame.first << ": " << frame.second << std::endl;
+	os << "Text encodings:" << std::endl;
+	for(const auto& encoding : encodings) os << "\t" << encoding.first << ": " << encoding.second << std::endl;
+	printHistogram(os, "Picture sizes", pictureSizes);
+	os << "Picture MIME types:" << std::endl;
+	for(const auto& mimeType : mimeTypes) os << "\t" << mimeType.first << ": " << mimeType.second << std::endl;
+}
+
+///@pkg ID3Statistics.h
+void TagStatistics::write(std::ostream& os) const {
+	os << STATISTICS_FORMAT << ' ' << STATISTICS_FORMAT_VERSION << '\n';
+	for(const auto& field : COUNTS) os << field.first << ' ' << this->*field.second << '\n';
+	for(const auto& field : HISTOGRAMS) {
+		os << field.first << ' ';
+		(this->*field.second).write(os);
+		os << '\n';
+	}
+	for(const auto& version : versions) os << "version " << version.first << ' ' << version.second << '\n';
+	for(const auto& frame : frames) os << "frame " << escapeKey(frame.first) << ' ' << frame.second << '\n';
+	for(const auto& encoding : encodings) os << "encoding " << encoding.first << ' ' << encoding.second << '\n';
+	for(const auto& mimeType : mimeTypes) os << "mimeType " << escapeKey(mimeType.first) << ' ' << mimeType.second << '\n';
+	os << "end\n";
+}
+
+///@pkg ID3Statistics.h
+TagStatistics TagStatistics::read(std::istream& is) {
+	TagStatistics statistics;
+	
+	//Check the format and version
+	std::string line;
+	std::getline(is, line);
+	if(line.compare(0, STATISTICS_FORMAT.size() + 1, STATISTICS_FORMAT + ' ') != 0)
+		throw FileFormatException("Not a statistics file!");
+	std::istringstream versionLine(line.substr(STATISTICS_FORMAT.size()));
+	if(readNumber(versionLine) > STATISTICS_FORMAT_VERSION)
+		throw FileFormatException("The statistics were written by a newer version of the library!");
+	
+	while(std::getline(is, line)) {
+		std::istringstream fields(line);
+		std::string name;
+		fields >> name;
+		if(name == "end") return statistics;
+		
+		bool known = false;
+		for(const auto& field : COUNTS) {
+			if(name != field.first) continue;
+			statistics.*field.second = readNumber(fields);
+			known = true;
+		}
+		for(const auto& field : HISTOGRAMS) {
+			if(name != field.first) continue;
+			(statistics.*field.second).read(fields);
+			known = true;
+		}
+		if(known) continue;
+		
+		//The maps have one line per entry
+		std::string key;
+		if(name == "version") {
+			const ulong version = readNumber(fields);
+			statistics.versions[version] = readNumber(fields);
+		} else if(name == "encoding") {
+			const ulong encoding = readNumber(fields);
+			statistics.encodings[encoding] = readNumber(fields);
+		} else if(name == "frame" && fields >> key) {
+			statistics.frames[unescapeKey(key)] = readNumber(fields);
+		} else if(name == "mimeType" && fields >> key) {
+			statistics.mimeTypes[unescapeKey(key)] = readNumber(fields);
+		} else {
+			throw FileFormatException("Unknown statistics line \"" + line + "\"!");
+		}
+	}
+	
+	throw FileFormatException("The statistics end early!");
+}
+
+///@pkg ID3Statistics.h
+bool TagStatistics::operator==(const TagStatistics& other) const {
+	for(const auto& field : COUNTS)
+		if(this->*field.second != other.*field.second) return false;
+	for(const auto& field : HISTOGRAMS)
+		if(!(this->*field.second == other.*field.second)) return false;
+	return versions == other.versions && frames == other.frames &&
+	       encodings == other.encodings && mimeTypes == other.mimeTypes;
+}
+
+///@pkg ID3Statistics.h
+TagStatistics TagStatistics::collect(const std::vector<std::string>& files, const BatchOptions& options) {
+	const Batch batch(files, options);
+	std::vector<TagStatistics> workerStatistics(batch.workers());
+	batch.run([&files, &workerStatistics](const size_t file, const unsigned worker) {
+		workerStatistics[worker].add(files[file]);
+	});
+	
+	TagStatistics statistics;
+	for(const TagStatistics& partial : workerStatistics) statistics.merge(partial);
+	return statistics;
+}
+
+///@pkg ID3Statistics.h
+TagStatistics TagStatistics::collect(const std::vector<std::string>& files,
+                                     const ProcessBatchOptions&      options,
+                                     std::vector<BatchError>*        errors) {
+	TagStatistics statistics;
+	const ProcessBatch batch(files, options);
+	const std::vector<BatchError> failed = batch.run([&files](const size_t file) {
+		TagStatistics fileStatistics;
+		fileStatistics.add(files[file]);
+		std::ostringstream os;
+		fileStatistics.write(os);
+		return os.str();
+	}, [&statistics](const size_t, const std::string& result) {
+		std::istringstream is(result);
+		statistics.merge(read(is));
+	});
+	
+	statistics.unreadableFiles += failed.size();
+	if(errors != nullptr) *errors = failed;
+	return statistics;
+}
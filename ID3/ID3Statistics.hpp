@@ -0,0 +1,275 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_STATISTICS_HPP
+#define ID3_STATISTICS_HPP
+
+#include <istream> //For std::istream
+#include <map>     //For std::map
+#include <ostream> //For std::ostream
+#include <string>  //For std::string
+#include <vector>  //For std::vector
+
+#include "ID3Batch.hpp"        //For BatchOptions and BatchError
+#include "ID3ProcessBatch.hpp" //For ProcessBatchOptions
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * A histogram of sizes with one bucket per power of two. Bucket 0 counts
+	 * the value 0, and bucket n counts values from 2^(n-1) to 2^n - 1.
+	 * 
+	 * Histograms only hold counts, so merging two histograms gives exactly the
+	 * histogram of both sets of values.
+	 * 
+	 * Defined in ID3Statistics.cpp.
+	 */
+	class Histogram {
+		public:
+			/**
+			 * The number of buckets.
+			 */
+			static const ushort BUCKETS = 65;
+			
+			/**
+			 * Create an empty histogram.
+			 */
+			Histogram();
+			
+			/**
+			 * Add a value.
+			 * 
+			 * @param value The value.
+			 */
+			void add(const ulong value);
+			
+			/**
+			 * Add the values of another histogram.
+			 * 
+			 * @param other The other histogram.
+			 */
+			void merge(const Histogram& other);
+			
+			/**
+			 * @return The number of values.
+			 */
+			ulong count() const;
+			
+			/**
+			 * @return The sum of the values.
+			 */
+			ulong total() const;
+			
+			/**
+			 * @return The smallest value, or 0 if there are none.
+			 */
+			ulong min() const;
+			
+			/**
+			 * @return The biggest value, or 0 if there are none.
+			 */
+			ulong max() const;
+			
+			/**
+			 * @param bucket The bucket number.
+			 * @return The number of values in the bucket, or 0 if the bucket
+			 *         number is too big.
+			 */
+			ulong bucket(const ushort bucket) const;
+			
+			/**
+			 * @param bucket The bucket number.
+			 * @return The smallest value that goes in the bucket.
+			 */
+			static ulong bucketStart(const ushort bucket);
+			
+			/**
+			 * @return If both histograms hold the same counts.
+			 */
+			bool operator==(const Histogram& other) const;
+			
+			/**
+			 * Write the histogram as space-separated numbers: the count, total,
+			 * min, and max, then bucket:count for each non-empty bucket.
+			 * 
+			 * @param os The output stream.
+			 */
+			void write(std::ostream& os) const;
+			
+			/**
+			 * Read a histogram written with write(), replacing this one.
+			 * 
+			 * @param is The input stream, which is read to its end.
+			 * @throws ID3::FileFormatException if the histogram is malformed.
+			 */
+			void read(std::istream& is);
+		
+		private:
+			ulong buckets[BUCKETS]; //The count of each bucket
+			ulong valueCount;       //The number of values
+			ulong valueTotal;       //The sum of the values
+			ulong minValue;         //The smallest value
+			ulong maxValue;         //The biggest value
+	};
+	
+	/**
+	 * TagStatistics describes the tags of many files: the ID3v2 versions, tag
+	 * and padding sizes, frame IDs, text encodings, picture sizes and MIME
+	 * types, and how often each header flag is set.
+	 * 
+	 * Only the ID3v2 header and the frame headers are read, along with the
+	 * first few bytes of text and picture frames for the encoding and MIME
+	 * type, so picture data and text are never read or converted. The frames
+	 * are walked the same way as ID3::Tag reads them.
+	 * 
+	 * Every field is a count, so statistics collected on separate threads or
+	 * for separate parts of a library can be merged with merge() to get exactly
+	 * the statistics of all of the files.
+	 * 
+	 * Defined in ID3Statistics.cpp.
+	 */
+	struct TagStatistics {
+		/**
+		 * Create empty statistics.
+		 */
+		TagStatistics();
+		
+		ulong files;                            //The number of files added
+		ulong unreadableFiles;                  //The number of files that couldn't be opened
+		ulong v1Tags;                           //The number of files with an ID3v1 tag
+		ulong v1ExtendedTags;                   //The number of files with an ID3v1 Extended tag
+		ulong v2Tags;                           //The number of files with a supported ID3v2 tag
+		ulong malformedTags;                    //The number of ID3v2 tags that stopped on a bad frame or size
+		
+		std::map<ushort, ulong> versions;       //The number of ID3v2 tags for each major version
+		
+		ulong unsynchronisedTags;               //ID3v2 tags with the unsynchronisation flag
+		ulong extendedHeaders;                  //ID3v2 tags with an extended header
+		ulong footers;                          //ID3v2 tags with a footer
+		ulong unsynchronisedFrames;             //ID3v2.4 frames with the unsynchronisation flag
+		ulong compressedFrames;                 //Frames with the compression flag
+		ulong encryptedFrames;                  //Frames with the encryption flag
+		ulong groupedFrames;                    //Frames with a grouping identity
+		
+		Histogram tagSizes;                     //The size of each ID3v2 tag, with its header
+		Histogram paddingSizes;                 //The padding at the end of each ID3v2 tag
+		Histogram frameSizes;                   //The size of each frame, with its header
+		
+		std::map<std::string, ulong> frames;    //The number of frames with each frame ID, as it is on file
+		std::map<ushort, ulong> encodings;      //The number of text and picture frames with each encoding byte
+		
+		Histogram pictureSizes;                 //The size of each picture frame body
+		std::map<std::string, ulong> mimeTypes; //The number of pictures with each MIME type, in lower case
+		
+		/**
+		 * Add the tags of a file.
+		 * 
+		 * NOTE: If the file can't be opened, only unreadableFiles changes.
+		 * 
+		 * @param fileLoc The file path.
+		 */
+		void add(const std::string& fileLoc);
+		
+		/**
+		 * Add the tags of a file.
+		 * 
+		 * @param file     The file stream object.
+		 * @param fileSize The size of the file.
+		 */
+		void add(std::istream& file, const ulong fileSize);
+		
+		/**
+		 * Add the statistics of other files.
+		 * 
+		 * @param other The other statistics.
+		 */
+		void merge(const TagStatistics& other);
+		
+		/**
+		 * Print the statistics in a human-readable form.
+		 * 
+		 * @param os The output stream.
+		 */
+		void print(std::ostream& os) const;
+		
+		/**
+		 * Write the statistics in a stable text format that can be read back
+		 * exactly with read(), such as to save the statistics of one shard of
+		 * a library to merge later.
+		 * 
+		 * The first line is "ID3-Tagging-Library statistics" followed by the
+		 * format version. Each line after it is a field name followed by its
+		 * value, with one line for each map entry. Map keys have bytes that
+		 * aren't printable ASCII, spaces, and % written as %XX. The last line
+		 * is "end".
+		 * 
+		 * @param os The output stream.
+		 */
+		void write(std::ostream& os) const;
+		
+		/**
+		 * Read statistics written with write().
+		 * 
+		 * @param is The input stream. It's read up to and including the "end"
+		 *           line, so more data can follow.
+		 * @return The statistics.
+		 * @throws ID3::FileFormatException if the statistics are malformed,
+		 *         or were written by a newer format version.
+		 */
+		static TagStatistics read(std::istream& is);
+		
+		/**
+		 * @return If both statistics hold the same counts.
+		 */
+		bool operator==(const TagStatistics& other) const;
+		
+		/**
+		 * Collect the statistics of many files in parallel. Each worker keeps
+		 * its own statistics, which are merged once every file is done.
+		 * 
+		 * @param files   The file paths.
+		 * @param options The batch options.
+		 * @return The statistics of all of the files.
+		 */
+		static TagStatistics collect(const std::vector<std::string>& files,
+		                             const BatchOptions&             options=BatchOptions());
+		
+		/**
+		 * Collect the statistics of many files in worker processes, so a file
+		 * that crashes or hangs the reader doesn't stop the rest. Each file's
+		 * statistics are sent back in the format of write().
+		 * 
+		 * NOTE: Files that fail, time out, or crash a worker are counted as
+		 *       unreadable.
+		 * 
+		 * @param files   The file paths.
+		 * @param options The process batch options.
+		 * @param errors  Set to the files that failed (optional).
+		 * @return The statistics of all of the files.
+		 * @see ID3::ProcessBatch
+		 */
+		static TagStatistics collect(const std::vector<std::string>& files,
+		                             const ProcessBatchOptions&      options,
+		                             std::vector<BatchError>*        errors=nullptr);
+	};
+}
+
+#endif
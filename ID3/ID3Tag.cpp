@@ -11,13 +11,17 @@
  **********************************************************************/
 
 #include <iostream>  //For std::string
-#include <cstring>   //For memcmp()
-#include <regex>     //For regular expressions
-#include <time.h>    //For strftime()
+#include <algorithm> //For std::min(), std::find_if(), std::remove(), std::remove_if(), std::sort(), and std::binary_search()
+#include <limits>    //For std::numeric_limits
+#include <cstring>   //For memcmp(), memcpy(), and memset()
 
 #include "ID3.hpp"                      //For the Tag class definition
 #include "ID3Functions.hpp"             //For assorted functions
+#include "ID3Genre.hpp"                 //For parseGenres() and V1::getGenreID()
 #include "ID3FrameFactory.hpp"          //For FrameFactory
+#include "ID3ByteSource.hpp"            //For FileByteSource and ByteSourceStream
+#include "ID3SharedFrames.hpp"          //For SharedFrames
+#include "ID3IOThrottle.hpp"            //For IOThrottle::charge()
 #include "Frames/ID3TextFrame.hpp"      //For TextFrame
 #include "Frames/ID3PictureFrame.hpp"   //For PictureFrame
 #include "Frames/ID3PlayCountFrame.hpp" //For PlayCountFrame
@@ -34,63 +38,130 @@ namespace {
 	 * @see ID3::Tag::genre(bool)
 	 */
 	static std::string processGenre(const std::string& genre) {
-		if(genre.empty()) return "";
-		std::string genreString;
-		
-		if(numericalString(genre)) {
-			genreString = V1::getGenreString(atoi(genre.c_str()));
-		} else {
-			//This regex matches any digit surrounded by a single pair of
-			//parenthesis at the start of a string
-			std::regex findV1Genre("^\\(\\d+\\)");
-			std::smatch v1Genre;
-			
-			//If a ID3v1 genre is found
-			if(std::regex_search(genre, v1Genre, findV1Genre)) {
-				//Get the match
-				std::string genreIntStr = v1Genre.str();
-				//Get the int value of the ID3v1 genre
-				int genreInt = atoi(genreIntStr.substr(1, genreIntStr.length() - 1).c_str());
-				//Remove the string from the tag string
-				genreString = std::regex_replace(genre, findV1Genre, "");
-				//If there's nothing else in the tag string, then return
-				//the ID3v1 genre
-				if(genreString.empty()) genreString = V1::getGenreString(genreInt);
-			} else { genreString = genre; }
-		}
-		
-		return genreString;
+		//The last genre is the most specific one, which is the refinement
+		//text if there is any
+		const std::vector<std::string> genres = parseGenres(genre);
+		return genres.empty() ? "" : genres.back();
 	}
 	
 	/**
-	 * Check if a file is a valid MP3 or MP4 file.
+	 * Check if a file is a valid MP3, MP4, WAV, or AIFF file.
 	 * 
 	 * @param fileLoc The file location.
 	 * @throws NotMP3FileException if the file location is not valid.
 	 */
 	static void validateFileLocation(const std::string& fileLoc) {
 		//Check if the file is an MP3 file
-		if(!std::regex_search(fileLoc, std::regex("\\.(?:mp3|tag|mp4|m4a|m4p|m4b|m4r|m4v|wav|wave)$", std::regex::icase|std::regex::ECMAScript)))
-			throw NotMP3FileException("File \"" + fileLoc + "\" is not an MP3 or MP4 file!\n");
+		if(!supportedFileType(fileLoc))
+			throw NotMP3FileException("File \"" + fileLoc + "\" is not an MP3, MP4, WAV, or AIFF file!\n");
+	}
+	
+	/**
+	 * A 64-bit FNV-1a hash of picture data, so that pictures are only
+	 * compared byte by byte with the pictures that have the same hash.
+	 * 
+	 * @param picture The picture data.
+	 * @return The hash.
+	 */
+	static uint64_t pictureHash(const ByteArray& picture) {
+		uint64_t hash = 14695981039346656037ULL;
+		for(const uint8_t byte : picture) {
+			hash ^= byte;
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+	
+	/**
+	 * Write a number in decimal.
+	 * 
+	 * @param buffer The buffer to write to, with room for 20 characters.
+	 * @param number The number.
+	 * @return The number of characters written.
+	 */
+	static size_t formatNumber(char* buffer, ulong number) {
+		char digits[20];
+		size_t length = 0;
+		do {
+			digits[length++] = '0' + number % 10;
+			number /= 10;
+		} while(number > 0);
+		for(size_t i = 0; i < length; i++) buffer[i] = digits[length - i - 1];
+		return length;
+	}
+	
+	/**
+	 * Set a fixed-size ID3v1 field to the LATIN-1 bytes of a string, filling
+	 * the rest of the field with zeros.
+	 * 
+	 * @param field  The field.
+	 * @param size   The size of the field.
+	 * @param latin1 The LATIN-1 bytes of the string.
+	 * @param skip   The bytes of the string that are in an earlier field.
+	 */
+	static void setV1Field(char* field, const size_t size, const ByteArray& latin1, const size_t skip=0) {
+		memset(field, 0, size);
+		if(latin1.size() > skip) memcpy(field, &latin1[skip], std::min(size, latin1.size() - skip));
 	}
 	
 	/**
-	 * Get a timestamp of the current time in UTC, formatted according to the
-	 * ID3v2.4.0 standard (YYYY-MM-ddTHH:mm:ss).
+	 * Build an ID3v1 tag from a Tag's frames. It's an ID3v1.1 tag if the
+	 * track number fits in one byte.
 	 * 
-	 * @return The formatted timestamp.
+	 * @param tag The Tag.
+	 * @return The bytes of the tag.
 	 */
-	static std::string getCurrentID3V4Timestamp() {
-		try {
-			time_t rawtime;
-			time(&rawtime);
-			struct tm* utctime = gmtime(&rawtime);
-			char buffer [20];
-			strftime(buffer, 20, "%Y-%m-%dT%H:%M:%S", utctime);
-			return std::string(buffer, 20);
-		} catch(...) {
-			return "";
+	static ByteArray v1TagBytes(const Tag& tag) {
+		V1::Tag tags;
+		memcpy(tags.header, "TAG", 3);
+		setV1Field(tags.title,   30, getEncodedString(ENCODING_LATIN1, tag.title()));
+		setV1Field(tags.artist,  30, getEncodedString(ENCODING_LATIN1, tag.artist()));
+		setV1Field(tags.album,   30, getEncodedString(ENCODING_LATIN1, tag.album()));
+		setV1Field(tags.year,    4,  getEncodedString(ENCODING_LATIN1, tag.year()));
+		setV1Field(tags.comment, 30, getEncodedString(ENCODING_LATIN1, tag.text(Frames::FRAME_COMMENT).text));
+		
+		//ID3v1.1 keeps the track number in the last byte of the comment
+		const std::string track = tag.track();
+		const ulong trackNum = !track.empty() && track.size() <= 3 && numericalString(track) ? std::stoul(track) : 0;
+		if(trackNum > 0 && trackNum <= 0xFF) {
+			tags.comment[28] = '\0';
+			tags.comment[29] = static_cast<char>(trackNum);
 		}
+		
+		//Use the first genre that's an ID3v1 genre
+		tags.genre = 0xFF;
+		for(const std::string& genre : tag.genres()) {
+			const short genreID = V1::getGenreID(genre);
+			if(genreID < 0) continue;
+			tags.genre = genreID;
+			break;
+		}
+		
+		ByteArray bytes(V1::BYTE_SIZE);
+		memcpy(&bytes.front(), &tags, V1::BYTE_SIZE);
+		return bytes;
+	}
+	
+	/**
+	 * Build an ID3v1 Extended tag from a Tag's frames. The title, artist, and
+	 * album continue from the 30th character, and the speed, start time, and
+	 * end time are kept from the old tag.
+	 * 
+	 * @param tag      The Tag.
+	 * @param oldBytes The bytes of the ID3v1 Extended tag on file.
+	 * @return The bytes of the tag.
+	 */
+	static ByteArray v1ExtendedTagBytes(const Tag& tag, const ByteArray& oldBytes) {
+		V1::ExtendedTag tags;
+		memcpy(&tags, &oldBytes.front(), V1::EXTENDED_BYTE_SIZE);
+		setV1Field(tags.title,  60, getEncodedString(ENCODING_LATIN1, tag.title()),  30);
+		setV1Field(tags.artist, 60, getEncodedString(ENCODING_LATIN1, tag.artist()), 30);
+		setV1Field(tags.album,  60, getEncodedString(ENCODING_LATIN1, tag.album()),  30);
+		setV1Field(tags.genre,  30, getEncodedString(ENCODING_LATIN1, tag.genre()));
+		
+		ByteArray bytes(V1::EXTENDED_BYTE_SIZE);
+		memcpy(&bytes.front(), &tags, V1::EXTENDED_BYTE_SIZE);
+		return bytes;
 	}
 }
 
@@ -101,14 +172,17 @@ Tag::Tag(const std::string& fileLoc) : Tag(fileLoc, true) {}
 Tag::Tag(const std::string& fileLoc, const bool readFrames) : filename(fileLoc), filesize(0) {
 	validateFileLocation(fileLoc); //Throws NotMP3FileException
 	
-	std::ifstream file(fileLoc, std::ios::in | std::ios::binary | std::ios::ate);
+	readFile(std::make_shared<FileByteSource>(fileLoc), readFrames); //Throws FileNotFoundException
+}
+
+///@pkg ID3.h
+Tag::Tag(const std::shared_ptr<const ByteSource>& source) : filesize(0) { readFile(source); }
+
+///@pkg ID3.h
+Tag::Tag(const std::string& fileLoc, const std::shared_ptr<const ByteSource>& source) : filename(fileLoc), filesize(0) {
+	validateFileLocation(fileLoc); //Throws NotMP3FileException
 	
-	if(file.is_open()) {
-		readFile(file, readFrames);
-		file.close();
-	} else {
-		throw FileNotFoundException("File \"" + filename + "\" cannot be opened!\n");
-	}
+	readFile(source);
 }
 
 ///@pkg ID3.h
@@ -120,6 +194,56 @@ Tag::operator bool() const noexcept { return !frames.empty(); }
 ///@pkg ID3.h
 bool Tag::operator!() const noexcept { return frames.empty(); }
 
+///@pkg ID3.h
+NumberPair::NumberPair(const ulong number, const ulong total) : number(number), total(total) {}
+
+///@pkg ID3.h
+NumberPair NumberPair::parse(const std::string& text) {
+	//Parse the digits up to the slash, then the digits after it. A field with
+	//anything else in it is 0.
+	NumberPair numbers;
+	ulong* field = &numbers.number;
+	bool valid = true;
+	for(const char character : text) {
+		if(character == '/' && field == &numbers.number) {
+			if(!valid) numbers.number = 0;
+			field = &numbers.total;
+			valid = true;
+		} else if(character >= '0' && character <= '9' && valid) {
+			*field = *field * 10 + (character - '0');
+		} else {
+			valid = false;
+		}
+	}
+	if(!valid) *field = 0;
+	return numbers;
+}
+
+///@pkg ID3.h
+WriteOptions::WriteOptions() : paddingFactor(0.1),
+                               maxPadding(std::numeric_limits<ulong>::max()),
+                               setFileNameUponSuccess(true),
+                               discardNonCoverPictures(false),
+                               discardUnknown(false),
+                               addTaggingTime(true),
+                               smallestEncoding(false),
+                               dedupePictures(false),
+                               dryRun(false),
+                               sharedFrames(nullptr),
+                               v1Policy(V1Policy::REMOVE) {}
+
+///@pkg ID3.h
+WritePlan::WritePlan() : rewrite(false),
+                         reason(WriteReason::IN_PLACE),
+                         removeV1(false),
+                         tagSize(0),
+                         padding(0),
+                         oldSize(0),
+                         movedBytes(0) {}
+
+///@pkg ID3.h
+WriteResult::WriteResult() : rewritten(false), oldSize(0), tagSize(0), padding(0), discardedFrames(0), replacedFrames(0) {}
+
 ///@pkg ID3.h
 void Tag::write(const std::string& fileLoc,
                 const float        paddingFactor,
@@ -127,16 +251,35 @@ void Tag::write(const std::string& fileLoc,
                 const bool         discardNonCoverPictures,
                 const bool         discardUnknown,
                 const bool         addTaggingTime) {
-	if(!setFileNameUponSuccess) filename = fileLoc;
-	validateFileLocation(fileLoc); //Throws NotMP3FileException
-	
-	//A newly-constructed Tag of the file, to get the most up-to-date file information
-	const Tag fileInfo(fileLoc, false);
-	
-	std::fstream file(fileLoc, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
-	if(!file.is_open())
-		throw FileNotFoundException("File \"" + fileLoc + "\" cannot be opened!\n");
-	
+	WriteOptions options;
+	options.paddingFactor           = paddingFactor;
+	options.setFileNameUponSuccess  = setFileNameUponSuccess;
+	options.discardNonCoverPictures = discardNonCoverPictures;
+	options.discardUnknown          = discardUnknown;
+	options.addTaggingTime          = addTaggingTime;
+	write(fileLoc, options);
+}
+
+///@pkg ID3.h
+Tag Tag::frameCopy() const {
+	Tag copy(*this);
+	copy.frames.clear();
+	copy.frameOrder.clear();
+	copy.framePositions.clear();
+	for(const Frame* const frame : frameOrder) {
+		if(frame == nullptr) continue;
+		const FramePtr copiedFrame(frame->clone());
+		copy.frames.emplace(copiedFrame->frame(), copiedFrame);
+		copy.frameOrder.push_back(copiedFrame.get());
+	}
+	return copy;
+}
+
+///@pkg ID3.h
+ByteArray Tag::tagData(const Tag&                 fileInfo,
+                       const WriteOptions&        options,
+                       std::vector<const Frame*>& discardedFrames,
+                       WriteResult&               result) {
 	//The ID3v2 tag data to write to file
 	ByteArray binaryTagData(10, '\0');
 	//Make the tags at least one KiB long
@@ -159,82 +302,273 @@ void Tag::write(const std::string& fileLoc,
 	
 	//Set the tagging time frame to the current UTC time, or delete it if
 	//addTaggingTime is false
-	if(addTaggingTime)
-		text(FRAME_TAGGING_TIME, getCurrentID3V4Timestamp());
+	if(options.addTaggingTime)
+		timestamp(FRAME_TAGGING_TIME, Timestamp::now());
 	else if(exists(FRAME_TAGGING_TIME))
 		text(FRAME_TAGGING_TIME, "");
 	
-	//Loop through every Frame and write it
+	//Find the frames that the options discard, so that they aren't written and
+	//can be deleted once the write succeeds
+	std::unordered_multimap<uint64_t, const PictureFrame*> keptPictures;
 	bool foundCoverPicture = false;
-	for(const FramePair& framePair : frames) {
-		//Ignore null and empty Frames
-		if(framePair.second.get() == nullptr || framePair.second->null() || framePair.second->empty()) continue;
+	for(const auto& framePair : frames) {
+		const Frame* const frame = framePair.second.get();
+		if(frame == nullptr || frame->null() || frame->empty()) continue;
+		
+		//Delete frames that are replaced by shared frames
+		if(options.sharedFrames != nullptr && options.sharedFrames->replaces(*frame)) {
+			discardedFrames.push_back(frame);
+			result.replacedFrames++;
+			continue;
+		}
+		
+		//Delete unknown frames if discardUnknown is true
+		if(options.discardUnknown && dynamic_cast<const UnknownFrame*>(frame) != nullptr) {
+			discardedFrames.push_back(frame);
+			continue;
+		}
+		
+		const PictureFrame* const pictureFrame = dynamic_cast<const PictureFrame*>(frame);
+		if(pictureFrame == nullptr) continue;
 		//Delete non-conforming pictures if discardNonCoverPictures is true
-		if(discardNonCoverPictures && dynamic_cast<PictureFrame*>(framePair.second.get()) != nullptr) {
-			if(!foundCoverPicture && dynamic_cast<PictureFrame*>(framePair.second.get())->pictureType() == PictureType::FRONT_COVER)
+		if(options.discardNonCoverPictures) {
+			if(!foundCoverPicture && pictureFrame->pictureType() == PictureType::FRONT_COVER) {
 				foundCoverPicture = true;
-			else
+			} else {
+				discardedFrames.push_back(frame);
 				continue;
+			}
 		}
-		//Delete unknown frames if discardUnknown is true
-		if(discardUnknown && dynamic_cast<UnknownFrame*>(framePair.second.get()) != nullptr) continue;
+		//Delete pictures with the same data as another picture if dedupePictures
+		//is true, keeping the front cover if one of them is
+		if(options.dedupePictures) {
+			const uint64_t PICTURE_HASH = pictureHash(pictureFrame->picture());
+			const auto RANGE = keptPictures.equal_range(PICTURE_HASH);
+			auto kept = std::find_if(RANGE.first, RANGE.second, [pictureFrame](const std::pair<const uint64_t, const PictureFrame*>& picture) {
+				return picture.second->samePicture(*pictureFrame);
+			});
+			if(kept == RANGE.second) {
+				keptPictures.emplace(PICTURE_HASH, pictureFrame);
+			} else if(pictureFrame->pictureType() == PictureType::FRONT_COVER && kept->second->pictureType() != PictureType::FRONT_COVER) {
+				discardedFrames.push_back(kept->second);
+				kept->second = pictureFrame;
+			} else {
+				discardedFrames.push_back(frame);
+			}
+		}
+	}
+	result.discardedFrames = discardedFrames.size() - result.replacedFrames;
+	
+	//Sort the discarded frames so that checking each frame is a binary search
+	std::sort(discardedFrames.begin(), discardedFrames.end());
+	
+	//Loop through every Frame and write it
+	for(const auto& framePair : frames) {
+		Frame* const frame = framePair.second.get();
+		//Ignore null and empty Frames, and the discarded frames
+		if(frame == nullptr || frame->null() || frame->empty() ||
+		   std::binary_search(discardedFrames.begin(), discardedFrames.end(), frame)) continue;
+		
+		//Use the smallest text encoding for this write if smallestEncoding is true
+		TextFrame* const textFrame = dynamic_cast<TextFrame*>(frame);
+		const bool frameSmallestEncoding = textFrame != nullptr && textFrame->smallestEncoding();
+		if(textFrame != nullptr && options.smallestEncoding) textFrame->smallestEncoding(true);
+		
+		ByteArray frameBytes = frame->write();
+		if(textFrame != nullptr) textFrame->smallestEncoding(frameSmallestEncoding);
 		
-		ByteArray frameBytes = framePair.second->write();
 		//If the Frame data is valid add the it to the tag data
 		if(frameBytes.size() > HEADER_BYTE_SIZE)
 			binaryTagData.insert(binaryTagData.end(), frameBytes.begin(), frameBytes.end());
 	}
+	return binaryTagData;
+}
+
+///@pkg ID3.h
+WritePlan Tag::planWrite(const Tag&          fileInfo,
+                         const WriteOptions& options,
+                         const ulong         frameBytes,
+                         const std::string&  fileLoc) const {
+	WritePlan plan;
+	//The shared frames are written after the Tag's frames
+	const ulong TAG_SIZE = frameBytes + (options.sharedFrames != nullptr ? options.sharedFrames->bytes() : 0);
+	plan.tagSize = TAG_SIZE;
+	
+	//WAV and AIFF files keep the tag in a chunk, which is moved to the end of
+	//the form instead of rewriting the file
+	const bool inChunk = fileInfo.chunkIndex.container() != ChunkContainer::NONE;
+	const Chunk* const id3Chunk = fileInfo.chunkIndex.id3Chunk();
+	//MP4 files keep the tag in an ID32 box, which can only be written in place
+	const bool inAtom = fileInfo.atomIndex.mp4();
+	
+	//The space that the tag can take up on file without moving the audio
+	const ulong SPACE_ON_FILE = inChunk ? (id3Chunk != nullptr ? id3Chunk->size : 0) :
+	                            inAtom  ? fileInfo.atomIndex.id3Space() :
+	                            (fileInfo.tagsSet.v2 ? fileInfo.v2TagInfo.totalSize : 0);
+	
+	//Removing the ID3v1 tags from the end of an MP3 file means rewriting it
+	plan.removeV1 = !inChunk && !inAtom && options.v1Policy == V1Policy::REMOVE &&
+	                (fileInfo.tagsSet.v1 || fileInfo.tagsSet.v1_1);
+	
+	//Whether the file needs to be completely rewritten (or, for WAV and AIFF
+	//files, whether the chunk needs to be moved). Files are also rewritten
+	//to reclaim space if the padding would be more than maxPadding.
+	if(plan.removeV1)
+		plan.reason = WriteReason::V1_TAIL;
+	else if(SPACE_ON_FILE == 0)
+		plan.reason = WriteReason::NO_V2_TAG;
+	else if(TAG_SIZE > SPACE_ON_FILE)
+		plan.reason = WriteReason::TAG_OVERFLOW;
+	else if(!inChunk && !inAtom && SPACE_ON_FILE - TAG_SIZE > options.maxPadding)
+		plan.reason = WriteReason::EXCESS_PADDING;
+	
+	//The space on file is reused, with padding filling the rest of it.
+	//This check if just being overly cautious, probably not necessary.
+	if(plan.reason == WriteReason::IN_PLACE && SPACE_ON_FILE > TAG_SIZE) {
+		if(SPACE_ON_FILE < MAX_TAG_SIZE)
+			plan.padding = SPACE_ON_FILE - TAG_SIZE;
+		else
+			plan.reason = WriteReason::EXCESS_PADDING;
+	}
+	plan.rewrite = plan.reason != WriteReason::IN_PLACE;
+	
+	//Moving boxes in an MP4 file would break the offsets to the audio data
+	if(inAtom && plan.rewrite)
+		throw WriteException("Cannot write tags to file \""+fileLoc+"\", there is no room for the tag in an ID32 or free box.");
+	
+	if(plan.rewrite && options.paddingFactor > 0.0) { //Append padding
+		//Get the padding size, then round it up to the next highest multiple of
+		//4096, but no more than maxPadding.
+		const ulong factorMult = TAG_SIZE + (TAG_SIZE * options.paddingFactor);
+		plan.padding = std::min((factorMult + (4096 - (factorMult % 4096))) - TAG_SIZE, options.maxPadding);
+		if(TAG_SIZE + plan.padding >= MAX_TAG_SIZE) plan.padding = 0;
+	}
 	
-	//Whether the file needs to be completely rewritten
-	bool needToRewriteFile = fileInfo.tagsSet.v1 || fileInfo.tagsSet.v1_1 || !fileInfo.tagsSet.v2 ||
-	                         binaryTagData.size() > fileInfo.v2TagInfo.totalSize;
+	//Validate the size by throwing a TagSizeException if it's too big
+	if(TAG_SIZE + plan.padding - HEADER_BYTE_SIZE > MAX_TAG_SIZE)
+		throw TagSizeException("Cannot write tags to file \""+fileLoc+"\", as it exceeds the maximum size of "+std::to_string(MAX_TAG_SIZE)+"!\n");
+	
+	plan.oldSize = SPACE_ON_FILE;
+	//The ID3v1 tags that are removed count towards the old size
+	if(plan.removeV1)
+		for(const TrailingTag& trailing : fileInfo.trailingTags().tags())
+			if(trailing.type == TrailingTagType::ID3V1 || trailing.type == TrailingTagType::ID3V1_EXTENDED)
+				plan.oldSize += trailing.size;
+	
+	//Rewriting an MP3 file moves the audio and the trailing tags that are
+	//kept, and moving a chunk moves what comes after the form
+	if(plan.rewrite && inChunk) {
+		plan.movedBytes = fileInfo.filesize > fileInfo.chunkIndex.formEnd() ? fileInfo.filesize - fileInfo.chunkIndex.formEnd() : 0;
+	} else if(plan.rewrite) {
+		const ulong AUDIO_START = fileInfo.tagsSet.v2 ? fileInfo.v2TagInfo.totalSize : 0;
+		plan.movedBytes = fileInfo.audioEnd() > AUDIO_START ? fileInfo.audioEnd() - AUDIO_START : 0;
+		for(const TrailingTag& trailing : fileInfo.trailingTags().tags()) {
+			const bool v1 = trailing.type == TrailingTagType::ID3V1 || trailing.type == TrailingTagType::ID3V1_EXTENDED;
+			if(!v1 || !plan.removeV1) plan.movedBytes += trailing.size;
+		}
+	}
+	
+	return plan;
+}
+
+///@pkg ID3.h
+WritePlan Tag::planWrite(const std::string& fileLoc, const WriteOptions& options) const {
+	validateFileLocation(fileLoc); //Throws NotMP3FileException
+	
+	//Read the file the same way write() does, without opening it for writing
+	const Tag fileInfo(fileLoc, false);
+	WriteResult result;
+	std::vector<const Frame*> discardedFrames;
+	//Building the tag prepares the frames for writing, so build it from copies
+	Tag preview = frameCopy();
+	return planWrite(fileInfo, options, preview.tagData(fileInfo, options, discardedFrames, result).size(), fileLoc);
+}
+
+///@pkg ID3.h
+WriteResult Tag::write(const std::string& fileLoc, const WriteOptions& options) {
+	if(!options.setFileNameUponSuccess && !options.dryRun) filename = fileLoc;
+	validateFileLocation(fileLoc); //Throws NotMP3FileException
+	
+	//A newly-constructed Tag of the file, to get the most up-to-date file information
+	const Tag fileInfo(fileLoc, false);
+	
+	//A dry run only needs to check that the file can be opened
+	std::fstream file(fileLoc, options.dryRun ? std::ios_base::in | std::ios_base::binary :
+	                                            std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+	if(!file.is_open())
+		throw FileNotFoundException("File \"" + fileLoc + "\" cannot be opened!\n");
+	
+	//Build the tag, then work out how to write it. Building the tag prepares
+	//the frames for writing, so a dry run builds it from copies of them.
+	WriteResult result;
+	std::vector<const Frame*> discardedFrames;
+	ByteArray binaryTagData = options.dryRun ? frameCopy().tagData(fileInfo, options, discardedFrames, result) :
+	                                           tagData(fileInfo, options, discardedFrames, result);
+	const WritePlan plan = planWrite(fileInfo, options, binaryTagData.size(), fileLoc);
+	const ulong TAG_SIZE = plan.tagSize, paddingSize = plan.padding;
+	const bool needToRewriteFile = plan.rewrite;
+	
+	//WAV and AIFF files keep the tag in a chunk, and MP4 files in an ID32 box
+	const bool inChunk = fileInfo.chunkIndex.container() != ChunkContainer::NONE;
+	const bool inAtom = fileInfo.atomIndex.mp4();
+	
+	result.rewritten = plan.rewrite;
+	result.tagSize = plan.tagSize;
+	result.padding = plan.padding;
+	result.oldSize = plan.oldSize;
+	if(options.dryRun) return result;
+	
+	//The ID3v1 tags written over the ones at the end of an MP3 file
+	const bool updateV1 = !inChunk && !inAtom && options.v1Policy == V1Policy::UPDATE;
+	ByteArray v1Bytes, v1ExtendedBytes;
+	if(updateV1 && fileInfo.trailingTags().v1Tag().size() == V1::BYTE_SIZE)
+		v1Bytes = v1TagBytes(*this);
+	if(updateV1 && fileInfo.trailingTags().v1ExtendedTag().size() == V1::EXTENDED_BYTE_SIZE)
+		v1ExtendedBytes = v1ExtendedTagBytes(*this, fileInfo.trailingTags().v1ExtendedTag());
+	const auto updatedV1 = [&](const TrailingTag& trailing) -> const ByteArray& {
+		return trailing.type == TrailingTagType::ID3V1_EXTENDED ? v1ExtendedBytes : v1Bytes;
+	};
 	
 	//Reset the v2 tag info
 	v2TagInfo = TagInfo();
 	v2TagInfo.majorVer = WRITE_VERSION;
 	v2TagInfo.minorVer = SUPPORTED_MINOR_VERSION;
-	v2TagInfo.paddingStart = binaryTagData.size();
-	
-	//If the data is smaller than the file's tag size, then extend it with padding
-	if(!needToRewriteFile) {
-		//Ignore case where tag data size == file tag size
-		if(binaryTagData.size() < fileInfo.v2TagInfo.totalSize) {		
-			ByteArray padding(fileInfo.v2TagInfo.totalSize - binaryTagData.size(), '\0');
-			
-			//This check if just being overly cautious, probably not necessary
-			if(binaryTagData.size() + padding.size() < MAX_TAG_SIZE)
-				binaryTagData.insert(binaryTagData.end(), padding.begin(), padding.end());
-			else
-				needToRewriteFile = true;
-		}
-	} else if(paddingFactor > 0.0) { //Append padding
-		//Get the padding size, then round it up to the next highest multiple of 4096.
-		const ulong factorMult  = binaryTagData.size() + (binaryTagData.size() * paddingFactor),
-		            paddingSize = (factorMult + (4096 - (factorMult % 4096))) - binaryTagData.size();
-		
-		ByteArray padding(paddingSize, '\0');
-		if(binaryTagData.size() + padding.size() < MAX_TAG_SIZE)
-				binaryTagData.insert(binaryTagData.end(), padding.begin(), padding.end());
-	}
-	
-	//Validate the size by throwing a TagSizeException if it's too big
-	if(binaryTagData.size() - HEADER_BYTE_SIZE > MAX_TAG_SIZE)
-		throw TagSizeException("Cannot write tags to file \""+fileLoc+"\", as it exceeds the maximum size of "+std::to_string(MAX_TAG_SIZE)+"!\n");
+	v2TagInfo.paddingStart = TAG_SIZE;
 	
 	//Save the frame size
-	ByteArray sizeBytes = intToByteArray(binaryTagData.size() - HEADER_BYTE_SIZE, 4, true);
+	ByteArray sizeBytes = intToByteArray(TAG_SIZE + paddingSize - HEADER_BYTE_SIZE, 4, true);
 	for(ushort i = 0; i < 4; i++) binaryTagData[i+6] = sizeBytes[i];
-	v2TagInfo.size = binaryTagData.size() - HEADER_BYTE_SIZE;
-	v2TagInfo.totalSize = binaryTagData.size();
-	
-	if(needToRewriteFile) {
+	v2TagInfo.size = TAG_SIZE + paddingSize - HEADER_BYTE_SIZE;
+	v2TagInfo.totalSize = TAG_SIZE + paddingSize;
+	
+	//Chunks and boxes are written from one ByteArray, so the shared frames and
+	//padding are copied into it
+	if((inChunk || inAtom) && options.sharedFrames != nullptr)
+		options.sharedFrames->append(binaryTagData);
+	if(inChunk || inAtom)
+		binaryTagData.resize(v2TagInfo.totalSize, '\0');
+	
+	//Write the Tag's frames, then the shared frames, then the padding
+	const auto writeTag = [&]() {
+		IOThrottle::charge(TAG_SIZE + paddingSize);
+		file.write(reinterpret_cast<char*>(&binaryTagData.front()), binaryTagData.size());
+		if(options.sharedFrames != nullptr) options.sharedFrames->write(file);
+		const ByteArray padding(paddingSize, '\0');
+		if(paddingSize > 0) file.write(reinterpret_cast<const char*>(&padding.front()), paddingSize);
+	};
+	
+	if(inChunk) {
+		//Write the tag to the ID3 chunk
+		v2TagInfo.offset = writeChunk(file, fileInfo, binaryTagData, needToRewriteFile, fileLoc);
+	} else if(inAtom) {
+		//Write the tag to the ID32 box
+		v2TagInfo.offset = writeAtom(file, fileInfo, binaryTagData, fileLoc);
+	} else if(needToRewriteFile) {
 		//Rewrite the file to accomodate the bigger tags/removed ID3v1 tags.
 		            //The start of the audio data in the file
 		const ulong AUDIO_START = fileInfo.tagsSet.v2 ? fileInfo.v2TagInfo.totalSize : 0,
 		            //The end of the audio data in the file
-		            AUDIO_END = fileInfo.filesize -
-		                        (fileInfo.tagsSet.v1 || fileInfo.tagsSet.v1_1 ? V1::BYTE_SIZE : 0) -
-		                        (fileInfo.tagsSet.v1Extended ? V1::EXTENDED_BYTE_SIZE : 0);
+		            AUDIO_END = fileInfo.audioEnd();
 		
 		//This will probably never be true, but you can never be too careful
 		if(AUDIO_END < AUDIO_START)
@@ -246,8 +580,28 @@ void Tag::write(const std::string& fileLoc,
 		//Seek to the audio start and read the audio
 		file.seekg(AUDIO_START, std::ios_base::beg);
 		if(!file) throw WriteException("Cannot write tags to file \""+fileLoc+"\", error seeking on file.");
+		IOThrottle::charge(binaryAudioData.size());
 		file.read(reinterpret_cast<char*>(&binaryAudioData.front()), binaryAudioData.size());
 		
+		//Keep the APE and Lyrics3 tags after the audio, in the order they were
+		//on file. The ID3v1 tags are removed, kept, or updated.
+		const std::vector<TrailingTag>& trailing = fileInfo.trailingTags().tags();
+		for(auto itr = trailing.rbegin(); itr != trailing.rend(); itr++) {
+			const bool v1 = itr->type == TrailingTagType::ID3V1 || itr->type == TrailingTagType::ID3V1_EXTENDED;
+			if(v1 && options.v1Policy == V1Policy::REMOVE) continue;
+			
+			const ulong blockStart = binaryAudioData.size();
+			if(v1 && updatedV1(*itr).size() == itr->size) {
+				binaryAudioData.insert(binaryAudioData.end(), updatedV1(*itr).begin(), updatedV1(*itr).end());
+				continue;
+			}
+			binaryAudioData.resize(blockStart + itr->size);
+			file.seekg(itr->start, std::ios_base::beg);
+			if(!file) throw WriteException("Cannot write tags to file \""+fileLoc+"\", error seeking on file.");
+			IOThrottle::charge(itr->size);
+			file.read(reinterpret_cast<char*>(&binaryAudioData[blockStart]), itr->size);
+		}
+		
 		//Close the file, and re-open it truncated
 		file.close();
 		file.open(fileLoc, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
@@ -255,10 +609,11 @@ void Tag::write(const std::string& fileLoc,
 		
 		//Write the tags
 		file.seekp(0, std::ios_base::beg);
-		file.write(reinterpret_cast<char*>(&binaryTagData.front()), binaryTagData.size());
+		writeTag();
 		
 		//Write the audio
 		file.seekp(0, std::ios_base::end);
+		IOThrottle::charge(binaryAudioData.size());
 		file.write(reinterpret_cast<char*>(&binaryAudioData.front()), binaryAudioData.size());
 	} else {
 		//Overwrite the existing ID3v2 tags
@@ -266,48 +621,153 @@ void Tag::write(const std::string& fileLoc,
 		file.seekp(0, std::ios_base::beg);
 		
 		//Write the tags
-		file.write(reinterpret_cast<char*>(&binaryTagData.front()), binaryTagData.size());
-	}
-	
-	//Now that the write has been successful, remove any null/empty frames
-	foundCoverPicture = false;
-	auto itr = frames.begin();
-	while(itr != frames.end()) {
-		//Delete null and empty Frames
-		if(itr->second.get() == nullptr || itr->second->null() || itr->second->empty()) {
-			itr = frames.erase(itr);
-		} else if(discardNonCoverPictures && dynamic_cast<PictureFrame*>(itr->second.get()) != nullptr) {
-			//Delete non-conforming pictures if discardNonCoverPictures is true
-			if(!foundCoverPicture && dynamic_cast<PictureFrame*>(itr->second.get())->pictureType() == PictureType::FRONT_COVER) {
-				foundCoverPicture = true;
-				itr++;
-			} else {
-				itr = frames.erase(itr);
-			}
-		} else if(discardUnknown && dynamic_cast<UnknownFrame*>(itr->second.get()) != nullptr) {
-			itr = frames.erase(itr); //Delete unknown frames if discardUnknown is true
-		}else {
-			itr++;
+		writeTag();
+		
+		//Overwrite the ID3v1 tags, which haven't moved
+		for(const TrailingTag& trailing : fileInfo.trailingTags().tags()) {
+			if(trailing.type != TrailingTagType::ID3V1 && trailing.type != TrailingTagType::ID3V1_EXTENDED) continue;
+			const ByteArray& updated = updatedV1(trailing);
+			if(updated.size() != trailing.size) continue;
+			file.seekp(trailing.start, std::ios_base::beg);
+			IOThrottle::charge(updated.size());
+			file.write(reinterpret_cast<const char*>(&updated.front()), updated.size());
+			if(!file) throw WriteException("Cannot write tags to file \""+fileLoc+"\", error writing the ID3v1 tags.");
 		}
 	}
 	
+	//Now that the write has been successful, remove any null/empty frames,
+	//and the frames that were discarded
+	eraseFrames([&discardedFrames](const Frame& frame) {
+		return frame.null() || frame.empty() ||
+		       std::binary_search(discardedFrames.begin(), discardedFrames.end(), &frame);
+	});
+	
 	//Close the file
 	file.close();
-	if(setFileNameUponSuccess) filename = fileLoc;
-	tagsSet.v1 = false, tagsSet.v1_1 = false, tagsSet.v1Extended = false;
+	if(options.setFileNameUponSuccess) filename = fileLoc;
+	if(plan.removeV1) {
+		tagsSet.v1 = false, tagsSet.v1_1 = false, tagsSet.v1Extended = false;
+	} else if(!v1Bytes.empty()) {
+		tagsSet.v1_1 = v1Bytes[125] == '\0' && v1Bytes[126] != '\0';
+		tagsSet.v1 = !tagsSet.v1_1;
+	}
+	
+	return result;
+}
+
+///@pkg ID3.h
+ulong Tag::writeChunk(std::fstream&      file,
+                      const Tag&         fileInfo,
+                      const ByteArray&   tagData,
+                      const bool         moveChunk,
+                      const std::string& fileLoc) const {
+	const ChunkIndex& index = fileInfo.chunkIndex;
+	const Chunk* const id3Chunk = index.id3Chunk();
+	
+	//The tag fits in the existing chunk, so overwrite it
+	if(!moveChunk && id3Chunk != nullptr) {
+		file.seekp(id3Chunk->dataStart(), std::ios_base::beg);
+		IOThrottle::charge(tagData.size());
+		file.write(reinterpret_cast<const char*>(&tagData.front()), tagData.size());
+		if(!file) throw WriteException("Cannot write tags to file \""+fileLoc+"\", error writing the ID3 chunk.");
+		return id3Chunk->dataStart();
+	}
+	
+	//Encode a chunk or form size in the file's byte order
+	auto sizeBytes = [&index](const ulong size) -> ByteArray {
+		return index.littleEndian() ? intToLittleEndianByteArray(size, 4) : intToByteArray(size, 4);
+	};
+	
+	            //The end of the form, where the new chunk is added
+	const ulong FORM_END    = index.formEnd(),
+	            //Chunks start on even positions
+	            CHUNK_START = FORM_END + (FORM_END & 1),
+	            //The end of the new chunk, including its pad byte
+	            CHUNK_END   = CHUNK_START + CHUNK_HEADER_BYTE_SIZE + tagData.size() + (tagData.size() & 1);
+	
+	//The form size is a 32-bit integer
+	if(CHUNK_END - CHUNK_HEADER_BYTE_SIZE > 0xFFFFFFFFUL)
+		throw WriteException("Cannot write tags to file \""+fileLoc+"\", the file would be bigger than 4GiB.");
+	
+	//Keep anything after the form, such as ID3v1 tags
+	ByteArray trailingData(fileInfo.filesize > FORM_END ? fileInfo.filesize - FORM_END : 0, '\0');
+	if(!trailingData.empty()) {
+		file.seekg(FORM_END, std::ios_base::beg);
+		IOThrottle::charge(trailingData.size());
+		file.read(reinterpret_cast<char*>(&trailingData.front()), trailingData.size());
+		if(!file) throw WriteException("Cannot write tags to file \""+fileLoc+"\", error reading the end of the file.");
+	}
+	
+	//Build the new chunk
+	ByteArray chunkData;
+	chunkData.reserve(CHUNK_END - FORM_END + trailingData.size());
+	if(CHUNK_START != FORM_END) chunkData.push_back('\0');
+	const char* const chunkID = index.container() == ChunkContainer::RIFF ? "id3 " : "ID3 ";
+	chunkData.insert(chunkData.end(), chunkID, chunkID + 4);
+	const ByteArray chunkSize = sizeBytes(tagData.size());
+	chunkData.insert(chunkData.end(), chunkSize.begin(), chunkSize.end());
+	chunkData.insert(chunkData.end(), tagData.begin(), tagData.end());
+	if(tagData.size() & 1) chunkData.push_back('\0');
+	chunkData.insert(chunkData.end(), trailingData.begin(), trailingData.end());
+	
+	//Write the new chunk
+	file.seekp(FORM_END, std::ios_base::beg);
+	IOThrottle::charge(chunkData.size());
+	file.write(reinterpret_cast<char*>(&chunkData.front()), chunkData.size());
+	
+	//Update the form size
+	const ByteArray formSize = sizeBytes(CHUNK_END - CHUNK_HEADER_BYTE_SIZE);
+	file.seekp(4, std::ios_base::beg);
+	IOThrottle::charge(formSize.size());
+	file.write(reinterpret_cast<const char*>(&formSize.front()), formSize.size());
+	
+	//Turn the old chunk into a chunk that readers ignore. "JUNK" is the RIFF
+	//chunk for unused space. AIFF has no such chunk, but readers have to skip
+	//chunks they don't know, so it gets an ID that no AIFF chunk uses.
+	if(id3Chunk != nullptr) {
+		file.seekp(id3Chunk->start, std::ios_base::beg);
+		IOThrottle::charge(4);
+		file.write(index.container() == ChunkContainer::RIFF ? "JUNK" : "FREE", 4);
+	}
+	
+	if(!file) throw WriteException("Cannot write tags to file \""+fileLoc+"\", error writing the ID3 chunk.");
+	
+	return CHUNK_START + CHUNK_HEADER_BYTE_SIZE;
+}
+
+///@pkg ID3.h
+ulong Tag::writeAtom(std::fstream&      file,
+                     const Tag&         fileInfo,
+                     const ByteArray&   tagData,
+                     const std::string& fileLoc) const {
+	const AtomIndex& index = fileInfo.atomIndex;
+	
+	//The tag has to fill the space exactly so that no other box moves
+	if(tagData.size() != index.id3Space())
+		throw WriteException("Cannot write tags to file \""+fileLoc+"\", the tag does not fit in the ID32 box.");
+	
+	//Write the box header(s), then the tag
+	const ByteArray boxHeader = index.tagBoxHeader(tagData.size());
+	const ulong TAG_START = index.tagWriteStart();
+	
+	file.seekp(index.tagBoxStart(), std::ios_base::beg);
+	IOThrottle::charge(boxHeader.size());
+	file.write(reinterpret_cast<const char*>(&boxHeader.front()), boxHeader.size());
+	file.seekp(TAG_START, std::ios_base::beg);
+	IOThrottle::charge(tagData.size());
+	file.write(reinterpret_cast<const char*>(&tagData.front()), tagData.size());
+	if(!file) throw WriteException("Cannot write tags to file \""+fileLoc+"\", error writing the ID32 box.");
+	
+	return TAG_START;
 }
 
 ///@pkg ID3.h
 void Tag::revert() {
 	//Loop through every Frame and revert it
-	auto itr = frames.begin();
-	while(itr != frames.end()) {
-		if(itr->second.get() == nullptr) { itr = frames.erase(itr); continue; }
-		itr->second->revert();
-		//If the Frame is null or empty then remove it
-		if(itr->second->null() || itr->second->empty()) itr = frames.erase(itr);
-		else                                            itr++;
-	}
+	for(const auto& framePair : frames)
+		if(framePair.second.get() != nullptr) framePair.second->revert();
+	//If the Frame is null or empty then remove it
+	eraseFrames([](const Frame& frame) { return frame.null() || frame.empty(); });
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -317,7 +777,7 @@ void Tag::revert() {
 ////////////////////////////////////////////////////////////////////////////////
 
 ///@pkg ID3.h
-bool Tag::exists(const FrameID& frameName) const { return frames.count(frameName) > 0; }
+bool Tag::exists(const FrameID& frameName) const { return frames.find(frameName) != frames.end(); }
 
 ///@pkg ID3.h
 std::string Tag::textString(const FrameID& frameName) const {
@@ -328,6 +788,13 @@ std::string Tag::textString(const FrameID& frameName) const {
 	return textFrameObj == nullptr ? "" : textFrameObj->content();
 }
 
+///@pkg ID3.h
+const std::string& Tag::textReference(const FrameID& frameName) const {
+	static const std::string EMPTY;
+	const TextFrame* const textFrameObj = getFrame<TextFrame>(frameName);
+	return textFrameObj == nullptr ? EMPTY : textFrameObj->content();
+}
+
 ///@pkg ID3.h
 std::vector<std::string> Tag::textStrings(const FrameID& frameName) const {
 	if(frameName.allowsMultiple()) {
@@ -579,8 +1046,14 @@ std::string Tag::genre(bool process) const {
 ///@pkg ID3.h
 std::vector<std::string> Tag::genres(bool process) const {
 	std::vector<std::string> genreStrings = textStrings(Frames::FRAME_GENRE);
-	if(process) for(std::string& genre : genreStrings) genre = processGenre(genre);
-	return genreStrings;
+	if(!process) return genreStrings;
+	
+	std::vector<std::string> processed;
+	for(const std::string& genre : genreStrings) {
+		const std::vector<std::string> parsed = parseGenres(genre);
+		processed.insert(processed.end(), parsed.begin(), parsed.end());
+	}
+	return processed;
 }
 ///@pkg ID3.h
 void Tag::genre(const ushort newGenre) { text(FRAME_GENRE, V1::getGenreString(newGenre)); }
@@ -593,10 +1066,11 @@ void Tag::year(const std::string& newYear) {
 	if(!yearString.empty() && numericalString(yearString)) {
 		//Prepend zeros to make it four characters long
 		while(yearString.size() < YEAR_LENGTH) yearString = '0' + yearString;
-		const std::string tdrc = textString(FRAME_RECORDING_TIME);
 		//If there is more to the TDRC than the year, preserve it
-		if(tdrc.size() > YEAR_LENGTH) text(FRAME_RECORDING_TIME, yearString+tdrc.substr(YEAR_LENGTH+1));
-		else                          text(FRAME_RECORDING_TIME, yearString);
+		Timestamp recordingTime = timestamp(FRAME_RECORDING_TIME);
+		recordingTime.year = std::stoi(yearString);
+		if(recordingTime.empty()) recordingTime.precision = TimestampPrecision::YEAR;
+		timestamp(FRAME_RECORDING_TIME, recordingTime);
 	} else {
 		yearString = "";
 		text(FRAME_RECORDING_TIME, yearString);
@@ -604,52 +1078,86 @@ void Tag::year(const std::string& newYear) {
 	text(FRAME_YEAR, yearString);
 }
 
+///@pkg ID3.h
+Timestamp Tag::timestamp(const FrameID& frameName) const { return Timestamp::parse(textReference(frameName)); }
+
+///@pkg ID3.h
+void Tag::timestamp(const FrameID& frameName, const Timestamp& newTimestamp) {
+	char buffer[Timestamp::MAX_LENGTH];
+	text(frameName, std::string(buffer, newTimestamp.format(buffer)));
+}
+
 ///@pkg ID3.h
 std::string Tag::track() const {
-	std::string trackString = textString(Frames::FRAME_TRACK);
+	const std::string& trackString = textReference(Frames::FRAME_TRACK);
 	return trackString.substr(0, trackString.find_first_of('/'));
 }
 ///@pkg ID3.h
 std::string Tag::trackTotal() const {
-	std::string trackString = textString(Frames::FRAME_TRACK);
+	const std::string& trackString = textReference(Frames::FRAME_TRACK);
 	size_t slashPos = trackString.find_first_of('/');
 	return slashPos == std::string::npos ? "" : trackString.substr(slashPos + 1);
 }
 ///@pkg ID3.h
 void Tag::track(const std::string& newTrack) {
-	std::string	trackString = numericalString(newTrack) ? newTrack : "",
-	            total       = trackTotal();
-	text(FRAME_TRACK, total.empty() ? trackString : trackString + '/' + total);
+	numberPairField(FRAME_TRACK, numericalString(newTrack) ? newTrack : "", false);
 }
 ///@pkg ID3.h
 void Tag::trackTotal(const std::string& newTrackTotal) {
-	std::string	trackString = numericalString(newTrackTotal) ? newTrackTotal : "";
-	if(trackString.empty()) text(FRAME_TRACK, track());
-	else                    text(FRAME_TRACK, track() + '/' + trackString);
+	numberPairField(FRAME_TRACK, numericalString(newTrackTotal) ? newTrackTotal : "", true);
 }
 
 ///@pkg ID3.h
 std::string Tag::disc() const {
-	std::string discString = textString(Frames::FRAME_DISC);
+	const std::string& discString = textReference(Frames::FRAME_DISC);
 	return discString.substr(0, discString.find_first_of('/'));
 }
 ///@pkg ID3.h
 std::string Tag::discTotal() const {
-	std::string discString = textString(Frames::FRAME_DISC);
+	const std::string& discString = textReference(Frames::FRAME_DISC);
 	size_t slashPos = discString.find_first_of('/');
 	return slashPos == std::string::npos ? "" : discString.substr(slashPos + 1);
 }
 ///@pkg ID3.h
 void Tag::disc(const std::string& newDisc) {
-	std::string	discString = numericalString(newDisc) ? newDisc : "",
-	            total      = discTotal();
-	text(FRAME_DISC, total.empty() ? discString : discString + '/' + total);
+	numberPairField(FRAME_DISC, numericalString(newDisc) ? newDisc : "", false);
 }
 ///@pkg ID3.h
 void Tag::discTotal(const std::string& newDiscTotal) {
-	std::string	discString = numericalString(newDiscTotal) ? newDiscTotal : "";
-	if(discString.empty()) text(FRAME_DISC, disc());
-	else                   text(FRAME_DISC, disc() + '/' + discString);
+	numberPairField(FRAME_DISC, numericalString(newDiscTotal) ? newDiscTotal : "", true);
+}
+
+///@pkg ID3.h
+void Tag::numberPair(const FrameID& frameName, const NumberPair& numbers) {
+	//"number/total", with either left out if it's 0
+	char buffer[41];
+	size_t length = numbers.number > 0 ? formatNumber(buffer, numbers.number) : 0;
+	if(numbers.total > 0) {
+		buffer[length++] = '/';
+		length += formatNumber(buffer + length, numbers.total);
+	}
+	text(frameName, std::string(buffer, length));
+}
+
+///@pkg ID3.h
+void Tag::numberPairField(const FrameID& frameName, const std::string& field, const bool total) {
+	//Splice the new field into "number/total", leaving out the slash if
+	//there's no total
+	const std::string& current = textReference(frameName);
+	const size_t SLASH_POS = current.find_first_of('/');
+	const size_t NUMBER_LENGTH = SLASH_POS == std::string::npos ? current.size() : SLASH_POS;
+	const size_t TOTAL_LENGTH = SLASH_POS == std::string::npos ? 0 : current.size() - SLASH_POS - 1;
+	std::string newText;
+	if(total) {
+		newText.reserve(NUMBER_LENGTH + 1 + field.size());
+		newText.append(current, 0, NUMBER_LENGTH);
+		if(!field.empty()) newText.append(1, '/').append(field);
+	} else {
+		newText.reserve(field.size() + 1 + TOTAL_LENGTH);
+		newText.append(field);
+		if(TOTAL_LENGTH > 0) newText.append(current, SLASH_POS, std::string::npos);
+	}
+	text(frameName, newText);
 }
 
 ///@pkg ID3.h
@@ -681,6 +1189,56 @@ std::vector<Picture> Tag::pictures() const {
 	return toReturn; //Return the Picture vector
 }
 ///@pkg ID3.h
+std::vector<PictureInfo> Tag::pictureInfo() const {
+	std::vector<PictureFrame*> frames = getFrames<PictureFrame>(Frames::FRAME_PICTURE);
+	
+	std::vector<PictureInfo> toReturn;
+	toReturn.reserve(frames.size());
+	
+	for(PictureFrame* currentFrame : frames) {
+		PictureInfo info;
+		info.MIME        = currentFrame->mimeType();
+		info.type        = currentFrame->pictureType();
+		info.description = currentFrame->description();
+		info.bytes       = currentFrame->pictureSize();
+		info.image       = currentFrame->imageInfo();
+		toReturn.push_back(info);
+	}
+	
+	return toReturn;
+}
+///@pkg ID3.h
+Picture Tag::bestPicture(const PictureType type) const {
+	std::vector<PictureFrame*> frames = getFrames<PictureFrame>(Frames::FRAME_PICTURE);
+	
+	PictureFrame* best = nullptr;
+	ImageInfo bestImage;
+	for(PictureFrame* currentFrame : frames) {
+		const ImageInfo image = currentFrame->imageInfo();
+		if(best != nullptr) {
+			//Compare each rule in order, and only move on when they're equal
+			const bool known = image.format != ImageFormat::UNKNOWN,
+			           bestKnown = bestImage.format != ImageFormat::UNKNOWN;
+			if(known != bestKnown) {
+				if(!known) continue;
+			} else if((currentFrame->pictureType() == type) != (best->pictureType() == type)) {
+				if(currentFrame->pictureType() != type) continue;
+			} else if(image.pixels() != bestImage.pixels()) {
+				if(image.pixels() < bestImage.pixels()) continue;
+			} else if(currentFrame->pictureSize() >= best->pictureSize()) {
+				continue;
+			}
+		}
+		best = currentFrame;
+		bestImage = image;
+	}
+	
+	return best == nullptr ? Picture() : Picture(best->picture(),
+	                                             best->mimeType(),
+	                                             best->description(),
+	                                             best->pictureType());
+}
+///@pkg ID3.h
 Picture Tag::picture(const std::function<bool (const std::string&, const PictureType)>& filterFunc) const {
 	//Get the vector of PictureFrames in the Frame map.
 	std::vector<PictureFrame*> frames = getFrames<PictureFrame>(Frames::FRAME_PICTURE);
@@ -871,12 +1429,42 @@ std::string Tag::getVersionString(bool verbose) const {
 ///@pkg ID3.h
 size_t Tag::size() const { return frames.size(); }
 
+///@pkg ID3.h
+ulong Tag::memoryUsage() const {
+	ulong bytes = sizeof(Tag) + filename.capacity();
+	//Each frame has its bytes, a parsed copy of its content, and the frame
+	//object and map node around them
+	for(const auto& framePair : frames)
+		if(framePair.second) bytes += 128 + 2 * framePair.second->size(true);
+	return bytes;
+}
+
+///@pkg ID3.h
+size_t Tag::visitFrames(const std::function<bool (const FrameView&)>& visitor, const FrameFilter& filter) const {
+	size_t visited = 0;
+	for(const Frame* const frame : frameOrder) {
+		if(frame == nullptr || frame->null() || frame->empty() || !filter.matches(*frame)) continue;
+		visited++;
+		if(!visitor(FrameView(*frame))) break;
+	}
+	return visited;
+}
+
 ///@pkg ID3.h
 std::string Tag::fileName() const { return filename; }
 
 ///@pkg ID3.h
 ulong Tag::fileSize() const { return filesize; }
 
+///@pkg ID3.h
+const TrailingTags& Tag::trailingTags() const { return trailingTagInfo; }
+
+///@pkg ID3.h
+ulong Tag::audioStart() const { return tagsSet.v2 && v2TagInfo.offset == 0 ? v2TagInfo.totalSize : 0; }
+
+///@pkg ID3.h
+ulong Tag::audioEnd() const { return trailingTagInfo.audioEnd(); }
+
 ///@pkg ID3.h
 void Tag::print(std::ostream& out) const {
 	out << "\n......................\n";
@@ -899,23 +1487,76 @@ void Tag::print() const { print(std::cout); }
 ///@pkg ID3.h
 bool Tag::addFrame(const FrameID& frameName, FramePtr frame) {
 	//Check if the Frame is valid
-	if((exists(frameName) && !frameName.allowsMultiple()) ||
+	if((!frameName.allowsMultiple() && exists(frameName)) ||
 	   frame.get() == nullptr || frame->null() || frame->empty())
 		return false;
 	frames.emplace(frameName, frame);
+	if(!framePositions.empty()) framePositions.emplace(frame.get(), frameOrder.size());
+	frameOrder.push_back(frame.get());
 	return true;
 }
 
 ///@pkg ID3.h
 bool Tag::addFrame(const FramePair& frameMapPair) {
 	//Check if the Frame is valid
-	if((exists(frameMapPair.first) && !FrameID(frameMapPair.first).allowsMultiple()) ||
+	if((!frameMapPair.first.allowsMultiple() && exists(frameMapPair.first)) ||
 	   frameMapPair.second.get() == nullptr || frameMapPair.second->null() || frameMapPair.second->empty())
 		return false;
 	frames.emplace(frameMapPair);
+	if(!framePositions.empty()) framePositions.emplace(frameMapPair.second.get(), frameOrder.size());
+	frameOrder.push_back(frameMapPair.second.get());
 	return true;
 }
 
+///@pkg ID3.h
+void Tag::eraseFrame(const FrameMap::const_iterator frame) {
+	//Find the frame's position, indexing every frame on the first erase
+	if(framePositions.empty()) {
+		framePositions.reserve(frameOrder.size());
+		for(size_t i = 0; i < frameOrder.size(); i++)
+			if(frameOrder[i] != nullptr) framePositions.emplace(frameOrder[i], i);
+	}
+	const auto position = framePositions.find(frame->second.get());
+	if(position != framePositions.end()) {
+		frameOrder[position->second] = nullptr;
+		framePositions.erase(position);
+	}
+	frames.erase(frame);
+	
+	//Remove the erased positions once they're most of the frame order
+	if(frameOrder.size() > 2 * frames.size()) {
+		frameOrder.erase(std::remove(frameOrder.begin(), frameOrder.end(), nullptr), frameOrder.end());
+		framePositions.clear();
+	}
+}
+
+///@pkg ID3.h
+void Tag::eraseFrames(const std::function<bool (const Frame&)>& predicate) {
+	//Take the frames out of the frame order first, since erasing them from
+	//the map can delete them
+	std::vector<const Frame*> erased;
+	frameOrder.erase(std::remove_if(frameOrder.begin(), frameOrder.end(), [&predicate, &erased](const Frame* const frame) {
+		if(frame == nullptr) return true;
+		if(!predicate(*frame)) return false;
+		erased.push_back(frame);
+		return true;
+	}), frameOrder.end());
+	framePositions.clear();
+	if(erased.empty()) return;
+	
+	//Erasing a frame from the map walks the frames before it with the same
+	//ID, so the map is rebuilt from the frames that are kept instead. Frames
+	//with the same ID are inserted after each other to keep their order.
+	std::sort(erased.begin(), erased.end());
+	FrameMap keptFrames;
+	keptFrames.reserve(frames.size() - erased.size());
+	FrameMap::iterator hint = keptFrames.end();
+	for(const auto& framePair : frames)
+		if(framePair.second.get() != nullptr && !std::binary_search(erased.begin(), erased.end(), framePair.second.get()))
+			hint = keptFrames.emplace_hint(hint, framePair);
+	frames.swap(keptFrames);
+}
+
 ///@pkg ID3.h
 template<typename DerivedFrame>
 DerivedFrame* Tag::getFrame(const FrameID& frameName) const {
@@ -948,7 +1589,7 @@ DerivedFrame* Tag::getFrame(const FrameID& frameName, const bool mismatchDelete)
 	
 	//If the frame is "null" then return nullptr
 	if(result->second->null()) {
-		if(mismatchDelete) frames.erase(result);
+		if(mismatchDelete) eraseFrame(result);
 		return nullptr;
 	}
 	
@@ -958,7 +1599,7 @@ DerivedFrame* Tag::getFrame(const FrameID& frameName, const bool mismatchDelete)
 	//If mismatchDelete, then check if it's an UnknownFrame, and if so erase it
 	if(mismatchDelete && derivedFrameObj == nullptr) {
 		UnknownFrame* unknownFrameObj = dynamic_cast<UnknownFrame*>(result->second.get());
-		if(unknownFrameObj != nullptr) frames.erase(result);
+		if(unknownFrameObj != nullptr) eraseFrame(result);
 	}
 	
 	//If the Frame is not a DerivedFrame then nullptr will be returned
@@ -1013,56 +1654,81 @@ Text Tag::getTextStruct(const Frame* const frame) const {
 }
 
 ///@pkg ID3.h
-void Tag::readFile(std::istream& file, const bool readFrames) {
-	if(file) {
-		file.seekg(0, std::ifstream::end);
-		filesize = file.tellg(); //Get the filesize
-		readFileV2(file, readFrames);
+void Tag::readFile(const std::shared_ptr<const ByteSource>& source, const bool readFrames) {
+	ByteSourceStream file(source);
+	if(source != nullptr) {
+		filesize = source->size(); //Get the filesize
+		
+		//WAV and AIFF files keep the ID3v2 tag in a chunk instead of at the
+		//start of the file
+		chunkIndex = ChunkIndex(file, filesize);
+		const Chunk* id3Chunk = chunkIndex.id3Chunk();
+		if(id3Chunk != nullptr) {
+			readFileV2(file, readFrames, id3Chunk->dataStart(), id3Chunk->dataStart() + id3Chunk->size);
+		} else if(chunkIndex.container() == ChunkContainer::NONE) {
+			//MP4 files keep the ID3v2 tag in an ID32 box
+			atomIndex = AtomIndex(file, filesize);
+			if(atomIndex.id32Atom() != nullptr)
+				readFileV2(file, readFrames, atomIndex.id3Start(), atomIndex.id32Atom()->end());
+			else if(!atomIndex.mp4())
+				readFileV2(file, readFrames);
+		}
+		
 		readFileV1(file, readFrames);
+		
+		//The frames have been read, so the source can be released
+		factory.source.reset();
 	}
 }
 
 ///@pkg ID3.h
 void Tag::readFileV1(std::istream& file, const bool readFrames) {
-	if(filesize < V1::BYTE_SIZE) return;
+	//Find every tag after the audio data with one read from the end of the
+	//file. The ID3v2 tag, or the RIFF/AIFF form, marks the lower bound of
+	//the search.
+	trailingTagInfo = TrailingTags(file, filesize, chunkIndex.container() != ChunkContainer::NONE ? chunkIndex.formEnd() : audioStart());
+	
+	const ByteArray& v1Bytes = trailingTagInfo.v1Tag();
+	const ByteArray& extBytes = trailingTagInfo.v1ExtendedTag();
+	if(v1Bytes.size() != V1::BYTE_SIZE) return;
 	
 	try {
 		V1::Tag tags;
 		V1::ExtendedTag extTags;
-		bool extTagsSet = false;
-		
-		file.seekg(-V1::BYTE_SIZE, std::ifstream::end);
-		if(file.fail()) return;
+		const bool extTagsSet = extBytes.size() == V1::EXTENDED_BYTE_SIZE;
 		
-		file.read(reinterpret_cast<char*>(&tags), V1::BYTE_SIZE);
+		std::memcpy(&tags, &v1Bytes.front(), V1::BYTE_SIZE);
+		if(extTagsSet) std::memcpy(&extTags, &extBytes.front(), V1::EXTENDED_BYTE_SIZE);
 		
-		if(memcmp(tags.header, "TAG", 3) != 0) return;
-		
-		//Get the bytes for the extended tags
-		if(filesize > V1::BYTE_SIZE + V1::EXTENDED_BYTE_SIZE) {
-			file.seekg(-V1::BYTE_SIZE-V1::EXTENDED_BYTE_SIZE, std::ifstream::end);
-			extTagsSet = static_cast<bool>(file); //extTagsSet will be true only if the file is valid
-			if(extTagsSet) {
-				file.read(reinterpret_cast<char*>(&extTags), V1::EXTENDED_BYTE_SIZE);
-				extTagsSet = memcmp(extTags.header, "TAG+", 4) == 0;
-			}
+		if(!readFrames) {
+			//Record the ID3v1 versions on file without reading their fields.
+			//This uses the same check as ID3::Tag::setTags(V1::Tag&, bool).
+			tagsSet.v1_1 = tags.comment[28] == '\0' && tags.comment[29] != '\0';
+			tagsSet.v1 = !tagsSet.v1_1;
+			tagsSet.v1Extended = extTagsSet;
+			return;
 		}
-		
-		if(!readFrames) return;
-		if(extTagsSet) setTags(extTags);
+		if(extTagsSet) setTags(extTags, tags);
 		setTags(tags);
 	} catch(const std::exception& e) {}
 }
 
 ///@pkg ID3.h
-void Tag::readFileV2(std::istream& file, const bool readFrames) {
+void Tag::readFileV2(ByteSourceStream& file,
+                     const bool        readFrames,
+                     const ulong       tagStart,
+                     const ulong       tagLimit) {
 	Header tagsHeader;
 	
-	if(filesize < HEADER_BYTE_SIZE) return;
+	//The position the tag has to end by
+	const ulong TAG_LIMIT = tagLimit == 0 || tagLimit > filesize ? filesize : tagLimit;
 	
-	file.seekg(0, std::ifstream::beg);
+	if(tagStart + HEADER_BYTE_SIZE > TAG_LIMIT) return;
+	
+	file.seekg(tagStart, std::ifstream::beg);
 	if(!file) return;
 	
+	IOThrottle::charge(HEADER_BYTE_SIZE);
 	file.read(reinterpret_cast<char*>(&tagsHeader), HEADER_BYTE_SIZE);
 	if(memcmp(tagsHeader.header, "ID3", 3) != 0) return;
 	
@@ -1081,9 +1747,12 @@ void Tag::readFileV2(std::istream& file, const bool readFrames) {
 	v2TagInfo.minorVer = tagsHeader.minorVer;
 	v2TagInfo.size = byteIntVal(tagsHeader.size, 4, true);
 	v2TagInfo.totalSize = HEADER_BYTE_SIZE + v2TagInfo.size + (v2TagInfo.flagFooter ? HEADER_BYTE_SIZE : 0);
+	v2TagInfo.offset = tagStart;
 	
 	//The position to start reading from the file
-	ulong frameStartPos = HEADER_BYTE_SIZE;
+	ulong frameStartPos = tagStart + HEADER_BYTE_SIZE;
+	//The position the tag ends on
+	const ulong TAG_END = tagStart + v2TagInfo.totalSize;
 	
 	//Make sure the ID3v2 version is supported and that unsynchronisation
 	//isn't set on ID3v2.3 and below.
@@ -1095,8 +1764,9 @@ void Tag::readFileV2(std::istream& file, const bool readFrames) {
 		return;
 	
 	//Make sure that the size is valid, or throw a FormatExcetion
-	if(v2TagInfo.totalSize > filesize)
-		throw FileFormatException("Tag size format error on file \"" + filename + "\" when reading tags: tags are bigger than the file size!");
+	if(TAG_END > TAG_LIMIT)
+		throw FileFormatException("Tag size format error on file \"" + filename + "\" when reading tags: tags are bigger than the " +
+		                          (tagLimit == 0 ? "file size!" : "box or chunk that holds them!"));
 	
 	//Skip over the extended header
 	if(v2TagInfo.flagExtHeader) {
@@ -1109,9 +1779,10 @@ void Tag::readFileV2(std::istream& file, const bool readFrames) {
 			V4ExtHeader extHeader;
 			
 			//Verify that there's enough space
-			if(frameStartPos + sizeof(V4ExtHeader) > filesize) return;
+			if(frameStartPos + sizeof(V4ExtHeader) > TAG_END) return;
 			
 			//Get the extended header
+			IOThrottle::charge(sizeof(V4ExtHeader));
 			file.read(reinterpret_cast<char*>(&extHeader), sizeof(V4ExtHeader));
 			
 			//Increment the start position. The extended header size is synchsafe in ID3v2.4
@@ -1121,9 +1792,10 @@ void Tag::readFileV2(std::istream& file, const bool readFrames) {
 			V3ExtHeader extHeader;
 			
 			//Verify that there's enough space
-			if(frameStartPos + sizeof(V3ExtHeader) > filesize) return;
+			if(frameStartPos + sizeof(V3ExtHeader) > TAG_END) return;
 			
 			//Get the extended header
+			IOThrottle::charge(sizeof(V3ExtHeader));
 			file.read(reinterpret_cast<char*>(&extHeader), sizeof(V3ExtHeader));
 			
 			//Increment the start position. The extended header size is not synchsafe in ID3v2.3
@@ -1141,13 +1813,17 @@ void Tag::readFileV2(std::istream& file, const bool readFrames) {
 	tagsSet.v2 = true;
 	
 	//Initialize the Tag's FrameFactory properly
-	factory = FrameFactory(file, v2TagInfo.majorVer, v2TagInfo.totalSize);
+	factory = FrameFactory(file.source(), v2TagInfo.majorVer, TAG_END);
 	
 	if(!readFrames) return; //If readFrames is false, stop now
 	
+	//Reserve the frame order for up to 64 frames, which most tags have fewer
+	//than, so it isn't grown one step at a time while reading
+	frameOrder.reserve(std::min<ulong>((TAG_END - frameStartPos) / (HEADER_BYTE_SIZE + 1), 64));
+	
 	//Loop over the ID3 tags, and stop once all ID3 frames have been
 	//reached or a frame is null. Add every frame to the frames map.
-	while(frameStartPos + HEADER_BYTE_SIZE < v2TagInfo.totalSize) {
+	while(frameStartPos + HEADER_BYTE_SIZE < TAG_END) {
 		//Create a new Frame at this position
 		FramePtr frame = factory.create(frameStartPos);
 		//Add the Frame to the map if it's not null
@@ -1155,7 +1831,9 @@ void Tag::readFileV2(std::istream& file, const bool readFrames) {
 		//If the frame content is a valid size (bigger than an ID3v2 header)
 		//then continue on to the next frame. If not, then stop the loop.
 		if(frame->size(true) > HEADER_BYTE_SIZE && !frame->frame().unknown()) {
-			frameStartPos += frame->size(true);
+			//Use the size on file, since unsynchronised frames are shorter once
+			//they're read
+			frameStartPos += HEADER_BYTE_SIZE + frame->header().bodySize;
 			
 			//Account for 4 bytes added when reading ID3v2.2 frames from the
 			//ID3::FrameFactory class
@@ -1163,7 +1841,7 @@ void Tag::readFileV2(std::istream& file, const bool readFrames) {
 		}
 		else {
 			//Get the start of padding and exit the loop
-			v2TagInfo.paddingStart = frameStartPos;
+			v2TagInfo.paddingStart = frameStartPos - tagStart;
 			break;
 		}
 	}
@@ -1227,15 +1905,22 @@ void Tag::setTags(const V1::P1Tag& tags, bool zeroCheck) {
 }
 
 ///@pkg ID3.h
-void Tag::setTags(const V1::ExtendedTag& tags) {
+void Tag::setTags(const V1::ExtendedTag& tags, const V1::Tag& v1Tags) {
+	//Join an Extended field to the v1 field it continues, if that one is full
+	const auto joined = [](const char* v1Field, const char* extField) {
+		const std::string extString = terminatedstring(extField, 60);
+		const std::string v1String = terminatedstring(v1Field, 30);
+		return !extString.empty() && v1String.size() == 30 ? v1String + extString : extString;
+	};
+	
 	//Save the V1 Extended tags as Frame objects.
 	//Since I'm using ID3::Tag::addFrame(), these will not overwrite any V2 tags.
 	try {
 		tagsSet.v1Extended = true;
 		
-		addFrame(factory.createPair(Frames::FRAME_TITLE,  terminatedstring(tags.title, 60)));
-		addFrame(factory.createPair(Frames::FRAME_ARTIST, terminatedstring(tags.artist, 60)));
-		addFrame(factory.createPair(Frames::FRAME_ALBUM,  terminatedstring(tags.album, 60)));
+		addFrame(factory.createPair(Frames::FRAME_TITLE,  joined(v1Tags.title, tags.title)));
+		addFrame(factory.createPair(Frames::FRAME_ARTIST, joined(v1Tags.artist, tags.artist)));
+		addFrame(factory.createPair(Frames::FRAME_ALBUM,  joined(v1Tags.album, tags.album)));
 		addFrame(factory.createPair(Frames::FRAME_GENRE,  terminatedstring(tags.genre, 30)));
 		
 		//Set the start and end times
@@ -1259,4 +1944,5 @@ Tag::TagInfo::TagInfo() : majorVer(WRITE_VERSION),
                           flagFooter(false),
                           size(0),
                           totalSize(0),
-                          paddingStart(0) {}
+                          paddingStart(0),
+                          offset(0) {}
@@ -0,0 +1,194 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm> //For std::max()
+
+#include <sys/stat.h> //For stat()
+
+#include "ID3TagCache.hpp"  //For the class definitions
+#include "ID3Exception.hpp" //For FileNotFoundException and NotMP3FileException
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The memory a cache entry takes up other than its Tag: the list node, the
+	 * index node, and the shared pointer's control block.
+	 */
+	static const ulong ENTRY_OVERHEAD = 160;
+}
+
+///@pkg ID3TagCache.h
+TagCacheOptions::TagCacheOptions() : maxBytes(64 * 1024 * 1024),
+                                     shards(16),
+                                     cacheNegative(true) {}
+
+///@pkg ID3TagCache.h
+TagCacheStats::TagCacheStats() : hits(0),
+                                 negativeHits(0),
+                                 misses(0),
+                                 evictions(0),
+                                 entries(0),
+                                 bytes(0) {}
+
+///@pkg ID3TagCache.h
+double TagCacheStats::hitRate() const {
+	const ulong LOOKUPS = hits + negativeHits + misses;
+	return LOOKUPS > 0 ? static_cast<double>(hits + negativeHits) / LOOKUPS : 0.0;
+}
+
+///@pkg ID3TagCache.h
+void TagCacheStats::print(std::ostream& os) const {
+	os << "Lookups: " << hits << " hits, " << negativeHits << " negative hits, " << misses << " misses" << std::endl
+	   << "Hit rate: " << hitRate() << std::endl
+	   << "Cache: " << entries << " entries, " << bytes << " bytes, " << evictions << " evictions" << std::endl;
+}
+
+///@pkg ID3TagCache.h
+bool TagCache::Key::operator==(const Key& other) const {
+	return device == other.device && inode == other.inode && mtime == other.mtime && size == other.size;
+}
+
+///@pkg ID3TagCache.h
+size_t TagCache::KeyHash::operator()(const Key& key) const {
+	//Mix the fields so that files in the same directory, which often have
+	//consecutive inodes, spread over the shards
+	uint64_t hash = key.inode * 0x9E3779B97F4A7C15ULL;
+	hash ^= key.device + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+	hash ^= static_cast<uint64_t>(key.mtime) + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+	hash ^= key.size + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+	return hash ^ (hash >> 32);
+}
+
+///@pkg ID3TagCache.h
+TagCache::Shard::Shard() : bytes(0), hits(0), negativeHits(0), misses(0), evictions(0) {}
+
+///@pkg ID3TagCache.h
+TagCache::TagCache(const TagCacheOptions& options) : cacheOptions(options),
+                                                     shardBytes(options.maxBytes / std::max(options.shards, 1U)) {
+	for(unsigned i = 0; i < std::max(options.shards, 1U); i++)
+		shards.emplace_back(new Shard());
+}
+
+///@pkg ID3TagCache.h
+std::shared_ptr<const Tag> TagCache::get(const std::string& fileLoc) {
+	Key key;
+	if(!fileKey(fileLoc, key))
+		throw FileNotFoundException("File \"" + fileLoc + "\" cannot be opened!\n");
+	Shard& shard = shardOf(key);
+	
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		auto found = shard.index.find(key);
+		if(found != shard.index.end()) {
+			//Move the entry to the front of the list
+			shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+			if(found->second->tag != nullptr) shard.hits++;
+			else                              shard.negativeHits++;
+			return found->second->tag;
+		}
+		shard.misses++;
+	}
+	
+	//Read the file without holding the lock, so other files in the shard can
+	//still be looked up
+	std::shared_ptr<const Tag> tag;
+	try {
+		std::shared_ptr<const Tag> read = std::make_shared<const Tag>(fileLoc);
+		if(*read) tag = std::move(read);
+	} catch(const NotMP3FileException&) {}
+	if(tag == nullptr && !cacheOptions.cacheNegative) return tag;
+	
+	//Don't cache the Tag if it's too big, or the file changed while it was
+	//being read
+	const ulong BYTES = ENTRY_OVERHEAD + (tag != nullptr ? tag->memoryUsage() : 0);
+	Key readKey;
+	if(BYTES > shardBytes || !fileKey(fileLoc, readKey) || !(readKey == key)) return tag;
+	
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	//Another thread may have read the file at the same time
+	auto found = shard.index.find(key);
+	if(found != shard.index.end()) {
+		shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+		return found->second->tag;
+	}
+	shard.entries.push_front(Entry{key, tag, BYTES});
+	shard.index.emplace(key, shard.entries.begin());
+	shard.bytes += BYTES;
+	
+	//Evict the least recently used entries until the shard fits
+	while(shard.bytes > shardBytes) {
+		const Entry& last = shard.entries.back();
+		shard.bytes -= last.bytes;
+		shard.index.erase(last.key);
+		shard.entries.pop_back();
+		shard.evictions++;
+	}
+	return tag;
+}
+
+///@pkg ID3TagCache.h
+void TagCache::erase(const std::string& fileLoc) {
+	Key key;
+	if(!fileKey(fileLoc, key)) return;
+	Shard& shard = shardOf(key);
+	
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	auto found = shard.index.find(key);
+	if(found == shard.index.end()) return;
+	shard.bytes -= found->second->bytes;
+	shard.entries.erase(found->second);
+	shard.index.erase(found);
+}
+
+///@pkg ID3TagCache.h
+void TagCache::clear() {
+	for(const std::unique_ptr<Shard>& shard : shards) {
+		std::lock_guard<std::mutex> lock(shard->mutex);
+		shard->entries.clear();
+		shard->index.clear();
+		shard->bytes = 0;
+	}
+}
+
+///@pkg ID3TagCache.h
+TagCacheStats TagCache::stats() const {
+	TagCacheStats stats;
+	for(const std::unique_ptr<Shard>& shard : shards) {
+		std::lock_guard<std::mutex> lock(shard->mutex);
+		stats.hits += shard->hits;
+		stats.negativeHits += shard->negativeHits;
+		stats.misses += shard->misses;
+		stats.evictions += shard->evictions;
+		stats.entries += shard->entries.size();
+		stats.bytes += shard->bytes;
+	}
+	return stats;
+}
+
+///@pkg ID3TagCache.h
+bool TagCache::fileKey(const std::string& fileLoc, Key& key) {
+	struct stat fileStat;
+	if(stat(fileLoc.c_str(), &fileStat) != 0) return false;
+	key.device = fileStat.st_dev;
+	key.inode = fileStat.st_ino;
+	key.mtime = static_cast<int64_t>(fileStat.st_mtim.tv_sec) * 1000000000 + fileStat.st_mtim.tv_nsec;
+	key.size = fileStat.st_size;
+	return true;
+}
+
+///@pkg ID3TagCache.h
+TagCache::Shard& TagCache::shardOf(const Key& key) const {
+	//Use the high bits, since the low bits pick the index bucket
+	return *shards[(KeyHash()(key) >> 16) % shards.size()];
+}
@@ -0,0 +1,202 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_TAG_CACHE_HPP
+#define ID3_TAG_CACHE_HPP
+
+#include <list>          //For std::list
+#include <memory>        //For std::shared_ptr and std::unique_ptr
+#include <mutex>         //For std::mutex
+#include <ostream>       //For std::ostream
+#include <string>        //For std::string
+#include <unordered_map> //For std::unordered_map
+#include <vector>        //For std::vector
+
+#include "ID3.hpp" //For ID3::Tag
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * Options for an ID3::TagCache.
+	 */
+	struct TagCacheOptions {
+		TagCacheOptions();
+		ulong maxBytes;     //The most memory the cached Tags can take up, as counted by Tag::memoryUsage() (64 MiB)
+		unsigned shards;    //The number of separately-locked parts the cache is split into (16)
+		bool cacheNegative; //If files that aren't audio files or have no frames are remembered (true)
+	};
+	
+	/**
+	 * The hits and misses of an ID3::TagCache.
+	 */
+	struct TagCacheStats {
+		TagCacheStats();
+		ulong hits;         //The lookups that found a Tag
+		ulong negativeHits; //The lookups that found a file remembered as not an audio file or without frames
+		ulong misses;       //The lookups that read the file
+		ulong evictions;    //The entries removed to make room
+		ulong entries;      //The entries in the cache
+		ulong bytes;        //The memory the entries take up
+		
+		/**
+		 * @return The fraction of lookups that didn't read the file, or 0 if
+		 *         there were none.
+		 */
+		double hitRate() const;
+		
+		/**
+		 * Print the statistics in a human-readable form.
+		 * 
+		 * @param os The output stream.
+		 */
+		void print(std::ostream& os) const;
+	};
+	
+	/**
+	 * TagCache keeps the Tags of recently-read files in memory, so files that
+	 * are read again and again are only read once. Each Tag is shared as a
+	 * const Tag between everyone who looks it up.
+	 * 
+	 * Files are looked up by device, inode, modification time, and size, so a
+	 * file that's changed or replaced is read again, and hard links share an
+	 * entry. The cache is split into shards, each with its own lock and its
+	 * own share of the memory limit, and each shard evicts its least recently
+	 * used entries once the Tags in it take up more than its share. Files are
+	 * read without holding a lock.
+	 * 
+	 * NOTE: Tags bigger than a shard's share of the memory limit are returned
+	 *       but not cached.
+	 * 
+	 * Defined in ID3TagCache.cpp.
+	 */
+	class TagCache {
+		public:
+			/**
+			 * Create an empty cache.
+			 * 
+			 * @param options The cache options.
+			 */
+			explicit TagCache(const TagCacheOptions& options=TagCacheOptions());
+			
+			/**
+			 * Get the Tag of a file, reading it if it isn't cached.
+			 * 
+			 * @param fileLoc The file path.
+			 * @return The Tag, or nullptr if the file isn't an MP3, MP4, WAV, or
+			 *         AIFF file or has no frames.
+			 * @throws ID3::FileNotFoundException if the file can't be opened.
+			 * @throws ID3::FileFormatException if the file's ID3v2 tags are
+			 *         supposedly bigger than the file itself.
+			 */
+			std::shared_ptr<const Tag> get(const std::string& fileLoc);
+			
+			/**
+			 * Remove a file from the cache, such as after writing to it.
+			 * 
+			 * @param fileLoc The file path.
+			 */
+			void erase(const std::string& fileLoc);
+			
+			/**
+			 * Remove every entry. The statistics other than the entries and bytes
+			 * are kept.
+			 */
+			void clear();
+			
+			/**
+			 * @return The hits, misses, and size of the cache.
+			 */
+			TagCacheStats stats() const;
+		
+		private:
+			/**
+			 * What a file is looked up by.
+			 */
+			struct Key {
+				ulong device;  //The device the file is on
+				ulong inode;   //The file's inode
+				int64_t mtime; //The modification time, in nanoseconds
+				ulong size;    //The file size
+				bool operator==(const Key& other) const;
+			};
+			
+			/**
+			 * The hash of a Key.
+			 */
+			struct KeyHash {
+				size_t operator()(const Key& key) const;
+			};
+			
+			/**
+			 * A cached Tag.
+			 */
+			struct Entry {
+				Key key;                        //The file
+				std::shared_ptr<const Tag> tag; //The Tag, or nullptr for a negative entry
+				ulong bytes;                    //The memory the entry takes up
+			};
+			
+			/**
+			 * A separately-locked part of the cache, with its entries from the
+			 * most to the least recently used.
+			 */
+			struct Shard {
+				Shard();
+				mutable std::mutex mutex;                                           //The lock on everything else
+				std::list<Entry> entries;                                           //The entries, most recently used first
+				std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index; //The entries by key
+				ulong bytes;                                                        //The memory the entries take up
+				ulong hits, negativeHits, misses, evictions;                        //The statistics
+			};
+			
+			/**
+			 * Find the key of a file.
+			 * 
+			 * @param fileLoc The file path.
+			 * @param key     The key to set.
+			 * @return If the file could be stat-ed.
+			 */
+			static bool fileKey(const std::string& fileLoc, Key& key);
+			
+			/**
+			 * @param key A file's key.
+			 * @return The shard the file is in.
+			 */
+			Shard& shardOf(const Key& key) const;
+			
+			/**
+			 * The cache options.
+			 */
+			TagCacheOptions cacheOptions;
+			
+			/**
+			 * The memory limit of each shard.
+			 */
+			ulong shardBytes;
+			
+			/**
+			 * The shards.
+			 */
+			std::vector<std::unique_ptr<Shard>> shards;
+	};
+}
+
+#endif
@@ -0,0 +1,147 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm> //For std::min()
+#include <ctime>     //For time() and gmtime_r()
+
+#include "ID3Timestamp.hpp" //For the struct definitions
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * Parse a field of two or four digits.
+	 * 
+	 * @param text   The start of the field.
+	 * @param digits The number of digits.
+	 * @param value  Set to the field's value.
+	 * @return If every character is a digit.
+	 */
+	inline bool parseDigits(const char* text, const size_t digits, unsigned& value) {
+		value = 0;
+		for(size_t i = 0; i < digits; i++) {
+			const unsigned digit = static_cast<unsigned char>(text[i]) - '0';
+			if(digit > 9) return false;
+			value = value * 10 + digit;
+		}
+		return true;
+	}
+	
+	/**
+	 * Write a field of two or four digits, with leading zeros.
+	 * 
+	 * @param buffer The buffer to write to.
+	 * @param digits The number of digits.
+	 * @param value  The field's value.
+	 */
+	inline void formatDigits(char* buffer, const size_t digits, unsigned value) {
+		for(size_t i = digits; i > 0; i--) {
+			buffer[i - 1] = '0' + value % 10;
+			value /= 10;
+		}
+	}
+}
+
+///@pkg ID3Timestamp.h
+Timestamp::Timestamp(const uint16_t           year,
+                     const uint8_t            month,
+                     const uint8_t            day,
+                     const uint8_t            hour,
+                     const uint8_t            minute,
+                     const uint8_t            second,
+                     const TimestampPrecision precision) : year(year),
+                                                           month(month),
+                                                           day(day),
+                                                           hour(hour),
+                                                           minute(minute),
+                                                           second(second),
+                                                           precision(precision) {
+	if(precision != TimestampPrecision::NONE || year == 0) return;
+	if(month == 0)                                   this->precision = TimestampPrecision::YEAR;
+	else if(day == 0)                                this->precision = TimestampPrecision::MONTH;
+	else if(hour == 0 && minute == 0 && second == 0) this->precision = TimestampPrecision::DAY;
+	else                                             this->precision = TimestampPrecision::SECOND;
+}
+
+///@pkg ID3Timestamp.h
+Timestamp Timestamp::parse(const char* text, const size_t length) {
+	//The separator before each field after the year, the field's position,
+	//and its range
+	static const struct {
+		char separator;
+		size_t position;
+		unsigned min, max;
+	} FIELDS[] = {{'-', 5, 1, 12}, {'-', 8, 1, 31}, {'T', 11, 0, 23}, {':', 14, 0, 59}, {':', 17, 0, 59}};
+	
+	Timestamp timestamp;
+	unsigned value;
+	if(length < 4 || !parseDigits(text, 4, value)) return timestamp;
+	timestamp.year = value;
+	timestamp.precision = TimestampPrecision::YEAR;
+	
+	uint8_t* const FIELD_VALUES[] = {&timestamp.month, &timestamp.day, &timestamp.hour, &timestamp.minute, &timestamp.second};
+	for(size_t i = 0; i < 5; i++) {
+		const size_t POSITION = FIELDS[i].position;
+		if(length < POSITION + 2 || text[POSITION - 1] != FIELDS[i].separator ||
+		   !parseDigits(text + POSITION, 2, value) || value < FIELDS[i].min || value > FIELDS[i].max)
+			break;
+		*FIELD_VALUES[i] = value;
+		timestamp.precision = static_cast<TimestampPrecision>(i + 2);
+	}
+	return timestamp;
+}
+
+///@pkg ID3Timestamp.h
+Timestamp Timestamp::parse(const std::string& text) { return parse(text.data(), text.size()); }
+
+///@pkg ID3Timestamp.h
+Timestamp Timestamp::now() {
+	const time_t rawtime = time(nullptr);
+	struct tm utctime;
+	if(gmtime_r(&rawtime, &utctime) == nullptr) return Timestamp();
+	return Timestamp(utctime.tm_year + 1900, utctime.tm_mon + 1, utctime.tm_mday,
+	                 utctime.tm_hour, utctime.tm_min, std::min(utctime.tm_sec, 59), TimestampPrecision::SECOND);
+}
+
+///@pkg ID3Timestamp.h
+size_t Timestamp::format(char* buffer) const {
+	if(precision == TimestampPrecision::NONE) return 0;
+	formatDigits(buffer, 4, year);
+	
+	//Each field after the year is a separator and two digits
+	static const char SEPARATORS[] = {'-', '-', 'T', ':', ':'};
+	const uint8_t FIELD_VALUES[] = {month, day, hour, minute, second};
+	size_t length = 4;
+	for(size_t i = 0; i + 2 <= static_cast<size_t>(precision) && i < 5; i++) {
+		buffer[length] = SEPARATORS[i];
+		formatDigits(buffer + length + 1, 2, FIELD_VALUES[i]);
+		length += 3;
+	}
+	return length;
+}
+
+///@pkg ID3Timestamp.h
+std::string Timestamp::toString() const {
+	char buffer[MAX_LENGTH];
+	return std::string(buffer, format(buffer));
+}
+
+///@pkg ID3Timestamp.h
+uint64_t Timestamp::key() const {
+	//The precision is the lowest byte, so that a timestamp with its fields
+	//after the precision set to 0 comes after one without them
+	return (static_cast<uint64_t>(year) << 48) | (static_cast<uint64_t>(month) << 40) |
+	       (static_cast<uint64_t>(day) << 32) | (static_cast<uint64_t>(hour) << 24) |
+	       (static_cast<uint64_t>(minute) << 16) | (static_cast<uint64_t>(second) << 8) |
+	       static_cast<uint64_t>(precision);
+}
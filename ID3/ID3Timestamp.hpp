@@ -0,0 +1,145 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_TIMESTAMP_HPP
+#define ID3_TIMESTAMP_HPP
+
+#include <cstdint> //For uint8_t and uint16_t
+#include <string>  //For std::string
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * How much of a timestamp is set, from the year down to the second.
+	 */
+	enum class TimestampPrecision : uint8_t {
+		NONE   = 0, //No timestamp
+		YEAR   = 1, //yyyy
+		MONTH  = 2, //yyyy-MM
+		DAY    = 3, //yyyy-MM-dd
+		HOUR   = 4, //yyyy-MM-ddTHH
+		MINUTE = 5, //yyyy-MM-ddTHH:mm
+		SECOND = 6  //yyyy-MM-ddTHH:mm:ss
+	};
+	
+	/**
+	 * A timestamp in the format of the ID3v2.4.0 time frames (TDRC, TDOR,
+	 * TDRL, TDTG, TDEN), which are a subset of ISO 8601. The fields past the
+	 * precision are 0.
+	 * 
+	 * Timestamps compare field by field, so a timestamp is before every more
+	 * precise timestamp it's the start of, and they can be used as sort keys
+	 * and in range queries without formatting them.
+	 * 
+	 * Defined in ID3Timestamp.cpp.
+	 * 
+	 * @see ID3::Tag::timestamp(FrameID&)
+	 */
+	struct Timestamp {
+		/**
+		 * The most characters a formatted timestamp takes up.
+		 */
+		static const size_t MAX_LENGTH = 19;
+		
+		/**
+		 * Create a timestamp. With no arguments it's empty.
+		 * 
+		 * @param year   The year, from 0 to 9999.
+		 * @param month  The month, from 1 to 12, or 0 for a year precision.
+		 * @param day    The day, from 1 to 31, or 0 for a month precision.
+		 * @param hour   The hour, from 0 to 23.
+		 * @param minute The minute, from 0 to 59.
+		 * @param second The second, from 0 to 59.
+		 * @param precision The fields that are set. If it's NONE and the year
+		 *                  is set, it's found from the fields that aren't 0.
+		 */
+		Timestamp(const uint16_t           year=0,
+		          const uint8_t            month=0,
+		          const uint8_t            day=0,
+		          const uint8_t            hour=0,
+		          const uint8_t            minute=0,
+		          const uint8_t            second=0,
+		          const TimestampPrecision precision=TimestampPrecision::NONE);
+		
+		uint16_t year;                //The year
+		uint8_t month;                //The month, from 1 to 12
+		uint8_t day;                  //The day of the month, from 1 to 31
+		uint8_t hour;                 //The hour, from 0 to 23
+		uint8_t minute;               //The minute, from 0 to 59
+		uint8_t second;               //The second, from 0 to 59
+		TimestampPrecision precision; //The fields that are set
+		
+		/**
+		 * @return If no fields are set.
+		 */
+		inline bool empty() const { return precision == TimestampPrecision::NONE; }
+		
+		/**
+		 * Parse a timestamp from the text of a time frame. Fields after the
+		 * first missing or malformed field are left unset, so "2016-13-01"
+		 * parses as the year 2016.
+		 * 
+		 * @param text   The text.
+		 * @param length The length of the text.
+		 * @return The timestamp, which is empty if the text doesn't start with
+		 *         a four-digit year.
+		 */
+		static Timestamp parse(const char* text, const size_t length);
+		/** @see ID3::Timestamp::parse(const char*, size_t) */
+		static Timestamp parse(const std::string& text);
+		
+		/**
+		 * @return The current time in UTC, to the second.
+		 */
+		static Timestamp now();
+		
+		/**
+		 * Format the timestamp for a time frame, to its precision.
+		 * 
+		 * @param buffer The buffer to write to, which must have room for
+		 *               ID3::Timestamp::MAX_LENGTH characters. It isn't
+		 *               NUL-terminated.
+		 * @return The number of characters written.
+		 */
+		size_t format(char* buffer) const;
+		
+		/**
+		 * @return The formatted timestamp, or "" if it's empty.
+		 * @see ID3::Timestamp::format(char*)
+		 */
+		std::string toString() const;
+		
+		/**
+		 * @return The fields packed into one integer, in the same order as the
+		 *         timestamps compare.
+		 */
+		uint64_t key() const;
+		
+		inline bool operator==(const Timestamp& other) const { return key() == other.key(); }
+		inline bool operator!=(const Timestamp& other) const { return key() != other.key(); }
+		inline bool operator<(const Timestamp& other) const { return key() < other.key(); }
+		inline bool operator<=(const Timestamp& other) const { return key() <= other.key(); }
+		inline bool operator>(const Timestamp& other) const { return key() > other.key(); }
+		inline bool operator>=(const Timestamp& other) const { return key() >= other.key(); }
+	};
+}
+
+#endif
@@ -0,0 +1,221 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <cstring>   //For memcmp()
+#include <algorithm> //For std::min() and std::any_of()
+
+#include "ID3TrailingTags.hpp" //For the class definition
+#include "ID3Functions.hpp"    //For littleEndianIntVal()
+#include "ID3Constants.hpp"    //For V1::BYTE_SIZE and TRAILING_TAG_READ_SIZE
+#include "ID3IOThrottle.hpp"   //For IOThrottle::charge()
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The size of an APE tag header or footer.
+	 */
+	static const ushort APE_FOOTER_SIZE = 32;
+	
+	/**
+	 * The APE tag flag that is set when the tag contains a header.
+	 */
+	static const ulong APE_FLAG_HAS_HEADER = 1UL << 31;
+	
+	/**
+	 * The size of the "LYRICSEND" and "LYRICS200" end markers.
+	 */
+	static const ushort LYRICS3_END_SIZE = 9;
+	
+	/**
+	 * The size of the "LYRICSBEGIN" start marker.
+	 */
+	static const ushort LYRICS3_BEGIN_SIZE = 11;
+	
+	/**
+	 * The number of digits in the Lyrics3v2 size field.
+	 */
+	static const ushort LYRICS3V2_SIZE_DIGITS = 6;
+	
+	/**
+	 * The maximum size of a Lyrics3v1 block: the start marker, up to 5100
+	 * bytes of lyrics, and the end marker.
+	 */
+	static const ulong LYRICS3V1_MAX_SIZE = LYRICS3_BEGIN_SIZE + 5100 + LYRICS3_END_SIZE;
+}
+
+///@pkg ID3TrailingTags.h
+TrailingTag::TrailingTag(const TrailingTagType type,
+                         const ulong           start,
+                         const ulong           size) : type(type),
+                                                       start(start),
+                                                       size(size) {}
+
+///@pkg ID3TrailingTags.h
+TrailingTags::TrailingTags() : filesize(0), audioEndPos(0) {}
+
+///@pkg ID3TrailingTags.h
+TrailingTags::TrailingTags(std::istream& file,
+                           const ulong   fileSize,
+                           const ulong   audioStart) : filesize(fileSize),
+                                                       audioEndPos(fileSize) {
+	if(fileSize <= audioStart) return;
+	
+	//Read the end of the file in one go. Every trailing tag marker and footer
+	//is found in this chunk, unless a big APE tag pushes a block further back.
+	const ulong CHUNK_SIZE  = std::min(fileSize - audioStart, TRAILING_TAG_READ_SIZE),
+	            CHUNK_START = fileSize - CHUNK_SIZE;
+	ByteArray chunk(CHUNK_SIZE, '\0');
+	
+	file.clear();
+	file.seekg(CHUNK_START, std::ios_base::beg);
+	if(!file) return;
+	IOThrottle::charge(CHUNK_SIZE);
+	file.read(reinterpret_cast<char*>(&chunk.front()), CHUNK_SIZE);
+	if(!file) return;
+	
+	//Bytes that are outside the chunk are read into here
+	ByteArray extra;
+	
+	//Get a pointer to the bytes in the range [pos, pos + length), reading
+	//from the file only if they're not in the chunk. Returns nullptr if the
+	//bytes can't be read.
+	auto bytesAt = [&](const ulong pos, const ulong length) -> const uint8_t* {
+		if(pos >= CHUNK_START) return &chunk[pos - CHUNK_START];
+		extra.resize(length);
+		file.clear();
+		file.seekg(pos, std::ios_base::beg);
+		if(!file) return nullptr;
+		IOThrottle::charge(length);
+		file.read(reinterpret_cast<char*>(&extra.front()), length);
+		return file ? &extra.front() : nullptr;
+	};
+	
+	//Check if the given marker is at the given position
+	auto markerAt = [&](const ulong pos, const char* marker, const ushort length) -> bool {
+		const uint8_t* bytes = bytesAt(pos, length);
+		return bytes != nullptr && memcmp(bytes, marker, length) == 0;
+	};
+	
+	//The end of the region that hasn't been identified yet
+	ulong end = fileSize;
+	
+	//The ID3v1 tag is always the very last block. It always fits in the
+	//chunk, as TRAILING_TAG_READ_SIZE is much bigger than a v1 tag.
+	if(end - audioStart >= V1::BYTE_SIZE && markerAt(end - V1::BYTE_SIZE, "TAG", 3)) {
+		end -= V1::BYTE_SIZE;
+		v1Bytes.assign(chunk.end() - V1::BYTE_SIZE, chunk.end());
+		trailingTags.emplace_back(TrailingTagType::ID3V1, end, V1::BYTE_SIZE);
+		
+		//The ID3v1 Extended tag is placed directly before the ID3v1 tag
+		if(end - audioStart >= V1::EXTENDED_BYTE_SIZE && markerAt(end - V1::EXTENDED_BYTE_SIZE, "TAG+", 4)) {
+			end -= V1::EXTENDED_BYTE_SIZE;
+			v1ExtendedBytes.assign(chunk.begin() + (end - CHUNK_START),
+			                       chunk.begin() + (end - CHUNK_START) + V1::EXTENDED_BYTE_SIZE);
+			trailingTags.emplace_back(TrailingTagType::ID3V1_EXTENDED, end, V1::EXTENDED_BYTE_SIZE);
+		}
+	}
+	
+	//Walk backwards over the APE and Lyrics3 blocks until the audio is reached
+	bool foundBlock = true;
+	while(foundBlock) {
+		foundBlock = false;
+		const ulong space = end - audioStart;
+		
+		//APEv2 and APEv1 tags end in a 32-byte footer starting with "APETAGEX".
+		//The footer's size field includes the footer and the items, but not
+		//the header.
+		if(space >= APE_FOOTER_SIZE && markerAt(end - APE_FOOTER_SIZE, "APETAGEX", 8)) {
+			const uint8_t* footer = bytesAt(end - APE_FOOTER_SIZE, APE_FOOTER_SIZE);
+			if(footer == nullptr) break;
+			const ulong tagSize = littleEndianIntVal(footer + 12, 4),
+			            flags   = littleEndianIntVal(footer + 20, 4),
+			            blockSize = tagSize + ((flags & APE_FLAG_HAS_HEADER) ? APE_FOOTER_SIZE : 0);
+			
+			if(tagSize >= APE_FOOTER_SIZE && blockSize <= space &&
+			   (!(flags & APE_FLAG_HAS_HEADER) || markerAt(end - blockSize, "APETAGEX", 8))) {
+				end -= blockSize;
+				trailingTags.emplace_back(TrailingTagType::APEV2, end, blockSize);
+				foundBlock = true;
+			}
+			continue;
+		}
+		
+		//Lyrics3v2 blocks end with a 6-digit size and "LYRICS200". The size
+		//counts everything from "LYRICSBEGIN" up to the size field.
+		if(space >= LYRICS3_END_SIZE + LYRICS3V2_SIZE_DIGITS &&
+		   markerAt(end - LYRICS3_END_SIZE, "LYRICS200", LYRICS3_END_SIZE)) {
+			const uint8_t* sizeField = bytesAt(end - LYRICS3_END_SIZE - LYRICS3V2_SIZE_DIGITS, LYRICS3V2_SIZE_DIGITS);
+			if(sizeField == nullptr) break;
+			
+			ulong lyricsSize = 0;
+			bool validSize = true;
+			for(ushort i = 0; i < LYRICS3V2_SIZE_DIGITS; i++) {
+				if(sizeField[i] < '0' || sizeField[i] > '9') { validSize = false; break; }
+				lyricsSize = lyricsSize * 10 + (sizeField[i] - '0');
+			}
+			
+			const ulong blockSize = lyricsSize + LYRICS3V2_SIZE_DIGITS + LYRICS3_END_SIZE;
+			if(validSize && lyricsSize >= LYRICS3_BEGIN_SIZE && blockSize <= space &&
+			   markerAt(end - blockSize, "LYRICSBEGIN", LYRICS3_BEGIN_SIZE)) {
+				end -= blockSize;
+				trailingTags.emplace_back(TrailingTagType::LYRICS3V2, end, blockSize);
+				foundBlock = true;
+			}
+			continue;
+		}
+		
+		//Lyrics3v1 blocks have no size field, so search for the closest
+		//"LYRICSBEGIN" within the maximum block size.
+		if(space >= LYRICS3_BEGIN_SIZE + LYRICS3_END_SIZE &&
+		   markerAt(end - LYRICS3_END_SIZE, "LYRICSEND", LYRICS3_END_SIZE)) {
+			const ulong searchSize  = std::min(space, LYRICS3V1_MAX_SIZE),
+			            searchStart = end - searchSize;
+			const uint8_t* window = bytesAt(searchStart, searchSize);
+			if(window == nullptr) break;
+			
+			for(ulong i = searchSize - LYRICS3_END_SIZE - LYRICS3_BEGIN_SIZE + 1; i > 0; i--) {
+				if(memcmp(window + i - 1, "LYRICSBEGIN", LYRICS3_BEGIN_SIZE) == 0) {
+					const ulong blockSize = searchSize - (i - 1);
+					end -= blockSize;
+					trailingTags.emplace_back(TrailingTagType::LYRICS3V1, end, blockSize);
+					foundBlock = true;
+					break;
+				}
+			}
+		}
+	}
+	
+	audioEndPos = end;
+}
+
+///@pkg ID3TrailingTags.h
+const std::vector<TrailingTag>& TrailingTags::tags() const { return trailingTags; }
+
+///@pkg ID3TrailingTags.h
+bool TrailingTags::exists(const TrailingTagType type) const {
+	return std::any_of(trailingTags.begin(), trailingTags.end(),
+	                   [type](const TrailingTag& tag) -> bool { return tag.type == type; });
+}
+
+///@pkg ID3TrailingTags.h
+ulong TrailingTags::audioEnd() const { return audioEndPos; }
+
+///@pkg ID3TrailingTags.h
+ulong TrailingTags::fileSize() const { return filesize; }
+
+///@pkg ID3TrailingTags.h
+const ByteArray& TrailingTags::v1Tag() const { return v1Bytes; }
+
+///@pkg ID3TrailingTags.h
+const ByteArray& TrailingTags::v1ExtendedTag() const { return v1ExtendedBytes; }
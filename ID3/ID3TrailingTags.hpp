@@ -0,0 +1,155 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_TRAILING_TAGS_HPP
+#define ID3_TRAILING_TAGS_HPP
+
+#include <istream> //For std::istream
+#include <vector>  //For std::vector
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * @see ID3.h
+	 */
+	typedef std::vector<uint8_t> ByteArray;
+	
+	/**
+	 * The types of tag blocks that can be found after the audio data.
+	 */
+	enum class TrailingTagType {
+		ID3V1,          //A 128-byte ID3v1 or ID3v1.1 tag
+		ID3V1_EXTENDED, //A 227-byte ID3v1 Extended tag ("TAG+")
+		APEV2,          //An APEv2 (or APEv1) tag with a footer
+		LYRICS3V1,      //A Lyrics3v1 block ending in "LYRICSEND"
+		LYRICS3V2       //A Lyrics3v2 block ending in "LYRICS200"
+	};
+	
+	/**
+	 * The location of a tag block found after the audio data.
+	 */
+	struct TrailingTag {
+		TrailingTag(const TrailingTagType type, const ulong start, const ulong size);
+		TrailingTagType type; //The tag format
+		ulong start;          //The file position the block starts on
+		ulong size;           //The total block size, including headers and footers
+	};
+	
+	/**
+	 * TrailingTags finds every tag block that is appended to the end of a file,
+	 * between the audio data and the end of the file. ID3v1, ID3v1 Extended,
+	 * APEv2, Lyrics3v1 and Lyrics3v2 blocks are recognized, in any order.
+	 * 
+	 * The end of the file is read with a single bounded read. A second read is
+	 * only done when a block's declared size reaches past that chunk and its
+	 * start marker needs to be verified.
+	 * 
+	 * NOTE: The contents of the APE and Lyrics3 blocks are not parsed, only
+	 *       their extents. The raw ID3v1 and ID3v1 Extended tags are kept so
+	 *       that they can be processed by ID3::Tag.
+	 * 
+	 * Defined in ID3TrailingTags.cpp.
+	 */
+	class TrailingTags {
+		public:
+			/**
+			 * Find the trailing tags of a file.
+			 * 
+			 * NOTE: Blocks that would start before audioStart are not accepted,
+			 *       so that the ID3v2 tag at the start of a small file can't be
+			 *       mistaken for part of a trailing tag.
+			 * 
+			 * @param file       The file stream object.
+			 * @param fileSize   The size of the file.
+			 * @param audioStart The position the audio data starts on (the end of
+			 *                   the ID3v2 tag, or 0).
+			 */
+			TrailingTags(std::istream& file, const ulong fileSize, const ulong audioStart=0);
+			
+			/**
+			 * The empty constructor, for a file with no trailing tags.
+			 */
+			TrailingTags();
+			
+			/**
+			 * @return The trailing tags found, ordered from the end of the file
+			 *         to the start.
+			 */
+			const std::vector<TrailingTag>& tags() const;
+			
+			/**
+			 * @return If a trailing tag of the given type is on file.
+			 */
+			bool exists(const TrailingTagType type) const;
+			
+			/**
+			 * @return The position right after the last byte of audio data. This
+			 *         is the start of the first trailing tag, or the file size if
+			 *         there are none.
+			 */
+			ulong audioEnd() const;
+			
+			/**
+			 * @return The file size given in the constructor.
+			 */
+			ulong fileSize() const;
+			
+			/**
+			 * @return The bytes of the ID3v1 tag, or an empty ByteArray if there
+			 *         is none.
+			 */
+			const ByteArray& v1Tag() const;
+			
+			/**
+			 * @return The bytes of the ID3v1 Extended tag, or an empty ByteArray
+			 *         if there is none.
+			 */
+			const ByteArray& v1ExtendedTag() const;
+		
+		private:
+			/**
+			 * The trailing tags, from the end of the file to the start.
+			 */
+			std::vector<TrailingTag> trailingTags;
+			
+			/**
+			 * The raw ID3v1 tag.
+			 */
+			ByteArray v1Bytes;
+			
+			/**
+			 * The raw ID3v1 Extended tag.
+			 */
+			ByteArray v1ExtendedBytes;
+			
+			/**
+			 * The file size.
+			 */
+			ulong filesize;
+			
+			/**
+			 * The end of the audio data.
+			 */
+			ulong audioEndPos;
+	};
+}
+
+#endif
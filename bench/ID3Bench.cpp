@@ -0,0 +1,362 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+/**
+ * ID3Bench times reading, getting, and writing the tags of the files that
+ * ID3Corpus writes, checks that each file is read the way it should be, and
+ * checks that the time taken grows linearly with the number of frames. It
+ * also counts the memory allocated to read a typical tag. It exits with 1
+ * if any check fails.
+ * 
+ * Usage: ID3Bench <corpus directory>
+ */
+
+#include <algorithm> //For std::min()
+#include <atomic>    //For std::atomic
+#include <chrono>    //For std::chrono::steady_clock
+#include <cstdio>    //For std::remove()
+#include <cstdlib>   //For malloc() and free()
+#include <fstream>   //For std::ifstream and std::ofstream
+#include <iomanip>   //For std::setw() and std::setprecision()
+#include <iostream>  //For std::cout and std::cerr
+#include <new>       //For std::bad_alloc
+#include <string>    //For std::string
+#include <vector>    //For std::vector
+#include <unistd.h>  //For chdir()
+
+#include "../ID3/ID3.hpp"          //For ID3::Tag
+#include "../ID3/ID3Exception.hpp" //For ID3::Exception
+
+//Private namespace
+namespace {
+	/**
+	 * How many times each step is timed. The fastest time is kept.
+	 */
+	const unsigned int REPEATS = 3;
+	
+	/**
+	 * The most a step's time can grow from 50k to 200k frames. Linear growth
+	 * makes it 4 times longer, and quadratic growth 16 times longer.
+	 */
+	const double GROWTH_LIMIT = 8.0;
+	
+	/**
+	 * Steps faster than this many milliseconds aren't checked for growth,
+	 * since their times are mostly noise.
+	 */
+	const double GROWTH_FLOOR = 10.0;
+	
+	/**
+	 * How many times the typical tag is read when counting allocations.
+	 */
+	const unsigned int ALLOCATION_READS = 2000;
+	
+	/**
+	 * The most memory allocations reading the typical tag can take. It took 81
+	 * before frames kept their bytes in a SmallByteArray, and 45 after. The
+	 * frame order kept for Tag::visitFrames() added 1.
+	 */
+	const double ALLOCATION_LIMIT = 46.0;
+	
+	std::atomic<unsigned long> allocations(0);    //The memory allocations so far
+	std::atomic<unsigned long> allocatedBytes(0); //The bytes allocated so far
+	
+	/**
+	 * Allocate memory and count it. Used by operator new.
+	 * 
+	 * @param bytes The bytes to allocate.
+	 * @return The memory.
+	 */
+	void* allocate(const size_t bytes) {
+		allocations++;
+		allocatedBytes += bytes;
+		void* const memory = malloc(bytes > 0 ? bytes : 1);
+		if(memory == nullptr) throw std::bad_alloc();
+		return memory;
+	}
+	
+	/**
+	 * The times taken to read, get, and write a file's tag, in milliseconds,
+	 * or -1 if the file was rejected.
+	 */
+	struct Timing {
+		Timing() : read(-1), getters(-1), write(-1) {}
+		double read;    //Reading the tag
+		double getters; //Calling the getters
+		double write;   //Writing the tag without unknown frames and duplicate pictures
+	};
+	
+	/**
+	 * The checks that failed.
+	 */
+	std::vector<std::string> failures;
+	
+	/**
+	 * Record a check.
+	 * 
+	 * @param passed  If the check passed.
+	 * @param message What was checked.
+	 */
+	void check(const bool passed, const std::string& message) {
+		if(!passed) failures.push_back(message);
+	}
+	
+	/**
+	 * @param start When the step started.
+	 * @return The milliseconds since the step started.
+	 */
+	double elapsed(const std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+	
+	/**
+	 * Copy a file, so writing to it leaves the corpus unchanged.
+	 * 
+	 * @param from The file to copy.
+	 * @param to   The copy.
+	 */
+	void copyFile(const std::string& from, const std::string& to) {
+		std::ifstream in(from, std::ios::binary);
+		std::ofstream out(to, std::ios::binary | std::ios::trunc);
+		out << in.rdbuf();
+	}
+	
+	/**
+	 * Call the getters that look at every frame, or every frame with an ID.
+	 * 
+	 * @param tag The Tag.
+	 * @return A value from the getters, so they aren't optimised away.
+	 */
+	size_t callGetters(const ID3::Tag& tag) {
+		size_t value = tag.title().size() + tag.artist().size() + tag.album().size();
+		value += tag.rating() + tag.playCount() + tag.pictures().size() + tag.exists(ID3::FRAME_POPULARIMETER);
+		value += tag.visitFrames([](const ID3::FrameView&) { return true; });
+		return value;
+	}
+	
+	/**
+	 * Time reading, getting, and writing a file's tag, and check it. Files
+	 * that are rejected fail the check.
+	 * 
+	 * @param directory  The corpus directory.
+	 * @param name       The file name.
+	 * @param checkTag   Checks the Tag that was read, and the getters' value.
+	 * @param checkWrite Checks the result of writing the Tag.
+	 * @return The times taken.
+	 */
+	template<typename TagCheck, typename WriteCheck>
+	Timing measure(const std::string& directory, const std::string& name, TagCheck checkTag, WriteCheck checkWrite) {
+		const std::string file = directory + "/" + name, copy = directory + "/scratch.mp3";
+		Timing timing;
+		try {
+			for(unsigned int i = 0; i < REPEATS; i++) {
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				ID3::Tag tag(file);
+				const double READ = elapsed(start);
+				
+				start = std::chrono::steady_clock::now();
+				const size_t VALUE = callGetters(tag);
+				const double GETTERS = elapsed(start);
+				if(i == 0) checkTag(tag, VALUE);
+				
+				copyFile(file, copy);
+				ID3::Tag copiedTag(copy);
+				ID3::WriteOptions options;
+				options.discardUnknown = true;
+				options.dedupePictures = true;
+				start = std::chrono::steady_clock::now();
+				const ID3::WriteResult result = copiedTag.write(copy, options);
+				const double WRITE = elapsed(start);
+				if(i == 0) checkWrite(result);
+				
+				timing.read = i == 0 ? READ : std::min(timing.read, READ);
+				timing.getters = i == 0 ? GETTERS : std::min(timing.getters, GETTERS);
+				timing.write = i == 0 ? WRITE : std::min(timing.write, WRITE);
+			}
+		} catch(const std::exception& e) {
+			check(false, name + " threw " + e.what());
+			return timing;
+		}
+		std::cout << std::setw(20) << std::left << name << std::right << std::fixed << std::setprecision(2)
+		          << " read " << std::setw(9) << timing.read << " ms"
+		          << "  getters " << std::setw(9) << timing.getters << " ms"
+		          << "  write " << std::setw(9) << timing.write << " ms" << std::endl;
+		return timing;
+	}
+	
+	/**
+	 * @see measure(const std::string&, const std::string&, TagCheck, WriteCheck)
+	 */
+	template<typename TagCheck>
+	Timing measure(const std::string& directory, const std::string& name, TagCheck checkTag) {
+		return measure(directory, name, checkTag, [](const ID3::WriteResult&) {});
+	}
+	
+	/**
+	 * Check that a file's tag is rejected as badly formatted.
+	 * 
+	 * @param directory The corpus directory.
+	 * @param name      The file name.
+	 */
+	void checkRejected(const std::string& directory, const std::string& name) {
+		try {
+			ID3::Tag tag(directory + "/" + name);
+			check(false, name + " wasn't rejected");
+		} catch(const ID3::FileFormatException& e) {
+			std::cout << std::setw(20) << std::left << name << " rejected: " << std::string(e.what()).substr(0, 60) << std::endl;
+		} catch(const std::exception& e) {
+			check(false, name + " threw " + e.what());
+		}
+	}
+	
+	/**
+	 * Check that a step's time grows linearly with the number of frames.
+	 * 
+	 * @param name    The files' name without the frame count.
+	 * @param step    The step.
+	 * @param smaller The time taken with 50k frames.
+	 * @param larger  The time taken with 200k frames.
+	 */
+	void checkGrowth(const std::string& name, const std::string& step, const double smaller, const double larger) {
+		if(smaller < 0 || larger < 0 || larger < GROWTH_FLOOR) return;
+		check(larger <= GROWTH_LIMIT * smaller,
+		      name + " " + step + " grew from " + std::to_string(smaller) + " ms to " + std::to_string(larger) + " ms");
+	}
+	
+	/**
+	 * Time files of the same frames at 50k, 100k, and 200k frames, and check
+	 * that each step grows linearly. The growth of each step is printed.
+	 * 
+	 * @param directory The corpus directory.
+	 * @param name      The files' name without the frame count.
+	 * @param checkTag  Checks the Tag that was read, given the frame count.
+	 */
+	template<typename TagCheck>
+	void measureGrowth(const std::string& directory, const std::string& name, TagCheck checkTag) {
+		std::vector<Timing> timings;
+		for(const size_t frames : {50000, 100000, 200000}) {
+			const std::string file = name + "-" + std::to_string(frames / 1000) + "k.mp3";
+			timings.push_back(measure(directory, file, [&file, &checkTag, frames](const ID3::Tag& tag, size_t) {
+				check(checkTag(tag, frames), file + " wasn't read as it should be");
+			}));
+		}
+		const Timing& smallest = timings.front();
+		const Timing& largest = timings.back();
+		std::cout << std::setw(20) << std::left << name + " growth" << std::right << std::fixed << std::setprecision(2)
+		          << " read " << std::setw(9) << largest.read / smallest.read << " x "
+		          << "  getters " << std::setw(9) << largest.getters / smallest.getters << " x "
+		          << "  write " << std::setw(9) << largest.write / smallest.write << " x " << std::endl;
+		checkGrowth(name, "read", smallest.read, largest.read);
+		checkGrowth(name, "getters", smallest.getters, largest.getters);
+		checkGrowth(name, "write", smallest.write, largest.write);
+	}
+	
+	/**
+	 * Time files of the same frames at 50k, 100k, and 200k frames, and check
+	 * that each has that many frames.
+	 * 
+	 * @see measureGrowth(const std::string&, const std::string&, TagCheck)
+	 */
+	void measureGrowth(const std::string& directory, const std::string& name) {
+		measureGrowth(directory, name, [](const ID3::Tag& tag, const size_t frames) { return tag.size() == frames; });
+	}
+	
+	/**
+	 * Count the memory allocated to read a typical tag, and check that it's
+	 * no more than ALLOCATION_LIMIT allocations. The tag is read from the
+	 * corpus directory, so a long path doesn't add allocations for the file
+	 * name. Since this changes the working directory, it's run last.
+	 * 
+	 * @param directory The corpus directory.
+	 */
+	void measureAllocations(const std::string& directory) {
+		const std::string file = "typical.mp3";
+		if(chdir(directory.c_str()) != 0) {
+			check(false, "Cannot change to " + directory);
+			return;
+		}
+		try {
+			//Read the tag once first, so memory that's only allocated once isn't counted
+			{ ID3::Tag tag(file); }
+			
+			const unsigned long ALLOCATIONS = allocations, BYTES = allocatedBytes;
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for(unsigned int i = 0; i < ALLOCATION_READS; i++) {
+				ID3::Tag tag(file);
+			}
+			const double READ = elapsed(start) / ALLOCATION_READS;
+			const double PER_READ = static_cast<double>(allocations - ALLOCATIONS) / ALLOCATION_READS;
+			std::cout << std::setw(20) << std::left << "typical.mp3" << std::right << std::fixed << std::setprecision(2)
+			          << " read " << std::setw(9) << READ << " ms"
+			          << "  allocations " << std::setw(6) << PER_READ
+			          << "  bytes " << std::setw(9) << static_cast<double>(allocatedBytes - BYTES) / ALLOCATION_READS << std::endl;
+			check(PER_READ <= ALLOCATION_LIMIT, "typical.mp3 took " + std::to_string(PER_READ) + " allocations to read");
+		} catch(const std::exception& e) {
+			check(false, std::string("typical.mp3 threw ") + e.what());
+		}
+	}
+}
+
+//Count every memory allocation
+void* operator new(const size_t bytes) { return allocate(bytes); }
+void* operator new[](const size_t bytes) { return allocate(bytes); }
+void operator delete(void* const memory) noexcept { free(memory); }
+void operator delete[](void* const memory) noexcept { free(memory); }
+void operator delete(void* const memory, size_t) noexcept { free(memory); }
+void operator delete[](void* const memory, size_t) noexcept { free(memory); }
+
+int main(int argc, char** argv) {
+	if(argc != 2) {
+		std::cerr << "Usage: " << argv[0] << " <corpus directory>" << std::endl;
+		return 2;
+	}
+	const std::string directory = argv[1];
+	
+	measureGrowth(directory, "tiny");
+	measureGrowth(directory, "popm");
+	measureGrowth(directory, "priv");
+	measureGrowth(directory, "unsync");
+	measureGrowth(directory, "utf16");
+	measureGrowth(directory, "unsync-long", [](const ID3::Tag& tag, const size_t frames) {
+		size_t length = 0;
+		tag.visitFrames([&length](const ID3::FrameView& frame) { length = frame.text().size(); return true; });
+		return tag.size() == 1 && length == 2 * 8 * frames;
+	});
+	measureGrowth(directory, "utf16-long", [](const ID3::Tag& tag, const size_t frames) {
+		return tag.title().size() == 2 * 20 * frames;
+	});
+	measure(directory, "pictures-20k.mp3", [](const ID3::Tag& tag, size_t) {
+		check(tag.size() == 20000, "pictures-20k.mp3 doesn't have 20000 frames");
+	}, [](const ID3::WriteResult& result) {
+		check(result.discardedFrames == 10000, "pictures-20k.mp3 didn't discard its 10000 duplicate pictures");
+	});
+	measure(directory, "max-size.mp3", [](const ID3::Tag& tag, size_t) {
+		check(tag.album().empty(), "max-size.mp3 read a frame past the end of the tag");
+	});
+	measure(directory, "overrun.mp3", [](const ID3::Tag& tag, size_t) {
+		check(tag.title() == "t", "overrun.mp3 doesn't have its title");
+		check(tag.artist().empty(), "overrun.mp3 read a frame past the end of the tag");
+	});
+	checkRejected(directory, "truncated-tag.mp3");
+	measure(directory, "truncated-frame.mp3", [](const ID3::Tag& tag, size_t) {
+		check(tag.title() == "t", "truncated-frame.mp3 doesn't have its title");
+		check(tag.album().empty(), "truncated-frame.mp3 read a frame past the end of the tag");
+	});
+	
+	std::remove((directory + "/scratch.mp3").c_str());
+	measureAllocations(directory);
+	
+	for(const std::string& failure : failures)
+		std::cout << "FAILED: " << failure << std::endl;
+	std::cout << (failures.empty() ? "All checks passed" : std::to_string(failures.size()) + " checks failed") << std::endl;
+	return failures.empty() ? 0 : 1;
+}
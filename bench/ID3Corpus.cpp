@@ -0,0 +1,245 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+/**
+ * ID3Corpus writes MP3 files with tags built to hit the worst cases of the
+ * reader and writer: many tiny frames, frames that declare the largest
+ * sizes they can, long unsynchronisation runs, large sets of POPM, PRIV,
+ * and APIC frames, and truncated tags and frames. It also writes a typical
+ * tag of 12 small frames. ID3Bench reads them.
+ * 
+ * Usage: ID3Corpus <directory>
+ */
+
+#include <fstream>  //For std::ofstream
+#include <iostream> //For std::cout and std::cerr
+#include <string>   //For std::string and std::to_string()
+#include <vector>   //For std::vector
+
+//Private namespace
+namespace {
+	/**
+	 * The audio after each tag: an MPEG frame header and silence.
+	 */
+	const std::string AUDIO = std::string("\xFF\xFB\x90\x00", 4) + std::string(4096, '\0');
+	
+	/**
+	 * @param size The size.
+	 * @return The size as an ID3v2 synchsafe integer.
+	 */
+	std::string synchsafe(const unsigned long size) {
+		std::string bytes(4, '\0');
+		for(unsigned int i = 0; i < 4; i++)
+			bytes[i] = static_cast<char>((size >> (7 * (3 - i))) & 0x7F);
+		return bytes;
+	}
+	
+	/**
+	 * @param id    The frame ID.
+	 * @param body  The frame content.
+	 * @param flags The second frame flag byte.
+	 * @return An ID3v2.4 frame.
+	 */
+	std::string frame(const std::string& id, const std::string& body, const char flags = '\0') {
+		return id + synchsafe(body.size()) + '\0' + flags + body;
+	}
+	
+	/**
+	 * @param frames   The frames.
+	 * @param padding  The padding after the frames.
+	 * @param declared The tag size in the header, or 0 for the actual size.
+	 * @return An ID3v2.4 tag.
+	 */
+	std::string tag(const std::vector<std::string>& frames, const unsigned long padding, const unsigned long declared = 0) {
+		std::string body;
+		for(const std::string& currentFrame : frames) body += currentFrame;
+		body.append(padding, '\0');
+		return std::string("ID3\x04\x00\x00", 6) + synchsafe(declared > 0 ? declared : body.size()) + body;
+	}
+	
+	/**
+	 * Write a file in the corpus.
+	 * 
+	 * @param directory The corpus directory.
+	 * @param name      The file name.
+	 * @param bytes     The file content.
+	 * @return If the file was written.
+	 */
+	bool writeFile(const std::string& directory, const std::string& name, const std::string& bytes) {
+		std::ofstream file(directory + "/" + name, std::ios::binary | std::ios::trunc);
+		file.write(bytes.data(), bytes.size());
+		if(!file) {
+			std::cerr << "Cannot write " << directory << "/" << name << std::endl;
+			return false;
+		}
+		std::cout << name << ": " << bytes.size() << " bytes" << std::endl;
+		return true;
+	}
+	
+	/**
+	 * @param frames The number of frames.
+	 * @return A tag of Popularimeter frames with different email addresses.
+	 */
+	std::string popularimeters(const unsigned long frames) {
+		std::vector<std::string> tagFrames;
+		tagFrames.reserve(frames);
+		for(unsigned long i = 0; i < frames; i++)
+			tagFrames.push_back(frame("POPM", "e" + std::to_string(i) + std::string("\0\x80\0", 3)));
+		return tag(tagFrames, 16) + AUDIO;
+	}
+	
+	/**
+	 * @param frames The number of frames.
+	 * @return A tag of private frames with different owners.
+	 */
+	std::string privateFrames(const unsigned long frames) {
+		std::vector<std::string> tagFrames;
+		tagFrames.reserve(frames);
+		for(unsigned long i = 0; i < frames; i++)
+			tagFrames.push_back(frame("PRIV", "o" + std::to_string(i) + std::string("\0x", 2)));
+		return tag(tagFrames, 16) + AUDIO;
+	}
+	
+	/**
+	 * @param frames The number of frames.
+	 * @return A tag of tiny user-defined text frames with different
+	 *         descriptions.
+	 */
+	std::string tinyFrames(const unsigned long frames) {
+		std::vector<std::string> tagFrames;
+		tagFrames.reserve(frames);
+		for(unsigned long i = 0; i < frames; i++)
+			tagFrames.push_back(frame("TXXX", "\x03" + std::to_string(i) + std::string("\0a", 2)));
+		return tag(tagFrames, 16) + AUDIO;
+	}
+	
+	/**
+	 * @param pairs The number of 0xFF 0x00 pairs.
+	 * @return The pairs, which unsynchronisation turns into 0xFF bytes.
+	 */
+	std::string unsynchronisedPairs(const unsigned long pairs) {
+		std::string bytes;
+		bytes.reserve(2 * pairs);
+		for(unsigned long i = 0; i < pairs; i++) bytes.append("\xFF\0", 2);
+		return bytes;
+	}
+	
+	/**
+	 * @param frames The number of frames.
+	 * @return A tag of unsynchronised comments with different descriptions,
+	 *         each of 16 0xFF 0x00 pairs.
+	 */
+	std::string unsynchronisedFrames(const unsigned long frames) {
+		const std::string PAIRS = unsynchronisedPairs(16);
+		std::vector<std::string> tagFrames;
+		tagFrames.reserve(frames);
+		for(unsigned long i = 0; i < frames; i++)
+			tagFrames.push_back(frame("COMM", std::string("\0eng", 4) + std::to_string(i) + '\0' + PAIRS, '\x02'));
+		return tag(tagFrames, 16) + AUDIO;
+	}
+	
+	/**
+	 * @param characters The number of characters.
+	 * @return UTF-16 text with a byte order mark, and a text encoding byte
+	 *         before it.
+	 */
+	std::string utf16Text(const unsigned long characters) {
+		std::string text("\x01\xFF\xFE", 3);
+		text.reserve(3 + 2 * characters);
+		for(unsigned long i = 0; i < characters; i++) text.append("\xE9\0", 2);
+		return text;
+	}
+	
+	/**
+	 * @param frames The number of frames.
+	 * @return A tag of user-defined text frames with different descriptions,
+	 *         each of 16 characters of UTF-16 text.
+	 */
+	std::string utf16Frames(const unsigned long frames) {
+		const std::string TEXT = utf16Text(16).substr(1);
+		std::vector<std::string> tagFrames;
+		tagFrames.reserve(frames);
+		for(unsigned long i = 0; i < frames; i++) {
+			std::string description("\x01\xFF\xFE", 3);
+			for(const char digit : std::to_string(i)) description.append(1, digit).append(1, '\0');
+			tagFrames.push_back(frame("TXXX", description + std::string(2, '\0') + TEXT));
+		}
+		return tag(tagFrames, 16) + AUDIO;
+	}
+}
+
+int main(int argc, char** argv) {
+	if(argc != 2) {
+		std::cerr << "Usage: " << argv[0] << " <directory>" << std::endl;
+		return 2;
+	}
+	const std::string directory = argv[1];
+	bool written = true;
+	
+	//A typical tag, for counting the memory allocated when reading a tag
+	const std::vector<std::string> typical = {
+		frame("TIT2", std::string("\0Some Song Title", 16)), frame("TPE1", std::string("\0An Artist", 10)),
+		frame("TALB", std::string("\0The Album Name", 15)),  frame("TRCK", std::string("\0" "3/12", 5)),
+		frame("TPOS", std::string("\0" "1/1", 4)),           frame("TCON", std::string("\0Rock", 5)),
+		frame("TDRC", std::string("\0" "2016", 5)),          frame("TPE2", std::string("\0An Artist", 10)),
+		frame("TCOM", std::string("\0A Composer", 11)),      frame("TLEN", std::string("\0" "215000", 7)),
+		frame("COMM", std::string("\0eng\0A short comment", 20)), frame("TSSE", std::string("\0LAME 3.99", 10))
+	};
+	written &= writeFile(directory, "typical.mp3", tag(typical, 326) + AUDIO);
+	
+	//Tags of 50k, 100k, and 200k frames, for checking that reading and writing
+	//them grows linearly: tiny text frames, Popularimeter and private frames,
+	//unsynchronised frames, and UTF-16 text frames. Tags of one long
+	//unsynchronised or UTF-16 frame grow with them, by 8 0xFF 0x00 pairs or
+	//20 characters for each frame of the other tags.
+	for(const unsigned long frames : {50000UL, 100000UL, 200000UL}) {
+		const std::string SUFFIX = std::to_string(frames / 1000) + "k.mp3";
+		written &= writeFile(directory, "tiny-" + SUFFIX, tinyFrames(frames));
+		written &= writeFile(directory, "popm-" + SUFFIX, popularimeters(frames));
+		written &= writeFile(directory, "priv-" + SUFFIX, privateFrames(frames));
+		written &= writeFile(directory, "unsync-" + SUFFIX, unsynchronisedFrames(frames));
+		written &= writeFile(directory, "utf16-" + SUFFIX, utf16Frames(frames));
+		written &= writeFile(directory, "unsync-long-" + SUFFIX,
+		                     tag({frame("TXXX", std::string("\0d\0", 3) + unsynchronisedPairs(8 * frames), '\x02')}, 16) + AUDIO);
+		written &= writeFile(directory, "utf16-long-" + SUFFIX, tag({frame("TIT2", utf16Text(20 * frames))}, 16) + AUDIO);
+	}
+	
+	//20,000 pictures of the same size, every other one with the same data as
+	//the one before it
+	std::vector<std::string> pictures;
+	for(unsigned long i = 0; i < 20000; i++) {
+		std::string data = std::string("\x89PNG", 4) + std::string(1000, '\0') + synchsafe(i / 2);
+		pictures.push_back(frame("APIC", std::string("\0image/png\0\x03", 12) + "d" + std::to_string(i) + '\0' + data));
+	}
+	written &= writeFile(directory, "pictures-20k.mp3", tag(pictures, 16) + AUDIO);
+	
+	//Frames that declare the largest sizes they can: one filling the tag, one
+	//claiming more than is left in the tag, and one after the tag claiming
+	//the rest of the file
+	const std::string big = frame("TXXX", std::string("\x03" "d\0", 3) + std::string(1 << 19, 'x'));
+	const std::string past = "TALB" + synchsafe(1 << 19) + std::string("\0\0\x03x", 4);
+	written &= writeFile(directory, "max-size.mp3", tag({big, past}, 16) +
+	                                               "TIT2" + synchsafe(1 << 20) + std::string(2 + (1 << 20), '\0') + AUDIO);
+	
+	//A frame whose size goes past the end of the tag into the audio
+	const std::string artist = "TPE1" + synchsafe(5000) + std::string("\0\0\x03" "artist", 9);
+	written &= writeFile(directory, "overrun.mp3", tag({frame("TIT2", std::string("\x03t", 2)), artist}, 64) +
+	                                              std::string(8192, '\x55') + AUDIO);
+	
+	//A tag declaring more bytes than the file has, and a tag that fits in the
+	//file but ends, along with the file, in the middle of a frame
+	written &= writeFile(directory, "truncated-tag.mp3", tag({frame("TIT2", std::string("\x03t", 2))}, 0, 1 << 24));
+	const std::string album = frame("TALB", "\x03" + std::string(1000, 'a')).substr(0, 110);
+	written &= writeFile(directory, "truncated-frame.mp3", tag({frame("TIT2", std::string("\x03t", 2)), album}, 0));
+	
+	return written ? 0 : 1;
+}